@@ -189,6 +189,7 @@ void DialogDrivers::accept() // this catches OK and return/enter
     m_outputDriver->setMinValue(ui->lineEditMinimum->value());
     m_outputDriver->setMaxValue(ui->lineEditMaximum->value());
     m_outputDriver->setInterp(ui->checkBoxInterpolate->isChecked());
+    if (m_inputDriver) m_outputDriver->setControlPeriod(m_inputDriver->controlPeriod());
     for (int i = 0; i < m_targetComboBoxList.size(); i++)
     {
         std::string name = m_targetComboBoxList[i]->currentText().toStdString();
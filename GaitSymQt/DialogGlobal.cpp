@@ -113,6 +113,15 @@ void DialogGlobal::accept() // this catches OK and return/enter
     {
         m_outputGlobal->setColour1(m_inputGlobal->colour1());
         m_outputGlobal->setSize1(m_inputGlobal->size1());
+        m_outputGlobal->setControlPeriod(m_inputGlobal->ControlPeriod());
+        m_outputGlobal->setDumpInterval(m_inputGlobal->DumpInterval());
+        m_outputGlobal->setDumpTimeInterval(m_inputGlobal->DumpTimeInterval());
+        m_outputGlobal->setDumpStartTime(m_inputGlobal->DumpStartTime());
+        m_outputGlobal->setDumpEndTime(m_inputGlobal->DumpEndTime());
+        m_outputGlobal->setDumpQuantisation(m_inputGlobal->DumpQuantisation());
+        m_outputGlobal->setDumpTriggers(m_inputGlobal->DumpTriggers());
+        m_outputGlobal->setDumpPreTriggerTime(m_inputGlobal->DumpPreTriggerTime());
+        m_outputGlobal->setDumpPostTriggerTime(m_inputGlobal->DumpPostTriggerTime());
     }
     else
     {
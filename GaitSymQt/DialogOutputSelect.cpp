@@ -21,6 +21,7 @@
 #include "Reporter.h"
 #include "Controller.h"
 #include "Warehouse.h"
+#include "Global.h"
 #include "MainWindow.h"
 #include "Preferences.h"
 
@@ -29,6 +30,7 @@
 #include <QLabel>
 #include <QGridLayout>
 #include <QDialogButtonBox>
+#include <QInputDialog>
 #include <QDebug>
 
 DialogOutputSelect::DialogOutputSelect(QWidget *parent) :
@@ -274,6 +276,13 @@ DialogOutputSelect::DialogOutputSelect(QWidget *parent) :
         QObject::connect(m_listWidgetWarehouse, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(menuRequestWarehouse(QPoint)));
     }
 
+    m_ui->spinBoxDumpInterval->setValue(simulation->GetGlobal()->DumpInterval());
+    m_ui->lineEditDumpTimeInterval->setBottom(0);
+    m_ui->lineEditDumpTimeInterval->setValue(simulation->GetGlobal()->DumpTimeInterval());
+    m_ui->lineEditDumpStartTime->setBottom(0);
+    m_ui->lineEditDumpStartTime->setValue(simulation->GetGlobal()->DumpStartTime());
+    m_ui->lineEditDumpEndTime->setValue(simulation->GetGlobal()->DumpEndTime());
+
     connect(m_ui->pushButtonOK, SIGNAL(clicked()), this, SLOT(acceptButtonClicked()));
     connect(m_ui->pushButtonCancel, SIGNAL(clicked()), this, SLOT(rejectButtonClicked()));
 
@@ -303,10 +312,20 @@ void DialogOutputSelect::menuRequestMuscle(QPoint p)
     QMenu menu(this);
     menu.addAction(tr("All On"));
     menu.addAction(tr("All Off"));
+    if (hasDumpChannels(m_listWidgetMuscle, p))
+    {
+        menu.addSeparator();
+        menu.addAction(tr("Channels..."));
+    }
 
     QPoint gp = m_listWidgetMuscle->mapToGlobal(p);
 
     QAction *action = menu.exec(gp);
+    if (action && action->text() == tr("Channels..."))
+    {
+        editDumpChannels(m_listWidgetMuscle, p);
+        return;
+    }
     QListWidgetItem *item;
     Qt::CheckState state;
     int i;
@@ -336,10 +355,20 @@ void DialogOutputSelect::menuRequestBody(QPoint p)
     QMenu menu(this);
     menu.addAction(tr("All On"));
     menu.addAction(tr("All Off"));
+    if (hasDumpChannels(m_listWidgetBody, p))
+    {
+        menu.addSeparator();
+        menu.addAction(tr("Channels..."));
+    }
 
     QPoint gp = m_listWidgetBody->mapToGlobal(p);
 
     QAction *action = menu.exec(gp);
+    if (action && action->text() == tr("Channels..."))
+    {
+        editDumpChannels(m_listWidgetBody, p);
+        return;
+    }
     QListWidgetItem *item;
     Qt::CheckState state;
     int i;
@@ -369,10 +398,20 @@ void DialogOutputSelect::menuRequestJoint(QPoint p)
     QMenu menu(this);
     menu.addAction(tr("All On"));
     menu.addAction(tr("All Off"));
+    if (hasDumpChannels(m_listWidgetJoint, p))
+    {
+        menu.addSeparator();
+        menu.addAction(tr("Channels..."));
+    }
 
     QPoint gp = m_listWidgetJoint->mapToGlobal(p);
 
     QAction *action = menu.exec(gp);
+    if (action && action->text() == tr("Channels..."))
+    {
+        editDumpChannels(m_listWidgetJoint, p);
+        return;
+    }
     QListWidgetItem *item;
     Qt::CheckState state;
     int i;
@@ -402,10 +441,20 @@ void DialogOutputSelect::menuRequestMarker(QPoint p)
     QMenu menu(this);
     menu.addAction(tr("All On"));
     menu.addAction(tr("All Off"));
+    if (hasDumpChannels(m_listWidgetMarker, p))
+    {
+        menu.addSeparator();
+        menu.addAction(tr("Channels..."));
+    }
 
     QPoint gp = m_listWidgetMarker->mapToGlobal(p);
 
     QAction *action = menu.exec(gp);
+    if (action && action->text() == tr("Channels..."))
+    {
+        editDumpChannels(m_listWidgetMarker, p);
+        return;
+    }
     QListWidgetItem *item;
     Qt::CheckState state;
     int i;
@@ -435,10 +484,20 @@ void DialogOutputSelect::menuRequestGeom(QPoint p)
     QMenu menu(this);
     menu.addAction(tr("All On"));
     menu.addAction(tr("All Off"));
+    if (hasDumpChannels(m_listWidgetGeom, p))
+    {
+        menu.addSeparator();
+        menu.addAction(tr("Channels..."));
+    }
 
     QPoint gp = m_listWidgetGeom->mapToGlobal(p);
 
     QAction *action = menu.exec(gp);
+    if (action && action->text() == tr("Channels..."))
+    {
+        editDumpChannels(m_listWidgetGeom, p);
+        return;
+    }
     QListWidgetItem *item;
     Qt::CheckState state;
     int i;
@@ -468,10 +527,20 @@ void DialogOutputSelect::menuRequestDriver(QPoint p)
     QMenu menu(this);
     menu.addAction(tr("All On"));
     menu.addAction(tr("All Off"));
+    if (hasDumpChannels(m_listWidgetDriver, p))
+    {
+        menu.addSeparator();
+        menu.addAction(tr("Channels..."));
+    }
 
     QPoint gp = m_listWidgetDriver->mapToGlobal(p);
 
     QAction *action = menu.exec(gp);
+    if (action && action->text() == tr("Channels..."))
+    {
+        editDumpChannels(m_listWidgetDriver, p);
+        return;
+    }
     QListWidgetItem *item;
     Qt::CheckState state;
     int i;
@@ -501,10 +570,20 @@ void DialogOutputSelect::menuRequestDataTarget(QPoint p)
     QMenu menu(this);
     menu.addAction(tr("All On"));
     menu.addAction(tr("All Off"));
+    if (hasDumpChannels(m_listWidgetDataTarget, p))
+    {
+        menu.addSeparator();
+        menu.addAction(tr("Channels..."));
+    }
 
     QPoint gp = m_listWidgetDataTarget->mapToGlobal(p);
 
     QAction *action = menu.exec(gp);
+    if (action && action->text() == tr("Channels..."))
+    {
+        editDumpChannels(m_listWidgetDataTarget, p);
+        return;
+    }
     QListWidgetItem *item;
     Qt::CheckState state;
     int i;
@@ -534,10 +613,20 @@ void DialogOutputSelect::menuRequestReporter(QPoint p)
     QMenu menu(this);
     menu.addAction(tr("All On"));
     menu.addAction(tr("All Off"));
+    if (hasDumpChannels(m_listWidgetReporter, p))
+    {
+        menu.addSeparator();
+        menu.addAction(tr("Channels..."));
+    }
 
     QPoint gp = m_listWidgetReporter->mapToGlobal(p);
 
     QAction *action = menu.exec(gp);
+    if (action && action->text() == tr("Channels..."))
+    {
+        editDumpChannels(m_listWidgetReporter, p);
+        return;
+    }
     QListWidgetItem *item;
     Qt::CheckState state;
     int i;
@@ -567,10 +656,20 @@ void DialogOutputSelect::menuRequestController(QPoint p)
     QMenu menu(this);
     menu.addAction(tr("All On"));
     menu.addAction(tr("All Off"));
+    if (hasDumpChannels(m_listWidgetController, p))
+    {
+        menu.addSeparator();
+        menu.addAction(tr("Channels..."));
+    }
 
     QPoint gp = m_listWidgetController->mapToGlobal(p);
 
     QAction *action = menu.exec(gp);
+    if (action && action->text() == tr("Channels..."))
+    {
+        editDumpChannels(m_listWidgetController, p);
+        return;
+    }
     QListWidgetItem *item;
     Qt::CheckState state;
     int i;
@@ -600,10 +699,20 @@ void DialogOutputSelect::menuRequestWarehouse(QPoint p)
     QMenu menu(this);
     menu.addAction(tr("All On"));
     menu.addAction(tr("All Off"));
+    if (hasDumpChannels(m_listWidgetWarehouse, p))
+    {
+        menu.addSeparator();
+        menu.addAction(tr("Channels..."));
+    }
 
     QPoint gp = m_listWidgetWarehouse->mapToGlobal(p);
 
     QAction *action = menu.exec(gp);
+    if (action && action->text() == tr("Channels..."))
+    {
+        editDumpChannels(m_listWidgetWarehouse, p);
+        return;
+    }
     QListWidgetItem *item;
     Qt::CheckState state;
     int i;
@@ -709,10 +818,53 @@ void DialogOutputSelect::acceptButtonClicked()
         (*m_simulation->GetWarehouseList())[std::string(item->text().toUtf8())]->setDump(dump);
     }
 
+    for (auto &&it : m_dumpChannelsMap)
+    {
+        NamedObject *namedObject = m_simulation->GetNamedObject(it.first);
+        if (namedObject) namedObject->setDumpChannels(it.second);
+    }
+
+    m_simulation->GetGlobal()->setDumpInterval(m_ui->spinBoxDumpInterval->value());
+    m_simulation->GetGlobal()->setDumpTimeInterval(m_ui->lineEditDumpTimeInterval->value());
+    m_simulation->GetGlobal()->setDumpStartTime(m_ui->lineEditDumpStartTime->value());
+    m_simulation->GetGlobal()->setDumpEndTime(m_ui->lineEditDumpEndTime->value());
+
     Preferences::insert("DialogOutputSelectGeometry", saveGeometry());
     accept();
 }
 
+// the channel subset is entered as a space separated list and an empty list means all channels
+bool DialogOutputSelect::hasDumpChannels(QListWidget *listWidget, QPoint p)
+{
+    QListWidgetItem *item = listWidget->itemAt(p);
+    if (!item) return false;
+    NamedObject *namedObject = m_simulation->GetNamedObject(std::string(item->text().toUtf8()));
+    return namedObject && namedObject->dumpNames().size();
+}
+
+void DialogOutputSelect::editDumpChannels(QListWidget *listWidget, QPoint p)
+{
+    QListWidgetItem *item = listWidget->itemAt(p);
+    if (!item) return;
+    std::string name = std::string(item->text().toUtf8());
+    NamedObject *namedObject = m_simulation->GetNamedObject(name);
+    if (!namedObject) return;
+    std::vector<std::string> availableChannels = namedObject->dumpNames();
+    if (availableChannels.empty()) return;
+    auto found = m_dumpChannelsMap.find(name);
+    std::vector<std::string> channels = found != m_dumpChannelsMap.end() ? found->second : namedObject->dumpChannels();
+    QStringList available, current;
+    for (auto &&it : availableChannels) available.append(QString::fromStdString(it));
+    for (auto &&it : channels) current.append(QString::fromStdString(it));
+    bool ok;
+    QString text = QInputDialog::getText(this, tr("Channels"), tr("Channels for %1 (empty for all)\nAvailable: %2").arg(item->text()).arg(available.join(" ")),
+                                         QLineEdit::Normal, current.join(" "), &ok);
+    if (!ok) return;
+    channels.clear();
+    for (auto &&it : text.split(" ", Qt::SkipEmptyParts)) channels.push_back(it.toStdString());
+    m_dumpChannelsMap[name] = channels;
+}
+
 void DialogOutputSelect::rejectButtonClicked()
 {
     qDebug() << "DialogOutputSelect::rejectButtonClicked()";
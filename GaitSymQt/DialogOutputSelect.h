@@ -15,6 +15,10 @@
 #include <QDialog>
 #include <QFont>
 
+#include <map>
+#include <string>
+#include <vector>
+
 class QListWidget;
 class QLabel;
 class QDialogButtonBox;
@@ -88,6 +92,9 @@ protected:
     void closeEvent(QCloseEvent *event) Q_DECL_OVERRIDE;
 
 private:
+    bool hasDumpChannels(QListWidget *listWidget, QPoint p);
+    void editDumpChannels(QListWidget *listWidget, QPoint p);
+
     QListWidget *m_listWidgetBody = nullptr;
     QListWidget *m_listWidgetDataTarget = nullptr;
     QListWidget *m_listWidgetDriver = nullptr;
@@ -105,6 +112,7 @@ private:
     Ui::DialogOutputSelect *m_ui = nullptr;
 
     Simulation *m_simulation = nullptr;
+    std::map<std::string, std::vector<std::string>> m_dumpChannelsMap;
 };
 
 #endif // DIALOGOUTPUTSELECT_H
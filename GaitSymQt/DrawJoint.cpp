@@ -136,6 +136,7 @@ void DrawJoint::initialise(SimulationWidget *simulationWidget)
     if (fixedJoint && fixedJoint->GetStressCalculationType() != FixedJoint::none)
     {
         qDebug() << "Debug DrawJoint::initialise:" << m_joint->name().c_str();
+        fixedJoint->SetStressDisplayed(true);
         m_facetedObject1 = std::make_unique<FacetedRect>(fixedJoint->width(), fixedJoint->height(), m_jointColor, 1);
         m_facetedObject1->setSimulationWidget(simulationWidget);
         m_facetedObject1->Move((fixedJoint->width() / 2) - fixedJoint->xOrigin(), (fixedJoint->height() / 2) - fixedJoint->yOrigin(), 0);
@@ -76,7 +76,7 @@ win32 {
         ../rapidxml-1.13 \
         ../src \
         ../tinyply
-    LIBS += -lGdi32 -lUser32 -lAdvapi32 -lWs2_32 -lWinmm
+    LIBS += -lGdi32 -lUser32 -lAdvapi32 -lWs2_32 -lWinmm -lPsapi
     HEADERS +=
         win32-msvc {
         QMAKE_CXXFLAGS += -bigobj
@@ -277,6 +277,7 @@ SOURCES += \
     ../pystring/pystring.cpp \
     ../src/AMotorJoint.cpp \
     ../src/ArgParse.cpp \
+    ../src/AsyncDumpWriter.cpp \
     ../src/BallJoint.cpp \
     ../src/Body.cpp \
     ../src/BoxGeom.cpp \
@@ -297,6 +298,9 @@ SOURCES += \
     ../src/DataTargetVector.cpp \
     ../src/Drivable.cpp \
     ../src/Driver.cpp \
+    ../src/DumpCodec.cpp \
+    ../src/DumpFile.cpp \
+    ../src/DumpHistory.cpp \
     ../src/ErrorHandler.cpp \
     ../src/FEC.cpp \
     ../src/Filter.cpp \
@@ -316,6 +320,8 @@ SOURCES += \
     ../src/MAMuscleComplete.cpp \
     ../src/MD5.cpp \
     ../src/Marker.cpp \
+    ../src/MomentArmSweep.cpp \
+    ../src/ModelStateWriter.cpp \
     ../src/MovingAverage.cpp \
     ../src/Muscle.cpp \
     ../src/NPointStrap.cpp \
@@ -333,6 +339,7 @@ SOURCES += \
     ../src/PlaneGeom.cpp \
     ../src/RayGeom.cpp \
     ../src/Reporter.cpp \
+    ../src/RunSummary.cpp \
     ../src/Simulation.cpp \
     ../src/SliderJoint.cpp \
     ../src/SphereGeom.cpp \
@@ -345,6 +352,7 @@ SOURCES += \
     ../src/ThreadedUDP.cpp \
     ../src/ThreeHingeJointDriver.cpp \
     ../src/TorqueReporter.cpp \
+    ../src/TrajectoryRecorder.cpp \
     ../src/TrimeshGeom.cpp \
     ../src/TwoCylinderWrapStrap.cpp \
     ../src/TwoPointStrap.cpp \
@@ -640,6 +648,7 @@ HEADERS += \
     ../rapidxml-1.13/rapidxml_utils.hpp \
     ../src/AMotorJoint.h \
     ../src/ArgParse.h \
+    ../src/AsyncDumpWriter.h \
     ../src/BallJoint.h \
     ../src/Body.h \
     ../src/BoxGeom.h \
@@ -660,6 +669,9 @@ HEADERS += \
     ../src/DataTargetVector.h \
     ../src/Drivable.h \
     ../src/Driver.h \
+    ../src/DumpCodec.h \
+    ../src/DumpFile.h \
+    ../src/DumpHistory.h \
     ../src/ErrorHandler.h \
     ../src/FEC.h \
     ../src/Filter.h \
@@ -680,6 +692,8 @@ HEADERS += \
     ../src/MD5.h \
     ../src/MPIStuff.h \
     ../src/Marker.h \
+    ../src/MomentArmSweep.h \
+    ../src/ModelStateWriter.h \
     ../src/MovingAverage.h \
     ../src/Muscle.h \
     ../src/NPointStrap.h \
@@ -699,6 +713,7 @@ HEADERS += \
     ../src/PlaneGeom.h \
     ../src/RayGeom.h \
     ../src/Reporter.h \
+    ../src/RunSummary.h \
     ../src/SimpleStrap.h \
     ../src/Simulation.h \
     ../src/SliderJoint.h \
@@ -714,6 +729,7 @@ HEADERS += \
     ../src/ThreadedUDP.h \
     ../src/ThreeHingeJointDriver.h \
     ../src/TorqueReporter.h \
+    ../src/TrajectoryRecorder.h \
     ../src/TrimeshGeom.h \
     ../src/TwoCylinderWrapStrap.h \
     ../src/TwoPointStrap.h \
@@ -75,7 +75,7 @@ win32 {
         ../rapidxml-1.13 \
         ../src \
         ../tinyply
-    LIBS += -lGdi32 -lUser32 -lAdvapi32 -lWs2_32 -lWinmm
+    LIBS += -lGdi32 -lUser32 -lAdvapi32 -lWs2_32 -lWinmm -lPsapi
     HEADERS +=
         win32-msvc {
         QMAKE_CXXFLAGS += -bigobj
@@ -300,6 +300,7 @@ SOURCES += \
     ../pystring/pystring.cpp \
     ../src/AMotorJoint.cpp \
     ../src/ArgParse.cpp \
+    ../src/AsyncDumpWriter.cpp \
     ../src/BallJoint.cpp \
     ../src/Body.cpp \
     ../src/BoxGeom.cpp \
@@ -320,6 +321,9 @@ SOURCES += \
     ../src/DataTargetVector.cpp \
     ../src/Drivable.cpp \
     ../src/Driver.cpp \
+    ../src/DumpCodec.cpp \
+    ../src/DumpFile.cpp \
+    ../src/DumpHistory.cpp \
     ../src/ErrorHandler.cpp \
     ../src/Filter.cpp \
     ../src/FixedDriver.cpp \
@@ -340,6 +344,8 @@ SOURCES += \
     ../src/Marker.cpp \
     ../src/MarkerEllipseDriver.cpp \
     ../src/MarkerPositionDriver.cpp \
+    ../src/MomentArmSweep.cpp \
+    ../src/ModelStateWriter.cpp \
     ../src/MovingAverage.cpp \
     ../src/Muscle.cpp \
     ../src/NPointStrap.cpp \
@@ -352,6 +358,7 @@ SOURCES += \
     ../src/PlaneGeom.cpp \
     ../src/RayGeom.cpp \
     ../src/Reporter.cpp \
+    ../src/RunSummary.cpp \
     ../src/Simulation.cpp \
     ../src/SliderJoint.cpp \
     ../src/SphereGeom.cpp \
@@ -363,6 +370,7 @@ SOURCES += \
     ../src/ThreeHingeJointDriver.cpp \
     ../src/TwoHingeJointDriver.cpp \
     ../src/TorqueReporter.cpp \
+    ../src/TrajectoryRecorder.cpp \
     ../src/TrimeshGeom.cpp \
     ../src/TwoCylinderWrapStrap.cpp \
     ../src/TwoPointStrap.cpp \
@@ -621,6 +629,7 @@ HEADERS += \
     ../rapidxml-1.13/rapidxml_utils.hpp \
     ../src/AMotorJoint.h \
     ../src/ArgParse.h \
+    ../src/AsyncDumpWriter.h \
     ../src/BallJoint.h \
     ../src/Body.h \
     ../src/BoxGeom.h \
@@ -641,6 +650,9 @@ HEADERS += \
     ../src/DataTargetVector.h \
     ../src/Drivable.h \
     ../src/Driver.h \
+    ../src/DumpCodec.h \
+    ../src/DumpFile.h \
+    ../src/DumpHistory.h \
     ../src/ErrorHandler.h \
     ../src/Filter.h \
     ../src/FixedDriver.h \
@@ -662,6 +674,8 @@ HEADERS += \
     ../src/Marker.h \
     ../src/MarkerEllipseDriver.h \
     ../src/MarkerPositionDriver.h \
+    ../src/MomentArmSweep.h \
+    ../src/ModelStateWriter.h \
     ../src/MovingAverage.h \
     ../src/Muscle.h \
     ../src/NPointStrap.h \
@@ -675,6 +689,7 @@ HEADERS += \
     ../src/PlaneGeom.h \
     ../src/RayGeom.h \
     ../src/Reporter.h \
+    ../src/RunSummary.h \
     ../src/SimpleStrap.h \
     ../src/Simulation.h \
     ../src/SliderJoint.h \
@@ -688,6 +703,7 @@ HEADERS += \
     ../src/ThreeHingeJointDriver.h \
     ../src/TwoHingeJointDriver.h \
     ../src/TorqueReporter.h \
+    ../src/TrajectoryRecorder.h \
     ../src/TrimeshGeom.h \
     ../src/TwoCylinderWrapStrap.h \
     ../src/TwoPointStrap.h \
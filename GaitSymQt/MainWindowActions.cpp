@@ -45,6 +45,7 @@
 #include "TwoHingeJointDriver.h"
 #include "MarkerPositionDriver.h"
 #include "MarkerEllipseDriver.h"
+#include "TrajectoryRecorder.h"
 
 #ifdef USE_QT3D
 #include "SimulationWindowQt3D.h"
@@ -63,6 +64,8 @@
 #include <QMenu>
 #include <QAction>
 
+#include <algorithm>
+
 using namespace std::literals::string_literals;
 
 MainWindowActions::MainWindowActions(QObject *parent) : QObject(parent)
@@ -153,6 +156,7 @@ void MainWindowActions::menuOpen(const QString &fileName, const QByteArray *file
         return;
     }
     m_mainWindow->ui->treeWidgetElements->fillVisibitilityLists(m_mainWindow->m_simulation);
+    updateTrajectoryRecorder();
 
     // check we can find the meshes
     QStringList searchPath;
@@ -535,6 +539,7 @@ void MainWindowActions::menuOutputs()
     if (status == QDialog::Accepted)
     {
         m_mainWindow->ui->treeWidgetElements->fillVisibitilityLists(m_mainWindow->m_simulation);
+        updateTrajectoryRecorder();
         m_mainWindow->setStatusString(tr("Outputs set"), 1);
     }
     else
@@ -1766,6 +1771,27 @@ void MainWindowActions::elementInfo(const QString &elementType, const QString &e
         for (auto &&it : muscle->GetStrap()->attributeMap()) lines.push_back("    "s + it.first + "=\"" + it.second + "\"");
         lines.push_back("/>"s);
     }
+    // add a summary of the values recorded so far for this element
+    TrajectoryRecorder *trajectoryRecorder = m_mainWindow->m_simulation->GetTrajectoryRecorder();
+    std::string prefix = element->name() + "."s;
+    size_t numRecords = trajectoryRecorder->GetNumRecords();
+    bool recorded = false;
+    for (size_t i = 0; numRecords && i < trajectoryRecorder->GetNumChannels(); i++)
+    {
+        const std::string &channelName = trajectoryRecorder->GetChannelNames().at(i);
+        if (!pystring::startswith(channelName, prefix)) continue;
+        if (!recorded)
+        {
+            recorded = true;
+            lines.push_back("<!--"s);
+            lines.push_back(QString("Recorded %1 values from %2 s to %3 s").arg(numRecords).arg(trajectoryRecorder->GetTime().front()).arg(trajectoryRecorder->GetTime().back()).toStdString());
+            lines.push_back("Channel\tLast\tMinimum\tMaximum"s);
+        }
+        const std::vector<double> &channel = trajectoryRecorder->GetChannel(i);
+        auto minMax = std::minmax_element(channel.begin(), channel.end());
+        lines.push_back(QString("%1\t%2\t%3\t%4").arg(QString::fromStdString(channelName.substr(prefix.size()))).arg(channel.back()).arg(*minMax.first).arg(*minMax.second).toStdString());
+    }
+    if (recorded) lines.push_back("-->"s);
     std::string text = pystring::join("\n"s, lines);
     dialog->setEditorText(QString::fromStdString(text));
     dialog->setWindowTitle(QString("%1 ID=\"%2\" Information").arg(elementType, elementName));
@@ -1773,6 +1799,18 @@ void MainWindowActions::elementInfo(const QString &elementType, const QString &e
     dialog->show();
 }
 
+// the objects selected for output are also kept in memory so that their values can be shown while the simulation runs
+void MainWindowActions::updateTrajectoryRecorder()
+{
+    TrajectoryRecorder *trajectoryRecorder = m_mainWindow->m_simulation->GetTrajectoryRecorder();
+    trajectoryRecorder->Clear();
+    for (auto &&it : m_mainWindow->m_simulation->GetObjectList())
+    {
+        // objects without numeric values are still written to the dump files so errors are ignored
+        if (it->dump()) trajectoryRecorder->AddObject(it);
+    }
+}
+
 void MainWindowActions::elementHide(const QString &elementType, const QString &elementName)
 {
     m_mainWindow->ui->treeWidgetElements->setVisibleSwitch(elementType.toUpper(), elementName, false);
@@ -108,6 +108,7 @@ private:
     MainWindow *m_mainWindow = nullptr;
 
     void updateRecentFiles(const QString &recentFile);
+    void updateTrajectoryRecorder();
     QStringList m_recentFileList;
     int m_maxRecentFiles = 20;
 };
@@ -13,7 +13,11 @@
 #include "Body.h"
 #include "Geom.h"
 #include "ArgParse.h"
+#include "TrajectoryRecorder.h"
 
+#include "pystring.h"
+
+#include "pybind11/numpy.h"
 #include "pybind11/stl.h"
 #include "pybind11/pybind11.h"
 
@@ -29,7 +33,22 @@ void initGaitsym2019(pybind11::module &m)
         .def("Run", &GaitSym2019PythonLibrary::Run)
         .def("ReadModel", &GaitSym2019PythonLibrary::ReadModel)
         .def("SetXML", &GaitSym2019PythonLibrary::SetXML)
-        .def("GetFitness", &GaitSym2019PythonLibrary::GetFitness);
+        .def("GetFitness", &GaitSym2019PythonLibrary::GetFitness)
+        .def("SetTrajectoryRecording", &GaitSym2019PythonLibrary::SetTrajectoryRecording)
+        .def("GetTrajectoryChannelNames", &GaitSym2019PythonLibrary::GetTrajectoryChannelNames)
+        // the recorded columns are copied straight into numpy arrays
+        .def("GetTrajectoryTime", [](GaitSym2019PythonLibrary &self)
+        {
+            const std::vector<double> *column = self.GetTrajectoryTime();
+            if (!column) return pybind11::array_t<double>(0);
+            return pybind11::array_t<double>(pybind11::ssize_t(column->size()), column->data());
+        })
+        .def("GetTrajectoryChannel", [](GaitSym2019PythonLibrary &self, const std::string &channelName)
+        {
+            const std::vector<double> *column = self.GetTrajectoryChannel(channelName);
+            if (!column) throw pybind11::key_error(channelName);
+            return pybind11::array_t<double>(pybind11::ssize_t(column->size()), column->data());
+        });
 }
 
 PYBIND11_MODULE(GaitSym2019, m)
@@ -69,7 +88,9 @@ int GaitSym2019PythonLibrary::SetArguments(const std::vector<std::string> &argum
     m_argparse.AddArgument("-mc"s, "--outputModelStateAtCycle"s, "Output model state at this cycle"s, ""s, 1, false, ArgParse::Double);
     m_argparse.AddArgument("-mt"s, "--outputModelStateAtTime"s, "Output model state at this cycle"s, ""s, 1, false, ArgParse::Double);
     m_argparse.AddArgument("-mw"s, "--outputModelStateAtWarehouseDistance"s, "Output model state at this warehouse distance"s, ""s, 1, false, ArgParse::Double);
+    m_argparse.AddArgument("-me"s, "--outputModelStateEvery"s, "Output numbered model states at this simulation time interval"s, ""s, 1, false, ArgParse::Double);
     m_argparse.AddArgument("-wd"s, "--warehouseFailDistanceAbort"s, "Abort the simulation when the warehouse distance fails"s);
+    m_argparse.AddArgument("-ln"s, "--lean"s, "Free the construction only data after loading to reduce memory use"s);
     m_argparse.AddArgument("-de"s, "--debug"s, "Turn debugging on"s);
 
     m_argparse.AddArgument("-ol"s, "--outputList"s, "List of objects to produce output"s, ""s, 1, MAX_ARGS, false, ArgParse::String);
@@ -86,6 +107,7 @@ int GaitSym2019PythonLibrary::SetArguments(const std::vector<std::string> &argum
     m_argparse.Get("--outputModelStateAtTime"s, &m_outputModelStateAtTime);
     m_argparse.Get("--outputModelStateAtCycle"s, &m_outputModelStateAtCycle);
     m_argparse.Get("--outputModelStateAtWarehouseDistance"s, &m_outputModelStateAtWarehouseDistance);
+    m_argparse.Get("--outputModelStateEvery"s, &m_outputModelStateEvery);
     m_argparse.Get("--simulationTimeLimit"s, &m_simulationTimeLimit);
     m_argparse.Get("--warehouseFailDistanceAbort"s, &m_warehouseFailDistanceAbort);
     m_argparse.Get("--config"s, &m_configFilename);
@@ -93,6 +115,7 @@ int GaitSym2019PythonLibrary::SetArguments(const std::vector<std::string> &argum
     m_argparse.Get("--modelState"s, &m_outputModelStateFilename);
     m_argparse.Get("--inputWarehouse"s, &m_inputWarehouseFilename);
     m_argparse.Get("--outputWarehouse"s, &m_outputWarehouseFilename);
+    m_argparse.Get("--lean"s, &m_lean);
     m_argparse.Get("--debug"s, &m_debug);
 
     return 0;
@@ -109,6 +132,8 @@ int GaitSym2019PythonLibrary::Run()
     if (m_outputModelStateAtCycle >= 0) m_simulation->SetOutputModelStateAtCycle(m_outputModelStateAtCycle);
     if (m_inputWarehouseFilename.size()) m_simulation->AddWarehouse(m_inputWarehouseFilename);
     if (m_outputModelStateAtWarehouseDistance >= 0) m_simulation->SetOutputModelStateAtWarehouseDistance(m_outputModelStateAtWarehouseDistance);
+    if (m_outputModelStateEvery > 0) m_simulation->SetOutputModelStateEvery(m_outputModelStateEvery);
+    if (m_lean) m_simulation->SetLeanMode(true);
 
     if (m_debug) std::cerr << "Loading model size = " << m_xmlData.size() << "\n";
     if (m_simulation->LoadModel(m_xmlData.data(), m_xmlData.size()))
@@ -134,6 +159,29 @@ int GaitSym2019PythonLibrary::Run()
         if (m_simulation->GetReporterList()->find(m_outputList[i]) != m_simulation->GetReporterList()->end()) (*m_simulation->GetReporterList())[m_outputList[i]]->setDump(true);
     }
 
+    if (m_recordList.size())
+    {
+        TrajectoryRecorder *trajectoryRecorder = m_simulation->GetTrajectoryRecorder();
+        trajectoryRecorder->SetInterval(m_recordInterval);
+        for (auto &&record : m_recordList)
+        {
+            std::vector<std::string> tokens, channels;
+            pystring::partition(record, ":"s, tokens);
+            NamedObject *namedObject = m_simulation->GetNamedObject(tokens[0]);
+            if (!namedObject)
+            {
+                std::cerr << "Error: trajectory recording \"" << record << "\" does not match an ID\n";
+                return __LINE__;
+            }
+            if (tokens[2].size()) pystring::split(tokens[2], channels, ","s);
+            if (trajectoryRecorder->AddObject(namedObject, channels))
+            {
+                std::cerr << "Error: " << trajectoryRecorder->lastError() << "\n";
+                return __LINE__;
+            }
+        }
+    }
+
     double startTime = GSUtil::GetTime();
 
     while(m_runTimeLimit <= 0 || m_simulationTime <= m_runTimeLimit)
@@ -181,3 +229,31 @@ double GaitSym2019PythonLibrary::GetFitness()
     if (m_simulation) score = m_simulation->CalculateInstantaneousFitness();
     return score;
 }
+
+void GaitSym2019PythonLibrary::SetTrajectoryRecording(const std::vector<std::string> &recordList, int interval)
+{
+    if (m_debug) std::cerr << "GaitSym2019PythonLibrary::SetTrajectoryRecording\n";
+    m_recordList = recordList;
+    m_recordInterval = interval;
+}
+
+std::vector<std::string> GaitSym2019PythonLibrary::GetTrajectoryChannelNames()
+{
+    if (!m_simulation || m_recordList.empty()) return std::vector<std::string>();
+    return m_simulation->GetTrajectoryRecorder()->GetChannelNames();
+}
+
+const std::vector<double> *GaitSym2019PythonLibrary::GetTrajectoryTime()
+{
+    if (!m_simulation || m_recordList.empty()) return nullptr;
+    return &m_simulation->GetTrajectoryRecorder()->GetTime();
+}
+
+const std::vector<double> *GaitSym2019PythonLibrary::GetTrajectoryChannel(const std::string &channelName)
+{
+    if (!m_simulation || m_recordList.empty()) return nullptr;
+    TrajectoryRecorder *trajectoryRecorder = m_simulation->GetTrajectoryRecorder();
+    size_t channelIndex = trajectoryRecorder->FindChannel(channelName);
+    if (channelIndex == SIZE_MAX) return nullptr;
+    return &trajectoryRecorder->GetChannel(channelIndex);
+}
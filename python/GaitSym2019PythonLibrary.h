@@ -25,10 +25,19 @@ public:
 
     double GetFitness();
 
+    // in memory recording of channels as "ID" or "ID:Channel1,Channel2,..." (set before Run)
+    void SetTrajectoryRecording(const std::vector<std::string> &recordList, int interval);
+    std::vector<std::string> GetTrajectoryChannelNames();
+    // these return nullptr if there is nothing recorded
+    const std::vector<double> *GetTrajectoryTime();
+    const std::vector<double> *GetTrajectoryChannel(const std::string &channelName);
+
 private:
 
 
     std::vector<std::string> m_outputList;
+    std::vector<std::string> m_recordList;
+    int m_recordInterval = 1;
 
     std::unique_ptr<Simulation> m_simulation;
     double m_runTimeLimit = 0;
@@ -36,8 +45,10 @@ private:
     double m_outputModelStateAtTime = -1;
     double m_outputModelStateAtCycle = -1;
     double m_outputModelStateAtWarehouseDistance = -1;
+    double m_outputModelStateEvery = 0;
     double m_simulationTimeLimit = -1;
     double m_warehouseFailDistanceAbort = 0;
+    bool m_lean = false;
 
     std::string m_configFilename;
     std::string m_outputWarehouseFilename;
@@ -88,7 +88,7 @@ win32 {
         ../src \
         "C:/Program Files/Python310/include" \
         include
-    LIBS += -lGdi32 -lUser32 -lAdvapi32 -lWs2_32 -lWinmm -L"C:/Program Files/Python310/libs"
+    LIBS += -lGdi32 -lUser32 -lAdvapi32 -lWs2_32 -lWinmm -lPsapi -L"C:/Program Files/Python310/libs"
     HEADERS +=
     win32-msvc {
         QMAKE_CXXFLAGS += -bigobj
@@ -284,6 +284,7 @@ SOURCES += \
     ../pystring/pystring.cpp \
     ../src/AMotorJoint.cpp \
     ../src/ArgParse.cpp \
+    ../src/AsyncDumpWriter.cpp \
     ../src/BallJoint.cpp \
     ../src/Body.cpp \
     ../src/BoxGeom.cpp \
@@ -304,6 +305,9 @@ SOURCES += \
     ../src/DataTargetVector.cpp \
     ../src/Drivable.cpp \
     ../src/Driver.cpp \
+    ../src/DumpCodec.cpp \
+    ../src/DumpFile.cpp \
+    ../src/DumpHistory.cpp \
     ../src/ErrorHandler.cpp \
     ../src/Filter.cpp \
     ../src/FixedDriver.cpp \
@@ -324,6 +328,7 @@ SOURCES += \
     ../src/Marker.cpp \
     ../src/MarkerEllipseDriver.cpp \
     ../src/MarkerPositionDriver.cpp \
+    ../src/ModelStateWriter.cpp \
     ../src/MovingAverage.cpp \
     ../src/Muscle.cpp \
     ../src/NPointStrap.cpp \
@@ -346,6 +351,7 @@ SOURCES += \
     ../src/ThreeHingeJointDriver.cpp \
     ../src/TwoHingeJointDriver.cpp \
     ../src/TorqueReporter.cpp \
+    ../src/TrajectoryRecorder.cpp \
     ../src/TrimeshGeom.cpp \
     ../src/TwoCylinderWrapStrap.cpp \
     ../src/TwoPointStrap.cpp \
@@ -526,6 +532,7 @@ HEADERS += \
     ../rapidxml-1.13/rapidxml_utils.hpp \
     ../src/AMotorJoint.h \
     ../src/ArgParse.h \
+    ../src/AsyncDumpWriter.h \
     ../src/BallJoint.h \
     ../src/Body.h \
     ../src/BoxGeom.h \
@@ -546,6 +553,9 @@ HEADERS += \
     ../src/DataTargetVector.h \
     ../src/Drivable.h \
     ../src/Driver.h \
+    ../src/DumpCodec.h \
+    ../src/DumpFile.h \
+    ../src/DumpHistory.h \
     ../src/ErrorHandler.h \
     ../src/Filter.h \
     ../src/FixedDriver.h \
@@ -567,6 +577,7 @@ HEADERS += \
     ../src/Marker.h \
     ../src/MarkerEllipseDriver.h \
     ../src/MarkerPositionDriver.h \
+    ../src/ModelStateWriter.h \
     ../src/MovingAverage.h \
     ../src/Muscle.h \
     ../src/NPointStrap.h \
@@ -593,6 +604,7 @@ HEADERS += \
     ../src/ThreeHingeJointDriver.h \
     ../src/TwoHingeJointDriver.h \
     ../src/TorqueReporter.h \
+    ../src/TrajectoryRecorder.h \
     ../src/TrimeshGeom.h \
     ../src/TwoCylinderWrapStrap.h \
     ../src/TwoPointStrap.h \
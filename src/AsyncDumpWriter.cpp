@@ -0,0 +1,194 @@
+/*
+ *  AsyncDumpWriter.cpp
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+#include "AsyncDumpWriter.h"
+
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+
+// each record starts with a header slot holding the sink index, a text flag and the
+// number of values (or bytes for text) packed into the bits of a double
+static const uint64_t c_textFlag = uint64_t(1) << 32;
+static const uint64_t c_countMask = c_textFlag - 1;
+
+static double PackHeader(uint64_t header)
+{
+    double value;
+    std::memcpy(&value, &header, sizeof(value));
+    return value;
+}
+
+static uint64_t UnpackHeader(double value)
+{
+    uint64_t header;
+    std::memcpy(&header, &value, sizeof(header));
+    return header;
+}
+
+static size_t RecordSlots(uint64_t header)
+{
+    size_t count = size_t(header & c_countMask);
+    if (header & c_textFlag) return 1 + (count + sizeof(double) - 1) / sizeof(double);
+    return 1 + count;
+}
+
+AsyncDumpWriter::AsyncDumpWriter()
+{
+}
+
+AsyncDumpWriter::~AsyncDumpWriter()
+{
+    Stop();
+}
+
+size_t AsyncDumpWriter::AddValueSink(ValueSink sink)
+{
+    m_valueSinkList.push_back(sink);
+    m_textSinkList.push_back(nullptr);
+    return m_valueSinkList.size() - 1;
+}
+
+size_t AsyncDumpWriter::AddTextSink(TextSink sink)
+{
+    m_valueSinkList.push_back(nullptr);
+    m_textSinkList.push_back(sink);
+    return m_textSinkList.size() - 1;
+}
+
+void AsyncDumpWriter::Start(size_t capacity)
+{
+    if (m_thread.joinable()) return;
+    // the capacity is rounded up to a power of two so the ring index is just a mask
+    size_t size = 64;
+    while (size < capacity) size *= 2;
+    m_ring.assign(size, 0);
+    m_mask = size - 1;
+    m_head.store(0);
+    m_tail.store(0);
+    m_stop.store(false);
+    m_thread = std::thread(&AsyncDumpWriter::WriterThread, this);
+}
+
+void AsyncDumpWriter::Stop()
+{
+    if (!m_thread.joinable()) return;
+    m_stop.store(true, std::memory_order_release);
+    m_wakeCondition.notify_all();
+    m_thread.join();
+}
+
+void AsyncDumpWriter::PushValues(size_t sink, const double *values, size_t numValues)
+{
+    size_t slots = 1 + numValues;
+    if (!m_thread.joinable() || slots > m_ring.size())
+    {
+        // records that can never fit are written directly once the writer thread has caught up
+        WaitForSpace(m_ring.size());
+        m_valueSinkList[sink](values, numValues);
+        return;
+    }
+    WaitForSpace(slots);
+    size_t head = m_head.load(std::memory_order_relaxed);
+    WriteSlot(head, PackHeader((uint64_t(sink) << 33) | uint64_t(numValues)));
+    size_t start = (head + 1) & m_mask;
+    size_t firstPart = std::min(numValues, m_ring.size() - start);
+    std::copy(values, values + firstPart, m_ring.data() + start);
+    std::copy(values + firstPart, values + numValues, m_ring.data());
+    m_head.store(head + slots, std::memory_order_release);
+    m_wakeCondition.notify_all();
+}
+
+void AsyncDumpWriter::PushText(size_t sink, const std::string &text)
+{
+    uint64_t header = (uint64_t(sink) << 33) | c_textFlag | uint64_t(text.size());
+    size_t slots = RecordSlots(header);
+    if (!m_thread.joinable() || slots > m_ring.size())
+    {
+        WaitForSpace(m_ring.size());
+        m_textSinkList[sink](text.data(), text.size());
+        return;
+    }
+    WaitForSpace(slots);
+    size_t head = m_head.load(std::memory_order_relaxed);
+    WriteSlot(head, PackHeader(header));
+    for (size_t i = 1; i < slots; i++)
+    {
+        double chunk = 0;
+        size_t offset = (i - 1) * sizeof(double);
+        std::memcpy(&chunk, text.data() + offset, std::min(sizeof(double), text.size() - offset));
+        WriteSlot(head + i, chunk);
+    }
+    m_head.store(head + slots, std::memory_order_release);
+    m_wakeCondition.notify_all();
+}
+
+void AsyncDumpWriter::WaitForSpace(size_t slots)
+{
+    if (!m_thread.joinable()) return;
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) + slots <= m_ring.size()) return;
+    // the ring is full so the simulation has to wait for the writer thread
+    m_stallCount++;
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    while (head - m_tail.load(std::memory_order_acquire) + slots > m_ring.size())
+        m_wakeCondition.wait_for(lock, std::chrono::milliseconds(1));
+}
+
+void AsyncDumpWriter::WriteSlot(size_t index, double value)
+{
+    m_ring[index & m_mask] = value;
+}
+
+void AsyncDumpWriter::WriterThread()
+{
+    while (true)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+        if (tail == head)
+        {
+            if (m_stop.load(std::memory_order_acquire))
+            {
+                if (m_head.load(std::memory_order_acquire) == tail) break;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeCondition.wait_for(lock, std::chrono::milliseconds(1));
+            continue;
+        }
+        uint64_t header = UnpackHeader(m_ring[tail & m_mask]);
+        size_t slots = RecordSlots(header);
+        size_t start = (tail + 1) & m_mask;
+        const double *data = m_ring.data() + start;
+        if (start + slots - 1 > m_ring.size())
+        {
+            m_scratch.resize(slots - 1);
+            for (size_t i = 0; i < slots - 1; i++) m_scratch[i] = m_ring[(start + i) & m_mask];
+            data = m_scratch.data();
+        }
+        CallSink(header, data);
+        // the tail is only moved on once the sink has finished with the data
+        m_tail.store(tail + slots, std::memory_order_release);
+        m_wakeCondition.notify_all();
+    }
+}
+
+void AsyncDumpWriter::CallSink(uint64_t header, const double *data)
+{
+    size_t sink = size_t(header >> 33);
+    size_t count = size_t(header & c_countMask);
+    if (header & c_textFlag) m_textSinkList[sink](reinterpret_cast<const char *>(data), count);
+    else m_valueSinkList[sink](data, count);
+}
+
+uint64_t AsyncDumpWriter::stallCount() const
+{
+    return m_stallCount;
+}
@@ -0,0 +1,72 @@
+/*
+ *  AsyncDumpWriter.h
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+// AsyncDumpWriter moves the formatting and file writing of the dump output into a background thread.
+// The simulation thread copies raw values (or text that it could not avoid creating) into a
+// preallocated single producer single consumer ring buffer and the writer thread passes each
+// record to the sink function that it was sent to. If the ring buffer fills the simulation
+// thread waits for space so nothing is lost.
+
+#ifndef ASYNCDUMPWRITER_H
+#define ASYNCDUMPWRITER_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+class AsyncDumpWriter
+{
+public:
+    AsyncDumpWriter();
+    virtual ~AsyncDumpWriter();
+
+    typedef std::function<void(const double *values, size_t numValues)> ValueSink;
+    typedef std::function<void(const char *text, size_t length)> TextSink;
+
+    // the sinks need to be added before Start and they are called from the writer thread
+    size_t AddValueSink(ValueSink sink);
+    size_t AddTextSink(TextSink sink);
+
+    // capacity is the number of doubles in the ring buffer
+    void Start(size_t capacity);
+    // this waits until everything has been written and then stops the writer thread
+    void Stop();
+
+    void PushValues(size_t sink, const double *values, size_t numValues);
+    void PushText(size_t sink, const std::string &text);
+
+    uint64_t stallCount() const;
+
+private:
+    void WriterThread();
+    void WaitForSpace(size_t slots);
+    void WriteSlot(size_t index, double value);
+    void CallSink(uint64_t header, const double *data);
+
+    std::vector<ValueSink> m_valueSinkList;
+    std::vector<TextSink> m_textSinkList;
+
+    std::vector<double> m_ring;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<size_t> m_head = {0}; // only written by the simulation thread
+    alignas(64) std::atomic<size_t> m_tail = {0}; // only written by the writer thread
+    std::atomic<bool> m_stop = {false};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::thread m_thread;
+    std::vector<double> m_scratch; // used by the writer thread for records that wrap round the end of the ring
+    uint64_t m_stallCount = 0;
+};
+
+#endif // ASYNCDUMPWRITER_H
@@ -53,6 +53,7 @@ void Body::SetPosition(double x, double y, double z)
     m_currentPosition[1] = y;
     m_currentPosition[2] = z;
     if (m_bodyID) dBodySetPosition(m_bodyID, x, y, z);
+    m_stateVersion++;
 }
 
 void Body::SetQuaternion(double n, double x, double y, double z)
@@ -62,6 +63,7 @@ void Body::SetQuaternion(double n, double x, double y, double z)
     m_currentQuaternion[2] = y;
     m_currentQuaternion[3] = z;
     if (m_bodyID) dBodySetQuaternion(m_bodyID, m_currentQuaternion);
+    m_stateVersion++;
 }
 
 // parses the position allowing a relative position specified by BODY ID
@@ -232,6 +234,7 @@ std::string *Body::SetQuaternion(const std::string &buf)
 void Body::SetLinearVelocity(double x, double y, double z)
 {
     dBodySetLinearVel(m_bodyID, x, y, z);
+    m_stateVersion++;
 }
 
 // parses the linear velocity allowing a relative velocity specified by BODY ID
@@ -287,6 +290,7 @@ void Body::SetPositionDelta(double x, double y, double z)
         const double *p = dBodyGetPosition(m_bodyID);
         dBodySetPosition(m_bodyID, p[0] + x, p[1] + y, p[2] + z);
     }
+    m_stateVersion++;
 }
 
 void Body::SetQuaternionDelta(double n, double x, double y, double z)
@@ -304,6 +308,7 @@ void Body::SetQuaternionDelta(double n, double x, double y, double z)
         dQMultiply0(qa, qb, q);
         dBodySetQuaternion(m_bodyID, qa);
     }
+    m_stateVersion++;
 }
 
 double Body::GetLinearKineticEnergy()
@@ -368,6 +373,7 @@ double Body::GetGravitationalPotentialEnergy()
 void Body::SetAngularVelocity(double x, double y, double z)
 {
     dBodySetAngularVel(m_bodyID, x, y, z);
+    m_stateVersion++;
 }
 
 // parses the angular velocity allowing a relative angular velocity specified by BODY ID
@@ -571,6 +577,18 @@ Body::LimitTestResult Body::TestLimits()
     return WithinLimits;
 }
 
+// returns true if any of the limits have been changed from their unlimited default values
+bool Body::HasFiniteLimits() const
+{
+    for (size_t i = 0; i < 3; i++)
+    {
+        if (m_positionLowBound[i] != -DBL_MAX || m_positionHighBound[i] != DBL_MAX) return true;
+        if (m_linearVelocityLowBound[i] != -DBL_MAX || m_linearVelocityHighBound[i] != DBL_MAX) return true;
+        if (m_angularVelocityLowBound[i] != -DBL_MAX || m_angularVelocityHighBound[i] != DBL_MAX) return true;
+    }
+    return false;
+}
+
 double Body::GetProjectedAngle(const pgd::Vector3 &planeNormal, const pgd::Vector3 &vector1, const pgd::Vector3 &vector2)
 {
     // calculate the projected angle from vector1 to vector2 projected onto the plane defined by a normal vector
@@ -603,14 +621,16 @@ double Body::GetProjectedAngle(const pgd::Vector3 &planeNormal, const pgd::Vecto
 
 std::string Body::dumpToString()
 {
-    std::stringstream ss;
-    ss.precision(17);
-    ss.setf(std::ios::scientific);
-    if (firstDump())
-    {
-        setFirstDump(false);
-        ss << "Time\tXP\tYP\tZP\tXV\tYV\tZV\tQW\tQX\tQY\tQZ\tRVX\tRVY\tRVZ\tLKEX\tLKEY\tLKEZ\tRKE\tGPE\n";
-    }
+    return dumpValuesToString();
+}
+
+std::vector<std::string> Body::dumpNames() const
+{
+    return {"Time"s, "XP"s, "YP"s, "ZP"s, "XV"s, "YV"s, "ZV"s, "QW"s, "QX"s, "QY"s, "QZ"s, "RVX"s, "RVY"s, "RVZ"s, "LKEX"s, "LKEY"s, "LKEZ"s, "RKE"s, "GPE"s, "FX"s, "FY"s, "FZ"s, "TX"s, "TY"s, "TZ"s};
+}
+
+void Body::dumpValues(std::vector<double> *values)
+{
     const double *p = GetPosition();
     const double *v = GetLinearVelocity();
     const double *q = GetQuaternion();
@@ -618,14 +638,14 @@ std::string Body::dumpToString()
     dVector3 ke;
     GetLinearKineticEnergy(ke);
 
-    ss << simulation()->GetTime() << "\t" << p[0] << "\t" << p[1] << "\t" << p[2] <<
-          "\t" << v[0] << "\t" << v[1] << "\t" << v[2] <<
-          "\t" << q[0] << "\t" << q[1] << "\t" << q[2] << "\t" << q[3] <<
-          "\t" << rv[0] << "\t" << rv[1] << "\t" << rv[2] <<
-          "\t" << ke[0] << "\t" << ke[1] << "\t" << ke[2] <<
-          "\t" << GetRotationalKineticEnergy() << "\t" << GetGravitationalPotentialEnergy() <<
-          "\n";
-    return ss.str();
+    *values = {simulation()->GetTime(), p[0], p[1], p[2],
+               v[0], v[1], v[2],
+               q[0], q[1], q[2], q[3],
+               rv[0], rv[1], rv[2],
+               ke[0], ke[1], ke[2],
+               GetRotationalKineticEnergy(), GetGravitationalPotentialEnergy(),
+               m_externalForce.x, m_externalForce.y, m_externalForce.z,
+               m_externalTorque.x, m_externalTorque.y, m_externalTorque.z};
 }
 
 // a utility function to calculate moments of interia given an arbitrary translation and rotation
@@ -854,6 +874,13 @@ void Body::SetCylinderDragParameters(DragControl dragAxis, double dragFluidDensi
     m_dragCylinderLength = dragCylinderMax - dragCylinderMin;
     m_dragCylinderRadius = dragCylinderRadius;
     m_dragCylinderCoefficient = dragCylinderCoefficient;
+
+    // precalculate the geometry terms used by Simulation::ComputeDrag
+    double area = M_PI * m_dragCylinderRadius * m_dragCylinderRadius;
+    double C2 = m_dragFluidDensity * m_dragCylinderCoefficient;
+    m_dragCylinderAxialCoefficient = 0.5 * C2 * area;
+    m_dragCylinderNormalCoefficient = C2 * m_dragCylinderRadius * m_dragCylinderLength;
+    for (size_t k = 0; k < 4; k++) m_dragCylinderQuadraturePoints[k] = m_dragCylinderMin + m_dragCylinderLength * dragGaussQuadratureX[k];
 }
 
 void Body::SetDirectDragCoefficients(double linearDragCoefficientX, double linearDragCoefficientY, double linearDragCoefficientZ,
@@ -868,146 +895,6 @@ void Body::SetDirectDragCoefficients(double linearDragCoefficientX, double linea
     m_dragCoefficients[5] = linearDragCoefficientZ;
 }
 
-// this routine modifed from Dynamechs 4.0 by Scott McMillan
-void Body::ComputeDrag()
-{
-    const double gqx[4] = {0.069431844,     // Gauss-quadrature constants.
-                           0.330009478,
-                           0.669990521,
-                           0.930568155};
-    const double gqk[4] = {0.1739274225687,
-                           0.3260725774312,
-                           0.3260725774312,
-                           0.1739274225687};
-
-    if (m_dragControl == NoDrag) return;
-    int k;
-
-    double f_D[6] = {0, 0, 0, 0, 0, 0}; // angular follwed by linear
-    double v_rel[6]; // angular follwed by linear
-
-    const double *aVel = dBodyGetAngularVel(m_bodyID);
-    dBodyVectorFromWorld (m_bodyID, aVel[0], aVel[1], aVel[2], v_rel);
-
-    const double *lVel = dBodyGetLinearVel(m_bodyID);
-    dBodyVectorFromWorld (m_bodyID, lVel[0], lVel[1], lVel[2], &(v_rel[3]));
-
-
-    if (m_dragControl == DragCoefficients)
-    {
-        for (k = 0; k < 6; k++)
-        {
-            f_D[k] = -m_dragCoefficients[k]*v_rel[k]*fabs(v_rel[k]);
-        }
-    }
-    else
-    {
-
-        double area = M_PI * m_dragCylinderRadius * m_dragCylinderRadius;
-        double C2 = m_dragFluidDensity * m_dragCylinderCoefficient;
-        double Ca = 0.5 * C2 * area;
-        double C2rl = C2 * m_dragCylinderRadius * m_dragCylinderLength;
-        double vn[3], tem[3];
-        double x, tmp, vn_mag;
-
-        if (m_dragControl == DragCylinderX)
-        {
-            // x-axis moment and force
-            f_D[3] = -Ca*v_rel[3]*fabs(v_rel[3]);
-
-            // y,z components - using Gauss-quadrature
-            for (k = 0; k < 4; k++)
-            {
-                x = m_dragCylinderMin + m_dragCylinderLength*gqx[k];
-                vn[1] = v_rel[4] + v_rel[2]*x;
-                vn[2] = v_rel[5] - v_rel[1]*x;
-
-                vn_mag = sqrt(vn[1]*vn[1] + vn[2]*vn[2]);
-
-                tmp = gqk[k]*vn_mag;
-                tem[1] = tmp*vn[1];
-                tem[2] = tmp*vn[2];
-
-                f_D[1] += (-x*tem[2]);
-                f_D[2] += x*tem[1];
-                f_D[4] += tem[1];
-                f_D[5] += tem[2];
-            }
-            f_D[1] *= -C2rl;
-            f_D[2] *= -C2rl;
-            f_D[4] *= -C2rl;
-            f_D[5] *= -C2rl;
-        }
-
-        else if (m_dragControl == DragCylinderY)
-        {
-            // y-axis moment and force
-            f_D[4] = -Ca*v_rel[4]*fabs(v_rel[4]);
-
-            // z,x components
-            for (k = 0; k < 4; k++)
-            {
-                x = m_dragCylinderMin + m_dragCylinderLength*gqx[k];
-                vn[0] = v_rel[3] - v_rel[2]*x;
-                vn[2] = v_rel[5] + v_rel[0]*x;
-
-                vn_mag = sqrt(vn[2]*vn[2] + vn[0]*vn[0]);
-
-                tmp = gqk[k]*vn_mag;
-                tem[0] = tmp*vn[0];
-                tem[2] = tmp*vn[2];
-
-                f_D[0] += (x*tem[2]);
-                f_D[2] += -x*tem[0];
-                f_D[3] += tem[0];
-                f_D[5] += tem[2];
-            }
-            f_D[0] *= -C2rl;
-            f_D[2] *= -C2rl;
-            f_D[3] *= -C2rl;
-            f_D[5] *= -C2rl;
-
-        }
-
-        else if (m_dragControl == DragCylinderZ)
-        {
-            // z-axis moment and force
-            f_D[5] = -Ca*v_rel[5]*fabs(v_rel[5]);
-
-            // y,x components
-            for (k = 0; k < 4; k++)
-            {
-                x = m_dragCylinderMin + m_dragCylinderLength*gqx[k];
-                vn[0] = v_rel[3] + v_rel[1]*x;
-                vn[1] = v_rel[4] - v_rel[0]*x;
-
-                vn_mag = sqrt(vn[1]*vn[1] + vn[0]*vn[0]);
-
-                tmp = gqk[k]*vn_mag;
-                tem[0] = tmp*vn[0];
-                tem[1] = tmp*vn[1];
-
-                f_D[0] += (-x*tem[1]);
-                f_D[1] += x*tem[0];
-                f_D[3] += tem[0];
-                f_D[4] += tem[1];
-            }
-            f_D[0] *= -C2rl;
-            f_D[1] *= -C2rl;
-            f_D[3] *= -C2rl;
-            f_D[4] *= -C2rl;
-
-        }
-
-    }
-
-    // drag forces are now in f_D (3 rotational followed by 3 linear)
-    // need to add them to the body
-    dBodyAddRelTorque(m_bodyID, f_D[0], f_D[1], f_D[2]);
-    dBodyAddRelForce(m_bodyID, f_D[3], f_D[4], f_D[5]);
-
-}
-
 #endif
 
 // this function initialises the data in the object based on the contents
@@ -1245,6 +1132,30 @@ void Body::appendToAttributes()
     if (constructionMode) EnterConstructionMode();
 }
 
+void Body::appendStateValues(std::vector<double> *values)
+{
+    NamedObject::appendStateValues(values);
+    const double *q = dBodyGetQuaternion(m_bodyID);
+    values->insert(values->end(), q, q + 4);
+    const double *p = dBodyGetPosition(m_bodyID);
+    values->insert(values->end(), p, p + 3);
+    const double *v = dBodyGetLinearVel(m_bodyID);
+    values->insert(values->end(), v, v + 3);
+    const double *a = dBodyGetAngularVel(m_bodyID);
+    values->insert(values->end(), a, a + 3);
+}
+
+const double *Body::stateValuesToAttributes(const double *values, std::map<std::string, std::string> *attributeMap) const
+{
+    values = NamedObject::stateValuesToAttributes(values, attributeMap);
+    std::string buf;
+    (*attributeMap)["Quaternion"s] = *GSUtil::ToString(values, 4, &buf);
+    (*attributeMap)["Position"s] = *GSUtil::ToString(values + 4, 3, &buf);
+    (*attributeMap)["LinearVelocity"s] = *GSUtil::ToString(values + 7, 3, &buf);
+    (*attributeMap)["AngularVelocity"s] = *GSUtil::ToString(values + 10, 3, &buf);
+    return values + 13;
+}
+
 void Body::LateInitialisation()
 {
     this->SetPosition(m_initialPosition[0], m_initialPosition[1], m_initialPosition[2]);
@@ -1289,3 +1200,58 @@ const double *Body::GetInitialQuaternion()
 {
     return m_initialQuaternion;
 }
+
+uint64_t Body::GetStateVersion() const
+{
+    return m_stateVersion;
+}
+
+// this needs to be called whenever the ODE body state is changed outside the setters (e.g. by dWorldStep)
+void Body::IncrementStateVersion()
+{
+    m_stateVersion++;
+}
+
+size_t Body::GetContactAggregateIndex() const
+{
+    return m_contactAggregateIndex;
+}
+
+void Body::SetContactAggregateIndex(size_t contactAggregateIndex)
+{
+    m_contactAggregateIndex = contactAggregateIndex;
+}
+
+void Body::ClearExternalLoads()
+{
+    m_externalForce = pgd::Vector3();
+    m_externalTorque = pgd::Vector3();
+}
+
+// this is equivalent to dBodyAddForceAtPos but only writes to the local accumulators
+void Body::AddExternalForceAtPosition(double fx, double fy, double fz, double px, double py, double pz)
+{
+    const double *p = GetPosition();
+    pgd::Vector3 force(fx, fy, fz);
+    pgd::Vector3 arm(px - p[0], py - p[1], pz - p[2]);
+    pgd::Vector3 torque = arm ^ force;
+    m_externalForce += force;
+    m_externalTorque += torque;
+}
+
+void Body::ApplyExternalLoads()
+{
+    if (m_bodyID == nullptr) return;
+    dBodyAddForce(m_bodyID, m_externalForce.x, m_externalForce.y, m_externalForce.z);
+    dBodyAddTorque(m_bodyID, m_externalTorque.x, m_externalTorque.y, m_externalTorque.z);
+}
+
+const pgd::Vector3 &Body::GetExternalForce() const
+{
+    return m_externalForce;
+}
+
+const pgd::Vector3 &Body::GetExternalTorque() const
+{
+    return m_externalTorque;
+}
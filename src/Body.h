@@ -73,6 +73,14 @@ public:
     void SetCylinderDragParameters(DragControl dragAxis, double dragFluidDensity, double dragCylinderMin, double dragCylinderMax, double dragCylinderRadius, double dragCylinderCoefficient);
     void SetDirectDragCoefficients(double linearDragCoefficientX, double linearDragCoefficientY, double linearDragCoefficientZ,
                                    double rotationalDragCoefficientX, double rotationalDragCoefficientY, double rotationalDragCoefficientZ);
+    // Gauss-quadrature constants for the cylinder drag
+    static constexpr double dragGaussQuadratureX[4] = {0.069431844, 0.330009478, 0.669990521, 0.930568155};
+    static constexpr double dragGaussQuadratureK[4] = {0.1739274225687, 0.3260725774312, 0.3260725774312, 0.1739274225687};
+    DragControl GetDragControl() const { return m_dragControl; }
+    const double *GetDragCoefficients() const { return m_dragCoefficients; } // 3 rotational then 3 linear
+    double GetDragCylinderAxialCoefficient() const { return m_dragCylinderAxialCoefficient; }
+    double GetDragCylinderNormalCoefficient() const { return m_dragCylinderNormalCoefficient; }
+    const double *GetDragCylinderQuadraturePoints() const { return m_dragCylinderQuadraturePoints; }
 #endif
 
     const double *GetPosition();
@@ -98,16 +106,27 @@ public:
     const double *GetInitialPosition();
     const double *GetInitialQuaternion();
 
+    uint64_t GetStateVersion() const;
+    void IncrementStateVersion();
+
+    // index into the simulation contact aggregate list
+    size_t GetContactAggregateIndex() const;
+    void SetContactAggregateIndex(size_t contactAggregateIndex);
+
+    // external loads (e.g. from muscles and fluid sacs) are summed here and sent to ODE once per step
+    void ClearExternalLoads();
+    void AddExternalForceAtPosition(double fx, double fy, double fz, double px, double py, double pz);
+    void ApplyExternalLoads();
+    const pgd::Vector3 &GetExternalForce() const;
+    const pgd::Vector3 &GetExternalTorque() const;
+
     LimitTestResult TestLimits();
+    bool HasFiniteLimits() const;
 //    int SanityCheck(Body *otherBody, Simulation::AxisType axis, const std::string &sanityCheckLeft, const std::string &sanityCheckRight);
 
     void EnterConstructionMode();
     void EnterRunMode();
 
-#ifdef EXPERIMENTAL
-    void ComputeDrag();
-#endif
-
     // Utility
     static void ParallelAxis(dMass *massProperties, const double *translation, const double *quaternion, dMass *newMassProperties);
     static void ParallelAxis(double x, double y, double z, // transformation from centre of mass to new location (m)
@@ -128,9 +147,13 @@ public:
     std::string GetGraphicFile3() const { return m_graphicFile3; }
 
     virtual std::string dumpToString() override;
+    virtual std::vector<std::string> dumpNames() const override;
+    virtual void dumpValues(std::vector<double> *values) override;
     virtual std::string *createFromAttributes() override;
     virtual void saveToAttributes() override;
     virtual void appendToAttributes() override;
+    virtual void appendStateValues(std::vector<double> *values) override;
+    virtual const double *stateValuesToAttributes(const double *values, std::map<std::string, std::string> *attributeMap) const override;
 
 private:
 
@@ -167,6 +190,15 @@ private:
 
     bool m_constructionMode = false;
 
+    // incremented whenever the position, orientation or velocity changes so that dependent values can be cached
+    uint64_t m_stateVersion = 0;
+
+    size_t m_contactAggregateIndex = SIZE_MAX;
+
+    // world coordinates with the torque about the centre of mass
+    pgd::Vector3 m_externalForce;
+    pgd::Vector3 m_externalTorque;
+
 
 #ifdef EXPERIMENTAL
     DragControl m_dragControl = DragControl::NoDrag;
@@ -176,6 +208,10 @@ private:
     double m_dragCylinderLength = 0;
     double m_dragCylinderRadius = 0;
     double m_dragCylinderCoefficient = 0;
+    // these only depend on the drag parameters so they are calculated when the parameters are set
+    double m_dragCylinderAxialCoefficient = 0;
+    double m_dragCylinderNormalCoefficient = 0;
+    double m_dragCylinderQuadraturePoints[4] = {0, 0, 0, 0};
 #endif
 
 };
@@ -11,10 +11,23 @@
 #define Contact_h
 
 #include "NamedObject.h"
+#include "PGDMath.h"
 
 #include "ode/ode.h"
 
 class SimulationWindow;
+class Geom;
+
+// the summed contact values for a single geom or body
+// torque is about the world origin and the centre of pressure is weighted by the contact force magnitudes
+struct ContactAggregate
+{
+    pgd::Vector3 force;
+    pgd::Vector3 torque;
+    pgd::Vector3 centreOfPressure;
+    double forceMagnitudeSum = 0;
+    size_t numContacts = 0;
+};
 
 class Contact:public NamedObject
 {
@@ -27,11 +40,17 @@ public:
     dJointFeedback* GetJointFeedback() { return &m_ContactJointFeedback; }
     double* GetContactPosition() { return m_ContactPosition; }
 
+    void SetGeoms(Geom *geom1, Geom *geom2) { m_Geom1 = geom1; m_Geom2 = geom2; }
+    Geom *GetGeom1() { return m_Geom1; }
+    Geom *GetGeom2() { return m_Geom2; }
+
 private:
 
     dJointID m_JointID = nullptr;
     dJointFeedback m_ContactJointFeedback = {};
     dVector3 m_ContactPosition;
+    Geom *m_Geom1 = nullptr;
+    Geom *m_Geom2 = nullptr;
 
 };
 
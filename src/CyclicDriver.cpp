@@ -28,7 +28,7 @@ CyclicDriver::~CyclicDriver()
 
 void CyclicDriver::Update()
 {
-    assert(simulation()->GetStepCount() == lastStepCount() + 1);
+    assert(simulation()->GetStepCount() == nextUpdateStepCount());
     setLastStepCount(simulation()->GetStepCount());
 
     // account for phase
@@ -84,19 +84,19 @@ bool DampedSpringMuscle::ShouldBreak()
 
 std::string DampedSpringMuscle::dumpToString()
 {
-    std::stringstream ss;
-    ss.precision(17);
-    ss.setf(std::ios::scientific);
-    if (firstDump())
-    {
-        setFirstDump(false);
-        ss << "Time\tact\ttension\tlength\tvelocity\tPMECH\n";
-    }
-    ss << simulation()->GetTime() << "\t" << m_Activation <<
-          "\t" << GetStrap()->GetTension() << "\t" << GetStrap()->GetLength() << "\t" << GetStrap()->GetVelocity() <<
-          "\t" << GetStrap()->GetVelocity() * GetStrap()->GetTension() <<
-          "\n";
-    return ss.str();
+    return dumpValuesToString();
+}
+
+std::vector<std::string> DampedSpringMuscle::dumpNames() const
+{
+    return {"Time"s, "act"s, "tension"s, "length"s, "velocity"s, "PMECH"s};
+}
+
+void DampedSpringMuscle::dumpValues(std::vector<double> *values)
+{
+    *values = {simulation()->GetTime(), m_Activation,
+               GetStrap()->GetTension(), GetStrap()->GetLength(), GetStrap()->GetVelocity(),
+               GetStrap()->GetVelocity() * GetStrap()->GetTension()};
 }
 
 std::string *DampedSpringMuscle::createFromAttributes()
@@ -41,6 +41,8 @@ public:
     bool ShouldBreak();
 
     virtual std::string dumpToString();
+    virtual std::vector<std::string> dumpNames() const;
+    virtual void dumpValues(std::vector<double> *values);
 
     virtual std::string *createFromAttributes();
     virtual void appendToAttributes();
@@ -34,6 +34,64 @@ double DataTarget::lastValue() const
     return m_lastValue;
 }
 
+// returns the index of the first target time that is not less than time (the same as std::lower_bound)
+// simulation time normally only increases so the search carries on from the previous result
+// which makes each lookup amortised O(1) and only falls back to a binary search if time goes backwards
+size_t DataTarget::lowerBoundIndex(double time)
+{
+    if (m_timeBase) return m_timeBase->lowerBoundIndex(time);
+    if (time == m_cursorTime) return m_cursorIndex;
+    if (time < m_cursorTime)
+    {
+        m_cursorIndex = size_t(std::distance(m_targetTimeList.begin(), std::lower_bound(m_targetTimeList.begin(), m_targetTimeList.end(), time)));
+    }
+    else
+    {
+        size_t size = m_targetTimeList.size();
+        while (m_cursorIndex < size && m_targetTimeList[m_cursorIndex] < time) m_cursorIndex++;
+    }
+    m_cursorTime = time;
+    return m_cursorIndex;
+}
+
+// returns the pair of indices that bracket time for interpolation
+// both indices are the same if time is outside the range of the target times
+void DataTarget::bracketIndices(double time, size_t *index, size_t *indexNext)
+{
+    size_t lowerBound = lowerBoundIndex(time);
+    if (lowerBound == 0) // time <= lowest value in the list
+    {
+        *index = 0;
+        *indexNext = 0;
+    }
+    else if (time >= m_targetTimeList.back()) // time >= highest value in the list
+    {
+        *index = m_targetTimeList.size() - 1;
+        *indexNext = *index;
+    }
+    else
+    {
+        *index = lowerBound - 1;
+        *indexNext = lowerBound;
+    }
+}
+
+DataTarget *DataTarget::timeBase() const
+{
+    return m_timeBase;
+}
+
+// a target that has exactly the same target times as another target can use its time cursor
+void DataTarget::setTimeBase(DataTarget *timeBase)
+{
+    m_timeBase = (timeBase == this) ? nullptr : timeBase;
+}
+
+bool DataTarget::hasSameTargetTimes(const DataTarget &other) const
+{
+    return m_targetTimeList == other.m_targetTimeList;
+}
+
 double DataTarget::positiveFunction(double v)
 {
     switch (m_matchType)
@@ -56,8 +114,7 @@ std::tuple<double, bool> DataTarget::calculateMatchValue(double time)
     {
     case Punctuated:
         {
-            auto lowerBound = std::lower_bound(m_targetTimeList.begin(), m_targetTimeList.end(), time);
-            size_t index = std::distance(m_targetTimeList.begin(), lowerBound);
+            size_t index = lowerBoundIndex(time);
             if (index == 0)
                 return std::make_tuple(m_lastValue, false); // this means that time is less than the lowest value in the list
             if (index == m_lastIndex)
@@ -129,6 +186,8 @@ std::string *DataTarget::createFromAttributes()
     m_targetTimeList.clear();
     m_targetTimeList.reserve(targetTimesTokens.size());
     for (auto &&token : targetTimesTokens) m_targetTimeList.push_back(GSUtil::Double(token));
+    m_cursorIndex = 0;
+    m_cursorTime = -DBL_MAX;
     if (std::is_sorted(m_targetTimeList.begin(), m_targetTimeList.end()) == false)
     {
         setLastError("DataTarget ID=\""s + name() +"\" TargetTimes are not in ascending order"s);
@@ -41,8 +41,14 @@ public:
 
     double lastValue() const;
 
+    DataTarget *timeBase() const;
+    void setTimeBase(DataTarget *timeBase);
+    bool hasSameTargetTimes(const DataTarget &other) const;
+
 protected:
     std::vector<double> *targetTimeList();
+    size_t lowerBoundIndex(double time);
+    void bracketIndices(double time, size_t *index, size_t *indexNext);
 
 private:
     double m_intercept = 0;
@@ -53,6 +59,9 @@ private:
     double m_abortAbove = DBL_MAX;
     std::vector<double> m_targetTimeList;
     size_t m_lastIndex = SIZE_MAX;
+    DataTarget *m_timeBase = nullptr; // if set the time cursor from this target is used instead
+    size_t m_cursorIndex = 0;
+    double m_cursorTime = -DBL_MAX;
     double m_lastValue = 0;
     double m_abortBonus = 0;
 };
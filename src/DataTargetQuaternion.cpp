@@ -30,62 +30,26 @@ DataTargetQuaternion::DataTargetQuaternion()
 // in this case this is the angle between the two quaternions
 double DataTargetQuaternion::calculateError(size_t valueListIndex)
 {
-    const double *r;
-    Body *body;
-    Geom *geom;
-    dQuaternion q;
-    double angle = 0;
     if (valueListIndex >= m_QValueList.size())
     {
         std::cerr << "Warning: DataTargetQuaternion::GetMatchValue valueListIndex out of range\n";
         return 0;
     }
-
-    if ((body = dynamic_cast<Body *>(GetTarget())) != nullptr)
-    {
-        r = body->GetQuaternion();
-        angle = pgd::FindAngle(m_QValueList[size_t(valueListIndex)], pgd::Quaternion(r[0], r[1], r[2], r[3]));
-    }
-    else if ((geom = dynamic_cast<Geom *>(GetTarget())) != nullptr)
-    {
-        geom->GetWorldQuaternion(q);
-        angle = pgd::FindAngle(m_QValueList[size_t(valueListIndex)], pgd::Quaternion(q[0], q[1], q[2], q[3]));
-    }
-    else
+    if (!m_accessorValid) ResolveAccessor();
+    if (!m_accessor)
     {
         std::cerr << "DataTargetQuaternion target missing error " << name() << "\n";
+        return 0;
     }
-    return angle;
+    return pgd::FindAngle(m_QValueList[valueListIndex], m_accessor(m_Target));
 }
 
 // returns the degree of match to the stored values
 // in this case this is the angle between the two quaternions
 double DataTargetQuaternion::calculateError(double time)
 {
-    const double *r;
-    Body *body;
-    Geom *geom;
-    dQuaternion q;
-    double angle = 0;
-
     size_t index, indexNext;
-    auto lowerBound = std::lower_bound(targetTimeList()->begin(), targetTimeList()->end(), time);
-    auto upperBound = std::upper_bound(targetTimeList()->begin(), targetTimeList()->end(), time);
-    if (lowerBound == targetTimeList()->begin()) // time <= lowest value in the list
-    {
-        index = 0;
-        indexNext = index;
-    }
-    else if (upperBound == targetTimeList()->end()) // time > highest value in the list
-    {
-        index = targetTimeList()->size() - 1;
-        indexNext = index;
-    }
-    else
-    {
-        index = std::distance(targetTimeList()->begin(), lowerBound) - 1; // subtracting 1 because lower bound gives an index 1 higher than expected (IMO)
-        indexNext = std::min(index + 1, targetTimeList()->size() - 1);
-    }
+    bracketIndices(time, &index, &indexNext);
 
     // do a slerp interpolation between the target quaternions
     double delTime = (*targetTimeList())[size_t(indexNext)] - (*targetTimeList())[size_t(index)];
@@ -94,21 +58,25 @@ double DataTargetQuaternion::calculateError(double time)
     else interpolationFraction = (time - (*targetTimeList())[size_t(index)]) / delTime;
     pgd::Quaternion interpolatedTarget = pgd::slerp(m_QValueList[size_t(index)], m_QValueList[size_t(indexNext)], interpolationFraction);
 
-    if ((body = dynamic_cast<Body *>(GetTarget())) != nullptr)
-    {
-        r = body->GetQuaternion();
-        angle = pgd::FindAngle(interpolatedTarget, pgd::Quaternion(r[0], r[1], r[2], r[3]));
-    }
-    else if ((geom = dynamic_cast<Geom *>(GetTarget())) != nullptr)
-    {
-        geom->GetWorldQuaternion(q);
-        angle = pgd::FindAngle(interpolatedTarget, pgd::Quaternion(q[0], q[1], q[2], q[3]));
-    }
-    else
+    if (!m_accessorValid) ResolveAccessor();
+    if (!m_accessor)
     {
         std::cerr << "DataTargetQuaternion target missing error " << name() << "\n";
+        return 0;
     }
-    return angle;
+    return pgd::FindAngle(interpolatedTarget, m_accessor(m_Target));
+}
+
+// this function works out how to get the orientation from the target once rather than every time the error is calculated
+// m_accessor is left as nullptr if the target type is not supported
+void DataTargetQuaternion::ResolveAccessor()
+{
+    m_accessor = nullptr;
+    m_accessorValid = true;
+    if (dynamic_cast<Body *>(m_Target))
+        m_accessor = [](NamedObject *target) { const double *r = static_cast<Body *>(target)->GetQuaternion(); return pgd::Quaternion(r[0], r[1], r[2], r[3]); };
+    else if (dynamic_cast<Geom *>(m_Target))
+        m_accessor = [](NamedObject *target) { dQuaternion q; static_cast<Geom *>(target)->GetWorldQuaternion(q); return pgd::Quaternion(q[0], q[1], q[2], q[3]); };
 }
 
 std::string DataTargetQuaternion::dumpToString()
@@ -121,34 +89,22 @@ std::string DataTargetQuaternion::dumpToString()
         setFirstDump(false);
         ss << "Time\tTargetQW\tTargetQX\tTargetQY\tTargetQZ\tActualQW\tActualQX\tActualQY\tActualQZ\tAngle\n";
     }
-    Body *body;
-    Geom *geom;
-    const double *r;
-    double angle = 0;
-    dQuaternion q = {0, 0, 0, 0};
 
-    size_t valueListIndex = 0;
-    auto lowerBounds = std::lower_bound(targetTimeList()->begin(), targetTimeList()->end(), simulation()->GetTime());
-    if (lowerBounds != targetTimeList()->end()) valueListIndex = std::distance(targetTimeList()->begin(), lowerBounds);
+    size_t valueListIndex = lowerBoundIndex(simulation()->GetTime());
+    if (valueListIndex >= targetTimeList()->size()) valueListIndex = 0;
 
-    if ((body = dynamic_cast<Body *>(GetTarget())) != nullptr)
-    {
-        r = body->GetQuaternion();
-        angle = pgd::FindAngle(m_QValueList[size_t(valueListIndex)], pgd::Quaternion(r[0], r[1], r[2], r[3]));
-        q[0] = r[0];
-        q[1] = r[1];
-        q[2] = r[2];
-        q[3] = r[3];
-    }
-    else if ((geom = dynamic_cast<Geom *>(GetTarget())) != nullptr)
+    if (!m_accessorValid) ResolveAccessor();
+    pgd::Quaternion q(0, 0, 0, 0);
+    double angle = 0;
+    if (m_accessor)
     {
-        geom->GetWorldQuaternion(q);
-        angle = pgd::FindAngle(m_QValueList[size_t(valueListIndex)], pgd::Quaternion(q[0], q[1], q[2], q[3]));
+        q = m_accessor(m_Target);
+        angle = pgd::FindAngle(m_QValueList[size_t(valueListIndex)], q);
     }
 
     ss << simulation()->GetTime() <<
           "\t" << m_QValueList[size_t(valueListIndex)].n << "\t" << m_QValueList[size_t(valueListIndex)].x << "\t" << m_QValueList[size_t(valueListIndex)].y << "\t" << m_QValueList[size_t(valueListIndex)].z <<
-          "\t" << q[0] << "\t" << q[1] << "\t" << q[2] << "\t" << q[3] <<
+          "\t" << q.n << "\t" << q.x << "\t" << q.y << "\t" << q.z <<
           "\t" << angle <<
           "\n";
     return ss.str();
@@ -157,6 +113,7 @@ std::string DataTargetQuaternion::dumpToString()
 void DataTargetQuaternion::SetTarget(NamedObject *target)
 {
     m_Target = target;
+    m_accessorValid = false;
 }
 
 NamedObject *DataTargetQuaternion::GetTarget()
@@ -214,6 +171,7 @@ std::string *DataTargetQuaternion::createFromAttributes()
     }
 
     if (m_Target) setUpstreamObjects({m_Target});
+    ResolveAccessor();
     return nullptr;
 }
 
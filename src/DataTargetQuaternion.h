@@ -30,10 +30,16 @@ public:
     virtual double calculateError(double time);
 
 private:
+    void ResolveAccessor();
 
     NamedObject *m_Target = nullptr;
     std::vector<pgd::Quaternion> m_QValueList;
 
+    // the function that gets the orientation of the target is only worked out once
+    typedef pgd::Quaternion (*Accessor)(NamedObject *target);
+    Accessor m_accessor = nullptr;
+    bool m_accessorValid = false;
+
 };
 
 #endif // DATATARGETQUATERNION_H
@@ -19,6 +19,8 @@
 #include "Geom.h"
 #include "GSUtil.h"
 #include "TegotaeDriver.h"
+#include "Simulation.h"
+#include "Contact.h"
 
 #include "pystring.h"
 
@@ -51,344 +53,15 @@ double DataTargetScalar::calculateError(size_t index)
 
 double DataTargetScalar::calculateErrorScore(double value)
 {
-    m_errorScore = 0;
-    const double *r;
-    dVector3 result;
-    dQuaternion q;
-    pgd::Quaternion pq;
-    pgd::Vector3 pv;
-    std::vector<Contact *> *contactList;
-    double force;
-
-    Body *body;
-    HingeJoint *hingeJoint;
-    BallJoint *ballJoint;
-    UniversalJoint *universalJoint;
-    Marker *marker;
-    Geom *geom;
-    TegotaeDriver *tegotaeDriver;
-
-    while (true)
+    if (!m_accessorValid) ResolveAccessor();
+    if (m_accessor)
     {
-        if ((body = dynamic_cast<Body *>(GetTarget())) != nullptr)
-        {
-            switch (m_DataType)
-            {
-            case Q0:
-                r = body->GetQuaternion();
-                m_errorScore = (r[0] - value);
-                break;
-            case Q1:
-                r = body->GetQuaternion();
-                m_errorScore = (r[1] - value);
-                break;
-            case Q2:
-                r = body->GetQuaternion();
-                m_errorScore = (r[2] - value);
-                break;
-            case Q3:
-                r = body->GetQuaternion();
-                m_errorScore = (r[3] - value);
-                break;
-            case XP:
-                r = body->GetPosition();
-                m_errorScore = (r[0] - value);
-                break;
-            case YP:
-                r = body->GetPosition();
-                m_errorScore = (r[1] - value);
-                break;
-            case ZP:
-                r = body->GetPosition();
-                m_errorScore = (r[2] - value);
-                break;
-            case XV:
-                r = body->GetLinearVelocity();
-                m_errorScore = (r[0] - value);
-                break;
-            case YV:
-                r = body->GetLinearVelocity();
-                m_errorScore = (r[1] - value);
-                break;
-            case ZV:
-                r = body->GetLinearVelocity();
-                m_errorScore = (r[2] - value);
-                break;
-            case XRV:
-                r = body->GetAngularVelocity();
-                m_errorScore = (r[0] - value);
-                break;
-            case YRV:
-                r = body->GetAngularVelocity();
-                m_errorScore = (r[1] - value);
-                break;
-            case ZRV:
-                r = body->GetAngularVelocity();
-                m_errorScore = (r[2] - value);
-                break;
-            default:
-                std::cerr << "DataTargetScalar::GetMatchValue error in " << name() << " unknown DataType " << m_DataType << "\n";
-            }
-            break;
-        }
-        if ((marker = dynamic_cast<Marker *>(GetTarget())) != nullptr)
-        {
-            switch (m_DataType)
-            {
-            case Q0:
-                pq = marker->GetWorldQuaternion();
-                m_errorScore = (pq.n - value);
-                break;
-            case Q1:
-                pq = marker->GetWorldQuaternion();
-                m_errorScore = (pq.x - value);
-                break;
-            case Q2:
-                pq = marker->GetWorldQuaternion();
-                m_errorScore = (pq.y - value);
-                break;
-            case Q3:
-                pq = marker->GetWorldQuaternion();
-                m_errorScore = (pq.z - value);
-                break;
-            case XP:
-                pv = marker->GetWorldPosition();
-                m_errorScore = (pv.x - value);
-                break;
-            case YP:
-                pv = marker->GetWorldPosition();
-                m_errorScore = (pv.y - value);
-                break;
-            case ZP:
-                pv = marker->GetWorldPosition();
-                m_errorScore = (pv.z - value);
-                break;
-            case XV:
-                pv = marker->GetWorldLinearVelocity();
-                m_errorScore = (pv.x - value);
-                break;
-            case YV:
-                pv = marker->GetWorldLinearVelocity();
-                m_errorScore = (pv.y - value);
-                break;
-            case ZV:
-                pv = marker->GetWorldLinearVelocity();
-                m_errorScore = (pv.z - value);
-                break;
-            default:
-                std::cerr << "DataTargetScalar::GetMatchValue error in " << name() << " unknown DataType " << m_DataType << "\n";
-            }
-            break;
-        }
-        if ((hingeJoint = dynamic_cast<HingeJoint *>(GetTarget())) != nullptr)
-        {
-            hingeJoint->GetHingeAnchor(result);
-            switch (m_DataType)
-            {
-            case XP:
-                m_errorScore = (result[0] - value);
-                break;
-            case YP:
-                m_errorScore = (result[1] - value);
-                break;
-            case ZP:
-                m_errorScore = (result[2] - value);
-                break;
-            case Angle:
-                m_errorScore = (hingeJoint->GetHingeAngle() - value);
-                break;
-            case XF:
-                force = hingeJoint->GetFeedback()->f1[0];
-                m_errorScore = (force - value);
-                break;
-            case YF:
-                force = hingeJoint->GetFeedback()->f1[2];
-                m_errorScore = (force - value);
-                break;
-            case ZF:
-                force = hingeJoint->GetFeedback()->f1[3];
-                m_errorScore = (force - value);
-                break;
-            case Force:
-                pv.Set(hingeJoint->GetFeedback()->f1);
-                force = pv.Magnitude();
-                m_errorScore = (force - value);
-                break;
-            default:
-                std::cerr << "DataTargetScalar::GetMatchValue error in " << name() << " unknown DataType " << m_DataType << "\n";
-            }
-            break;
-        }
-        if ((ballJoint = dynamic_cast<BallJoint *>(GetTarget())) != nullptr)
-        {
-            ballJoint->GetBallAnchor(result);
-            switch (m_DataType)
-            {
-            case XP:
-                m_errorScore = (result[0] - value);
-                break;
-            case YP:
-                m_errorScore = (result[1] - value);
-                break;
-            case ZP:
-                m_errorScore = (result[2] - value);
-                break;
-            case XF:
-                force = ballJoint->GetFeedback()->f1[0];
-                m_errorScore = (force - value);
-                break;
-            case YF:
-                force = ballJoint->GetFeedback()->f1[2];
-                m_errorScore = (force - value);
-                break;
-            case ZF:
-                force = ballJoint->GetFeedback()->f1[3];
-                m_errorScore = (force - value);
-                break;
-            case Force:
-                pv.Set(ballJoint->GetFeedback()->f1);
-                force = pv.Magnitude();
-                m_errorScore = (force - value);
-                break;
-            default:
-                std::cerr << "DataTargetScalar::GetMatchValue error in " << name() << " unknown DataType " << m_DataType << "\n";
-            }
-            break;
-        }
-        if ((universalJoint = dynamic_cast<UniversalJoint *>(GetTarget())) != nullptr)
-        {
-            universalJoint->GetUniversalAnchor(result);
-            switch (m_DataType)
-            {
-            case XP:
-                m_errorScore = (result[0] - value);
-                break;
-            case YP:
-                m_errorScore = (result[1] - value);
-                break;
-            case ZP:
-                m_errorScore = (result[2] - value);
-                break;
-            case XF:
-                force = universalJoint->GetFeedback()->f1[0];
-                m_errorScore = (force - value);
-                break;
-            case YF:
-                force = universalJoint->GetFeedback()->f1[2];
-                m_errorScore = (force - value);
-                break;
-            case ZF:
-                force = universalJoint->GetFeedback()->f1[3];
-                m_errorScore = (force - value);
-                break;
-            case Force:
-                pv.Set(universalJoint->GetFeedback()->f1);
-                force = pv.Magnitude();
-                m_errorScore = (force - value);
-                break;
-            default:
-                std::cerr << "DataTargetScalar::GetMatchValue error in " << name() << " unknown DataType " << m_DataType << "\n";
-            }
-            break;
-        }
-        if ((geom = dynamic_cast<Geom *>(GetTarget())) != nullptr)
-        {
-            switch (m_DataType)
-            {
-            case Q0:
-                geom->GetWorldQuaternion(q);
-                m_errorScore = (q[0] - value);
-                break;
-            case Q1:
-                geom->GetWorldQuaternion(q);
-                m_errorScore = (q[1] - value);
-                break;
-            case Q2:
-                geom->GetWorldQuaternion(q);
-                m_errorScore = (q[2] - value);
-                break;
-            case Q3:
-                geom->GetWorldQuaternion(q);
-                m_errorScore = (q[3] - value);
-                break;
-            case XP:
-                geom->GetWorldPosition(result);
-                m_errorScore = (result[0] - value);
-                break;
-            case YP:
-                geom->GetWorldPosition(result);
-                m_errorScore = (result[1] - value);
-                break;
-            case ZP:
-                geom->GetWorldPosition(result);
-                m_errorScore = (result[2] - value);
-                break;
-            case XF:
-                contactList = geom->GetContactList();
-                force = 0;
-                for (auto &&it : *contactList) force += it->GetJointFeedback()->f1[0];
-                m_errorScore = (force - value);
-                break;
-            case YF:
-                contactList = geom->GetContactList();
-                force = 0;
-                for (auto &&it : *contactList) force += it->GetJointFeedback()->f1[1];
-                m_errorScore = (force - value);
-                break;
-            case ZF:
-                contactList = geom->GetContactList();
-                force = 0;
-                for (auto &&it : *contactList) force += it->GetJointFeedback()->f1[2];
-                m_errorScore = (force - value);
-                break;
-            case Force:
-                contactList = geom->GetContactList();
-                force = 0;
-                for (auto &&it : *contactList) { pv.Set(it->GetJointFeedback()->f1); force += pv.Magnitude(); }
-                m_errorScore = (force - value);
-                break;
-            default:
-                std::cerr << "DataTargetScalar::GetMatchValue error in " << name() << " unknown DataType " << m_DataType << "\n";
-            }
-            break;
-        }
-        if ((tegotaeDriver = dynamic_cast<TegotaeDriver *>(GetTarget())) != nullptr)
-        {
-            pgd::Vector3 errorVector;
-            switch (m_DataType)
-            {
-            case DriverError:
-                errorVector = tegotaeDriver->localErrorVector();
-                m_errorScore = errorVector.Magnitude() - value;
-                break;
-            default:
-                std::cerr << "DataTargetScalar::GetMatchValue error in " << name() << " unknown DataType " << m_DataType << "\n";
-            }
-            break;
-        }
-        if (GetTarget() == nullptr)
-        {
-            switch(m_DataType)
-            {
-            case MetabolicEnergy:
-                m_errorScore = (simulation()->GetMetabolicEnergy() - value);
-                break;
-            case MechanicalEnergy:
-                m_errorScore = (simulation()->GetMechanicalEnergy() - value);
-                break;
-            case Time:
-                m_errorScore = (simulation()->GetTime() - value);
-                break;
-            case DeltaTime:
-                m_errorScore = (simulation()->GetTimeIncrement() - value);
-                break;
-            default:
-                std::cerr << "DataTargetScalar::GetMatchValue error in " << name() << " unknown DataType " << m_DataType << "\n";
-            }
-            break;
-        }
-        std::cerr << "DataTargetScalar::GetMatchValue error in " << name() << " unknown DataTarget " << m_DataType << "\n";
-        break;
+        m_errorScore = m_accessor(m_Target, simulation()) - value;
+    }
+    else
+    {
+        m_errorScore = 0;
+        std::cerr << "DataTargetScalar::GetMatchValue error in " << name() << " unknown DataType " << m_DataType << "\n";
     }
 
     switch(std::fpclassify(m_errorScore))
@@ -418,28 +91,151 @@ double DataTargetScalar::calculateErrorScore(double value)
 
 
 
-// returns the difference between the target actual value and the desired value (actual - desired)
-double DataTargetScalar::calculateError(double time)
+// this function works out how to get the value from the target once rather than every time the error is calculated
+// m_accessor is left as nullptr if the target and data type combination is not supported
+void DataTargetScalar::ResolveAccessor()
 {
-    size_t index, indexNext;
-    auto lowerBound = std::lower_bound(targetTimeList()->begin(), targetTimeList()->end(), time);
-    auto upperBound = std::upper_bound(targetTimeList()->begin(), targetTimeList()->end(), time);
-    if (lowerBound == targetTimeList()->begin()) // time <= lowest value in the list
+    m_accessor = nullptr;
+    m_accessorValid = true;
+
+    if (dynamic_cast<Body *>(m_Target))
     {
-        index = 0;
-        indexNext = index;
+        switch (m_DataType)
+        {
+        case Q0: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetQuaternion()[0]; }; break;
+        case Q1: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetQuaternion()[1]; }; break;
+        case Q2: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetQuaternion()[2]; }; break;
+        case Q3: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetQuaternion()[3]; }; break;
+        case XP: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetPosition()[0]; }; break;
+        case YP: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetPosition()[1]; }; break;
+        case ZP: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetPosition()[2]; }; break;
+        case XV: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetLinearVelocity()[0]; }; break;
+        case YV: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetLinearVelocity()[1]; }; break;
+        case ZV: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetLinearVelocity()[2]; }; break;
+        case XRV: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetAngularVelocity()[0]; }; break;
+        case YRV: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetAngularVelocity()[1]; }; break;
+        case ZRV: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Body *>(target)->GetAngularVelocity()[2]; }; break;
+        default: break;
+        }
+        return;
     }
-    else if (upperBound == targetTimeList()->end()) // time > highest value in the list
+
+    if (dynamic_cast<Marker *>(m_Target))
     {
-        index = targetTimeList()->size() - 1;
-        indexNext = index;
+        switch (m_DataType)
+        {
+        case Q0: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Marker *>(target)->GetWorldQuaternion().n; }; break;
+        case Q1: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Marker *>(target)->GetWorldQuaternion().x; }; break;
+        case Q2: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Marker *>(target)->GetWorldQuaternion().y; }; break;
+        case Q3: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Marker *>(target)->GetWorldQuaternion().z; }; break;
+        case XP: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Marker *>(target)->GetWorldPosition().x; }; break;
+        case YP: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Marker *>(target)->GetWorldPosition().y; }; break;
+        case ZP: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Marker *>(target)->GetWorldPosition().z; }; break;
+        case XV: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Marker *>(target)->GetWorldLinearVelocity().x; }; break;
+        case YV: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Marker *>(target)->GetWorldLinearVelocity().y; }; break;
+        case ZV: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<Marker *>(target)->GetWorldLinearVelocity().z; }; break;
+        default: break;
+        }
+        return;
     }
-    else
+
+    if (dynamic_cast<HingeJoint *>(m_Target) || dynamic_cast<BallJoint *>(m_Target) || dynamic_cast<UniversalJoint *>(m_Target))
+    {
+        // the force components are the same for all the joint types
+        switch (m_DataType)
+        {
+        case XF: m_accessor = [](NamedObject *target, Simulation *) { return double(static_cast<Joint *>(target)->GetFeedback()->f1[0]); }; return;
+        case YF: m_accessor = [](NamedObject *target, Simulation *) { return double(static_cast<Joint *>(target)->GetFeedback()->f1[1]); }; return;
+        case ZF: m_accessor = [](NamedObject *target, Simulation *) { return double(static_cast<Joint *>(target)->GetFeedback()->f1[2]); }; return;
+        case Force: m_accessor = [](NamedObject *target, Simulation *) { return pgd::Vector3(static_cast<Joint *>(target)->GetFeedback()->f1).Magnitude(); }; return;
+        default: break;
+        }
+    }
+
+    if (dynamic_cast<HingeJoint *>(m_Target))
+    {
+        switch (m_DataType)
+        {
+        case XP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<HingeJoint *>(target)->GetHingeAnchor(result); return double(result[0]); }; break;
+        case YP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<HingeJoint *>(target)->GetHingeAnchor(result); return double(result[1]); }; break;
+        case ZP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<HingeJoint *>(target)->GetHingeAnchor(result); return double(result[2]); }; break;
+        case Angle: m_accessor = [](NamedObject *target, Simulation *) { return static_cast<HingeJoint *>(target)->GetHingeAngle(); }; break;
+        default: break;
+        }
+        return;
+    }
+
+    if (dynamic_cast<BallJoint *>(m_Target))
+    {
+        switch (m_DataType)
+        {
+        case XP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<BallJoint *>(target)->GetBallAnchor(result); return double(result[0]); }; break;
+        case YP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<BallJoint *>(target)->GetBallAnchor(result); return double(result[1]); }; break;
+        case ZP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<BallJoint *>(target)->GetBallAnchor(result); return double(result[2]); }; break;
+        default: break;
+        }
+        return;
+    }
+
+    if (dynamic_cast<UniversalJoint *>(m_Target))
+    {
+        switch (m_DataType)
+        {
+        case XP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<UniversalJoint *>(target)->GetUniversalAnchor(result); return double(result[0]); }; break;
+        case YP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<UniversalJoint *>(target)->GetUniversalAnchor(result); return double(result[1]); }; break;
+        case ZP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<UniversalJoint *>(target)->GetUniversalAnchor(result); return double(result[2]); }; break;
+        default: break;
+        }
+        return;
+    }
+
+    if (dynamic_cast<Geom *>(m_Target))
+    {
+        switch (m_DataType)
+        {
+        case Q0: m_accessor = [](NamedObject *target, Simulation *) { dQuaternion q; static_cast<Geom *>(target)->GetWorldQuaternion(q); return double(q[0]); }; break;
+        case Q1: m_accessor = [](NamedObject *target, Simulation *) { dQuaternion q; static_cast<Geom *>(target)->GetWorldQuaternion(q); return double(q[1]); }; break;
+        case Q2: m_accessor = [](NamedObject *target, Simulation *) { dQuaternion q; static_cast<Geom *>(target)->GetWorldQuaternion(q); return double(q[2]); }; break;
+        case Q3: m_accessor = [](NamedObject *target, Simulation *) { dQuaternion q; static_cast<Geom *>(target)->GetWorldQuaternion(q); return double(q[3]); }; break;
+        case XP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<Geom *>(target)->GetWorldPosition(result); return double(result[0]); }; break;
+        case YP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<Geom *>(target)->GetWorldPosition(result); return double(result[1]); }; break;
+        case ZP: m_accessor = [](NamedObject *target, Simulation *) { dVector3 result; static_cast<Geom *>(target)->GetWorldPosition(result); return double(result[2]); }; break;
+        case XF: m_accessor = [](NamedObject *target, Simulation *simulation) { return simulation->GetGeomContactAggregate(static_cast<Geom *>(target)).force.x; }; break;
+        case YF: m_accessor = [](NamedObject *target, Simulation *simulation) { return simulation->GetGeomContactAggregate(static_cast<Geom *>(target)).force.y; }; break;
+        case ZF: m_accessor = [](NamedObject *target, Simulation *simulation) { return simulation->GetGeomContactAggregate(static_cast<Geom *>(target)).force.z; }; break;
+        case Force: m_accessor = [](NamedObject *target, Simulation *simulation) { return simulation->GetGeomContactAggregate(static_cast<Geom *>(target)).forceMagnitudeSum; }; break;
+        default: break;
+        }
+        return;
+    }
+
+    if (dynamic_cast<TegotaeDriver *>(m_Target))
     {
-        index = std::distance(targetTimeList()->begin(), lowerBound) - 1; // subtracting 1 because lower bound gives an index 1 higher than expected (IMO)
-        indexNext = std::min(index + 1, targetTimeList()->size() - 1);
+        if (m_DataType == DriverError) m_accessor = [](NamedObject *target, Simulation *) { return static_cast<TegotaeDriver *>(target)->localErrorVector().Magnitude(); };
+        return;
     }
 
+    if (m_Target == nullptr)
+    {
+        switch (m_DataType)
+        {
+        case MetabolicEnergy: m_accessor = [](NamedObject *, Simulation *simulation) { return simulation->GetMetabolicEnergy(); }; break;
+        case MechanicalEnergy: m_accessor = [](NamedObject *, Simulation *simulation) { return simulation->GetMechanicalEnergy(); }; break;
+        case Time: m_accessor = [](NamedObject *, Simulation *simulation) { return simulation->GetTime(); }; break;
+        case DeltaTime: m_accessor = [](NamedObject *, Simulation *simulation) { return simulation->GetTimeIncrement(); }; break;
+        default: break;
+        }
+        return;
+    }
+}
+
+
+// returns the difference between the target actual value and the desired value (actual - desired)
+double DataTargetScalar::calculateError(double time)
+{
+    size_t index, indexNext;
+    bracketIndices(time, &index, &indexNext);
+
     double value = GSUtil::Interpolate((*targetTimeList())[size_t(index)], m_ValueList[size_t(index)], (*targetTimeList())[indexNext], m_ValueList[indexNext], time);
     return calculateErrorScore(value);
 }
@@ -567,6 +363,7 @@ std::string *DataTargetScalar::createFromAttributes()
     for (auto &&token : targetValuesTokens) m_ValueList.push_back(GSUtil::Double(token));
 
     if (m_Target) setUpstreamObjects({m_Target});
+    ResolveAccessor();
     return nullptr;
 }
 
@@ -584,6 +381,7 @@ void DataTargetScalar::appendToAttributes()
 void DataTargetScalar::SetTarget(NamedObject *target)
 {
     m_Target = target;
+    m_accessorValid = false;
 }
 
 NamedObject *DataTargetScalar::GetTarget()
@@ -17,6 +17,7 @@
 #include <set>
 
 class NamedObject;
+class Simulation;
 
 class DataTargetScalar: public DataTarget
 {
@@ -32,7 +33,7 @@ public:
     void SetTarget(NamedObject *target);
     NamedObject *GetTarget();
 
-    void SetDataType(DataType dataType) { m_DataType = dataType; }
+    void SetDataType(DataType dataType) { m_DataType = dataType; m_accessorValid = false; }
     DataType GetDataType() { return m_DataType; }
 
     virtual std::string dumpToString() override;
@@ -45,6 +46,7 @@ public:
 
 private:
     double calculateErrorScore(double value);
+    void ResolveAccessor();
 
     NamedObject *m_Target = nullptr;
     DataType m_DataType = XP;
@@ -52,6 +54,11 @@ private:
 
     std::vector<double> m_ValueList;
     double m_errorScore = 0;
+
+    // the function that gets the value for this target and data type is only worked out once
+    typedef double (*Accessor)(NamedObject *target, Simulation *simulation);
+    Accessor m_accessor = nullptr;
+    bool m_accessorValid = false;
 };
 
 #endif // DATATARGETSCALAR_H
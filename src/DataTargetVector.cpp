@@ -34,131 +34,59 @@ DataTargetVector::DataTargetVector()
 // in this case this is the euclidean distance between the two vectors
 double DataTargetVector::calculateError(size_t valueListIndex)
 {
-    const double *r;
-    Body *body;
-    Geom *geom;
-    HingeJoint *hingeJoint;
-    BallJoint *ballJoint;
-    UniversalJoint *universalJoint;
-    Marker *marker;
-    double err = 0;
-    dVector3 v;
     if (valueListIndex >= m_VValueList.size())
     {
         std::cerr << "Warning: DataTargetVector::GetMatchValue valueListIndex out of range\n";
         return 0;
     }
-
-    if ((body = dynamic_cast<Body *>(GetTarget())) != nullptr)
-    {
-        r = body->GetPosition();
-        err = (pgd::Vector3(r[0], r[1], r[2]) - m_VValueList[size_t(valueListIndex)]).Magnitude();
-    }
-    else if ((geom = dynamic_cast<Geom *>(GetTarget())) != nullptr)
-    {
-        geom->GetWorldPosition(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - m_VValueList[size_t(valueListIndex)]).Magnitude();
-    }
-    else if ((hingeJoint = dynamic_cast<HingeJoint *>(GetTarget())) != nullptr)
-    {
-        hingeJoint->GetHingeAnchor(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - m_VValueList[size_t(valueListIndex)]).Magnitude();
-   }
-    else if ((ballJoint = dynamic_cast<BallJoint *>(GetTarget())) != nullptr)
-    {
-        ballJoint->GetBallAnchor(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - m_VValueList[size_t(valueListIndex)]).Magnitude();
-   }
-    else if ((universalJoint = dynamic_cast<UniversalJoint *>(GetTarget())) != nullptr)
-    {
-        universalJoint->GetUniversalAnchor(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - m_VValueList[size_t(valueListIndex)]).Magnitude();
-    }
-    else if ((marker = dynamic_cast<Marker *>(GetTarget())) != nullptr)
-    {
-        pgd::Vector3 vec = marker->GetWorldPosition();
-        err = (vec - m_VValueList[size_t(valueListIndex)]).Magnitude();
-    }
-    else
+    if (!m_accessorValid) ResolveAccessor();
+    if (!m_accessor)
     {
         std::cerr << "DataTargetVector target missing error " << name() << "\n";
+        return 0;
     }
-    return err;
+    return (m_accessor(m_Target) - m_VValueList[valueListIndex]).Magnitude();
 }
 
 // returns the degree of match to the stored values
 // in this case this is the euclidean distance between the two vectors
 double DataTargetVector::calculateError(double time)
 {
-    const double *r;
-    Body *body;
-    Geom *geom;
-    HingeJoint *hingeJoint;
-    BallJoint *ballJoint;
-    UniversalJoint *universalJoint;
-    Marker *marker;
-    double err = 0;
-    dVector3 v;
-
     size_t index, indexNext;
-    auto lowerBound = std::lower_bound(targetTimeList()->begin(), targetTimeList()->end(), time);
-    auto upperBound = std::upper_bound(targetTimeList()->begin(), targetTimeList()->end(), time);
-    if (lowerBound == targetTimeList()->begin()) // time <= lowest value in the list
-    {
-        index = 0;
-        indexNext = index;
-    }
-    else if (upperBound == targetTimeList()->end()) // time > highest value in the list
-    {
-        index = targetTimeList()->size() - 1;
-        indexNext = index;
-    }
-    else
-    {
-        index = std::distance(targetTimeList()->begin(), lowerBound) - 1; // subtracting 1 because lower bound gives an index 1 higher than expected (IMO)
-        indexNext = std::min(index + 1, targetTimeList()->size() - 1);
-    }
+    bracketIndices(time, &index, &indexNext);
 
     double interpX = GSUtil::Interpolate((*targetTimeList())[size_t(index)], m_VValueList[size_t(index)].x, (*targetTimeList())[size_t(indexNext)], m_VValueList[size_t(indexNext)].x, time);
     double interpY = GSUtil::Interpolate((*targetTimeList())[size_t(index)], m_VValueList[size_t(index)].y, (*targetTimeList())[size_t(indexNext)], m_VValueList[size_t(indexNext)].y, time);
     double interpZ = GSUtil::Interpolate((*targetTimeList())[size_t(index)], m_VValueList[size_t(index)].z, (*targetTimeList())[size_t(indexNext)], m_VValueList[size_t(indexNext)].z, time);
     pgd::Vector3 interpolatedTarget(interpX, interpY, interpZ);
 
-    if ((body = dynamic_cast<Body *>(GetTarget())) != nullptr)
-    {
-        r = body->GetPosition();
-        err = (pgd::Vector3(r[0], r[1], r[2]) - interpolatedTarget).Magnitude();
-    }
-    else if ((geom = dynamic_cast<Geom *>(GetTarget())) != nullptr)
-    {
-        geom->GetWorldPosition(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - interpolatedTarget).Magnitude();
-    }
-    else if ((hingeJoint = dynamic_cast<HingeJoint *>(GetTarget())) != nullptr)
-    {
-        hingeJoint->GetHingeAnchor(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - interpolatedTarget).Magnitude();
-   }
-    else if ((ballJoint = dynamic_cast<BallJoint *>(GetTarget())) != nullptr)
-    {
-        ballJoint->GetBallAnchor(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - interpolatedTarget).Magnitude();
-   }
-    else if ((universalJoint = dynamic_cast<UniversalJoint *>(GetTarget())) != nullptr)
-    {
-        universalJoint->GetUniversalAnchor(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - interpolatedTarget).Magnitude();
-    }
-    else if ((marker = dynamic_cast<Marker *>(GetTarget())) != nullptr)
-    {
-        pgd::Vector3 vec = marker->GetWorldPosition();
-        err = (vec - interpolatedTarget).Magnitude();
-    }
-    else
+    if (!m_accessorValid) ResolveAccessor();
+    if (!m_accessor)
     {
         std::cerr << "DataTargetVector target missing error " << name() << "\n";
+        return 0;
     }
-    return err;
+    return (m_accessor(m_Target) - interpolatedTarget).Magnitude();
+}
+
+// this function works out how to get the position from the target once rather than every time the error is calculated
+// m_accessor is left as nullptr if the target type is not supported
+void DataTargetVector::ResolveAccessor()
+{
+    m_accessor = nullptr;
+    m_accessorValid = true;
+    if (dynamic_cast<Body *>(m_Target))
+        m_accessor = [](NamedObject *target) { return pgd::Vector3(static_cast<Body *>(target)->GetPosition()); };
+    else if (dynamic_cast<Geom *>(m_Target))
+        m_accessor = [](NamedObject *target) { dVector3 v; static_cast<Geom *>(target)->GetWorldPosition(v); return pgd::Vector3(v); };
+    else if (dynamic_cast<HingeJoint *>(m_Target))
+        m_accessor = [](NamedObject *target) { dVector3 v; static_cast<HingeJoint *>(target)->GetHingeAnchor(v); return pgd::Vector3(v); };
+    else if (dynamic_cast<BallJoint *>(m_Target))
+        m_accessor = [](NamedObject *target) { dVector3 v; static_cast<BallJoint *>(target)->GetBallAnchor(v); return pgd::Vector3(v); };
+    else if (dynamic_cast<UniversalJoint *>(m_Target))
+        m_accessor = [](NamedObject *target) { dVector3 v; static_cast<UniversalJoint *>(target)->GetUniversalAnchor(v); return pgd::Vector3(v); };
+    else if (dynamic_cast<Marker *>(m_Target))
+        m_accessor = [](NamedObject *target) { return static_cast<Marker *>(target)->GetWorldPosition(); };
 }
 
 std::string DataTargetVector::dumpToString()
@@ -171,60 +99,18 @@ std::string DataTargetVector::dumpToString()
         setFirstDump(false);
         ss << "Time\tTargetX\tTargetY\tTargetZ\tActualX\tActualY\tActualZ\tDistance\n";
     }
-    Body *body;
-    Geom *geom;
-    HingeJoint *hingeJoint;
-    BallJoint *ballJoint;
-    UniversalJoint *universalJoint;
-    Marker *marker;
-    const double *r = nullptr;
-    double err = 0;
-    dVector3 v;
 
-    size_t valueListIndex = 0;
-    auto lowerBounds = std::lower_bound(targetTimeList()->begin(), targetTimeList()->end(), simulation()->GetTime());
-    if (lowerBounds != targetTimeList()->end()) valueListIndex = std::distance(targetTimeList()->begin(), lowerBounds);
+    size_t valueListIndex = lowerBoundIndex(simulation()->GetTime());
+    if (valueListIndex >= targetTimeList()->size()) valueListIndex = 0;
 
-    if ((body = dynamic_cast<Body *>(GetTarget())) != nullptr)
-    {
-        r = body->GetPosition();
-        err = (pgd::Vector3(r[0], r[1], r[2]) - m_VValueList[size_t(valueListIndex)]).Magnitude();
-    }
-    else if ((geom = dynamic_cast<Geom *>(GetTarget())) != nullptr)
-    {
-        geom->GetWorldPosition(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - m_VValueList[size_t(valueListIndex)]).Magnitude();
-        r = v;
-    }
-    else if ((hingeJoint = dynamic_cast<HingeJoint *>(GetTarget())) != nullptr)
-    {
-        hingeJoint->GetHingeAnchor(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - m_VValueList[size_t(valueListIndex)]).Magnitude();
-        r = v;
-    }
-    else if ((ballJoint = dynamic_cast<BallJoint *>(GetTarget())) != nullptr)
-    {
-        ballJoint->GetBallAnchor(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - m_VValueList[size_t(valueListIndex)]).Magnitude();
-        r = v;
-    }
-    else if ((universalJoint = dynamic_cast<UniversalJoint *>(GetTarget())) != nullptr)
-    {
-        universalJoint->GetUniversalAnchor(v);
-        err = (pgd::Vector3(v[0], v[1], v[2]) - m_VValueList[size_t(valueListIndex)]).Magnitude();
-        r = v;
-    }
-    else if ((marker = dynamic_cast<Marker *>(GetTarget())) != nullptr)
-    {
-        pgd::Vector3 vec = marker->GetWorldPosition();
-        v[0] = vec.x; v[1] = vec.y; v[2] = vec.z;
-        err = (pgd::Vector3(v[0], v[1], v[2]) - m_VValueList[size_t(valueListIndex)]).Magnitude();
-        r = v;
-    }
+    if (!m_accessorValid) ResolveAccessor();
+    pgd::Vector3 r;
+    if (m_accessor) r = m_accessor(m_Target);
+    double err = (r - m_VValueList[size_t(valueListIndex)]).Magnitude();
 
     ss << simulation()->GetTime() <<
           "\t" << m_VValueList[size_t(valueListIndex)].x << "\t" << m_VValueList[size_t(valueListIndex)].y << "\t" << m_VValueList[size_t(valueListIndex)].z <<
-          "\t" << r[0] << "\t" << r[1] << "\t" << r[2] <<
+          "\t" << r.x << "\t" << r.y << "\t" << r.z <<
           "\t" << err <<
           "\n";
     return ss.str();
@@ -233,6 +119,7 @@ std::string DataTargetVector::dumpToString()
 void DataTargetVector::SetTarget(NamedObject *target)
 {
     m_Target = target;
+    m_accessorValid = false;
 }
 
 NamedObject *DataTargetVector::GetTarget()
@@ -291,6 +178,7 @@ std::string *DataTargetVector::createFromAttributes()
     }
 
     if (m_Target) setUpstreamObjects({m_Target});
+    ResolveAccessor();
     return nullptr;
 }
 
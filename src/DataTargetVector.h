@@ -32,10 +32,16 @@ public:
     virtual double calculateError(double time);
 
 private:
+    void ResolveAccessor();
 
     NamedObject *m_Target = nullptr;
     std::vector<pgd::Vector3> m_VValueList;
 
+    // the function that gets the position of the target is only worked out once
+    typedef pgd::Vector3 (*Accessor)(NamedObject *target);
+    Accessor m_accessor = nullptr;
+    bool m_accessorValid = false;
+
 };
 
 #endif // DATATARGETVECTOR_H
@@ -33,10 +33,42 @@ void Drivable::ReceiveData(double receivedData, int64_t receiveDataStepCount)
 
 double Drivable::dataSum() const
 {
-    return m_dataSum;
+    if (m_inputList.size() == 0) return m_dataSum;
+    return m_inputSum + m_dataSum;
 }
 
 void Drivable::setDataSum(double dataSum)
 {
     m_dataSum = dataSum;
 }
+
+size_t Drivable::AddInput()
+{
+    m_inputList.push_back(0);
+    return m_inputList.size() - 1;
+}
+
+void Drivable::ClearInputs()
+{
+    m_inputList.clear();
+    m_inputSum = 0;
+    m_lastDataSumValid = false;
+}
+
+// the sum is recalculated from scratch so that it is exactly the same as summing the values with ReceiveData
+void Drivable::SetInput(size_t index, double value)
+{
+    m_inputList[index] = value;
+    m_inputSum = 0;
+    for (auto &&input : m_inputList) m_inputSum += input;
+}
+
+// returns true if the summed input is different from the last time this function was called
+bool Drivable::dataSumChanged()
+{
+    double sum = dataSum();
+    if (m_lastDataSumValid && sum == m_lastDataSum) return false;
+    m_lastDataSum = sum;
+    m_lastDataSumValid = true;
+    return true;
+}
@@ -11,6 +11,7 @@
 #define DRIVABLE_H
 
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 #include <climits>
 
@@ -25,13 +26,25 @@ public:
 
     virtual void ReceiveData(double receivedData, int64_t receiveDataStepCount);
 
+    // drivers that only send values when they change use an input slot so that the last value is remembered
+    size_t AddInput();
+    void ClearInputs();
+    void SetInput(size_t index, double value);
+
 protected:
     double dataSum() const;
     void setDataSum(double dataSum);
+    bool dataSumChanged();
 
 private:
     double m_dataSum = 0;
     int64_t m_receiveDataStepCount = INT_MIN;
+
+    std::vector<double> m_inputList;
+    double m_inputSum = 0;
+
+    double m_lastDataSum = 0;
+    bool m_lastDataSumValid = false;
 };
 
 #endif // DRIVABLE_H
@@ -15,10 +15,13 @@
 #include "Simulation.h"
 #include "PGDMath.h"
 #include "GSUtil.h"
+#include "Global.h"
 
 #include "pystring.h"
 
 #include <sstream>
+#include <cmath>
+#include <algorithm>
 
 using namespace std::string_literals;
 
@@ -43,12 +46,30 @@ Drivable *Driver::GetTarget(const std::string &name)
     else return it->second;
 }
 
+// most drivers are piecewise constant so the value is only sent to the targets when it changes
+// this relies on the targets remembering the value in their input slot so LinkTargetInputs must have been called
 void Driver::SendData()
 {
-    for (auto &&it : m_targetList)
+    double value = Clamp(m_value);
+    if (m_targetInputIndexList.size() != m_targetVector.size())
     {
-        it.second->ReceiveData(Clamp(m_value), simulation()->GetStepCount());
+        for (auto &&it : m_targetVector) it->ReceiveData(value, simulation()->GetStepCount());
+        return;
     }
+    if (m_lastSentValid && value == m_lastSentValue) return;
+    for (size_t i = 0; i < m_targetVector.size(); i++) m_targetVector[i]->SetInput(m_targetInputIndexList[i], value);
+    m_lastSentValue = value;
+    m_lastSentValid = true;
+}
+
+// this gets an input slot from each target and forces the next SendData to update the targets
+// the targets need to have had ClearInputs called before the first driver is linked
+void Driver::LinkTargetInputs()
+{
+    m_targetInputIndexList.clear();
+    m_targetInputIndexList.reserve(m_targetVector.size());
+    for (auto &&it : m_targetVector) m_targetInputIndexList.push_back(it->AddInput());
+    m_lastSentValid = false;
 }
 
 int Driver::AddTarget(Drivable *target)
@@ -57,6 +78,10 @@ int Driver::AddTarget(Drivable *target)
     NamedObject *object = dynamic_cast<NamedObject *>(target);
     if (object == nullptr) return __LINE__;
     m_targetList[object->name()] = target;
+    m_targetVector.clear();
+    m_targetVector.reserve(m_targetList.size());
+    for (auto &&it : m_targetList) m_targetVector.push_back(it.second);
+    m_targetInputIndexList.clear();
     return 0;
 }
 
@@ -99,6 +124,8 @@ std::string *Driver::createFromAttributes()
 //        return lastErrorPtr();
 //    }
     m_targetList.clear();
+    m_targetVector.clear();
+    m_targetInputIndexList.clear();
     std::vector<NamedObject *> upstreamObjects;
     upstreamObjects.reserve(targetNames.size());
     for (size_t i = 0; i < targetNames.size(); i++)
@@ -137,6 +164,8 @@ std::string *Driver::createFromAttributes()
         this->setInterp(GSUtil::Bool(buf));
     }
 
+    if (findAttribute("ControlPeriod"s, &buf)) this->setControlPeriod(GSUtil::Double(buf));
+
     setUpstreamObjects(std::move(upstreamObjects));
     return nullptr;
 }
@@ -162,6 +191,7 @@ void Driver::appendToAttributes()
     double doubleList[2] = { m_minValue, m_maxValue };
     setAttribute("DriverRange"s, *GSUtil::ToString(doubleList, 2, &buf));
     setAttribute("LinearInterpolation"s, *GSUtil::ToString(Interp(), &buf));
+    if (m_controlPeriod >= 0) setAttribute("ControlPeriod"s, *GSUtil::ToString(m_controlPeriod, &buf)); // otherwise the global value is used
 }
 
 double Driver::MinValue() const
@@ -219,3 +249,39 @@ void Driver::setValue(double value)
     m_value = value;
 }
 
+double Driver::controlPeriod() const
+{
+    return m_controlPeriod;
+}
+
+void Driver::setControlPeriod(double controlPeriod)
+{
+    m_controlPeriod = controlPeriod;
+}
+
+// the number of physics steps between driver updates
+int64_t Driver::controlInterval() const
+{
+    double controlPeriod = m_controlPeriod >= 0 ? m_controlPeriod : simulation()->GetGlobal()->ControlPeriod();
+    if (controlPeriod <= 0) return 1;
+    return std::max(int64_t(1), int64_t(std::llround(controlPeriod / simulation()->GetTimeIncrement())));
+}
+
+// the first update is always at the first step and then every controlInterval steps after that
+int64_t Driver::nextUpdateStepCount() const
+{
+    if (m_lastStepCount < 0) return m_lastStepCount + 1;
+    return m_lastStepCount + controlInterval();
+}
+
+bool Driver::UpdateDue(int64_t stepCount) const
+{
+    return stepCount >= nextUpdateStepCount();
+}
+
+// the time that passes between driver updates
+double Driver::controlTimeIncrement() const
+{
+    return simulation()->GetTimeIncrement() * double(controlInterval());
+}
+
@@ -15,6 +15,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 class Drivable;
 
@@ -30,6 +31,7 @@ public:
 
     virtual void Update() = 0;
     virtual void SendData();
+    void LinkTargetInputs();
 
     virtual std::string dumpToString();
     virtual std::string *createFromAttributes();
@@ -53,14 +55,32 @@ public:
     double value() const;
     void setValue(double value);
 
+    // drivers can be updated less often than the physics and their output is held in between
+    // a negative control period means use the global value and zero means update every step
+    double controlPeriod() const;
+    void setControlPeriod(double controlPeriod);
+    int64_t controlInterval() const;
+    bool UpdateDue(int64_t stepCount) const;
+
+protected:
+    int64_t nextUpdateStepCount() const;
+    double controlTimeIncrement() const;
+
 private:
 
     std::map<std::string, Drivable *> m_targetList;
+
+    // the targets are also stored contiguously for SendData along with the input slot in each target
+    std::vector<Drivable *> m_targetVector;
+    std::vector<size_t> m_targetInputIndexList;
+    double m_lastSentValue = 0;
+    bool m_lastSentValid = false;
     double m_minValue = 0;
     double m_maxValue = 1;
     bool m_interp = false;
     int64_t m_lastStepCount = -1;
     double m_value = 0;
+    double m_controlPeriod = -1;
 };
 
 #endif
@@ -0,0 +1,245 @@
+/*
+ *  DumpCodec.cpp
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+#include "DumpCodec.h"
+
+#include <cstring>
+#include <cmath>
+
+enum DumpCodecMethod : uint8_t { XORMethod = 0, QuantisedMethod = 1 };
+
+// quantised values must fit comfortably in an int64_t so that the differences cannot overflow
+static const double c_maxQuantisedValue = 4.0e18;
+
+// MSB first bit packing
+class BitWriter
+{
+public:
+    BitWriter(std::vector<char> *buffer) : m_buffer(buffer) {}
+    ~BitWriter() { if (m_numBits) m_buffer->push_back(char(m_current << (8 - m_numBits))); }
+    void Write(uint64_t bits, unsigned int numBits)
+    {
+        for (unsigned int i = numBits; i > 0; i--)
+        {
+            m_current = uint8_t((m_current << 1) | ((bits >> (i - 1)) & 1));
+            if (++m_numBits == 8)
+            {
+                m_buffer->push_back(char(m_current));
+                m_current = 0;
+                m_numBits = 0;
+            }
+        }
+    }
+private:
+    std::vector<char> *m_buffer;
+    uint8_t m_current = 0;
+    unsigned int m_numBits = 0;
+};
+
+class BitReader
+{
+public:
+    BitReader(const unsigned char *data, size_t length) : m_data(data), m_length(length) {}
+    bool Read(unsigned int numBits, uint64_t *bits)
+    {
+        if (m_position + numBits > m_length * 8) return false;
+        uint64_t value = 0;
+        for (unsigned int i = 0; i < numBits; i++, m_position++)
+            value = (value << 1) | ((m_data[m_position / 8] >> (7 - m_position % 8)) & 1);
+        *bits = value;
+        return true;
+    }
+    size_t BytesUsed() const { return (m_position + 7) / 8; }
+private:
+    const unsigned char *m_data;
+    size_t m_length;
+    size_t m_position = 0;
+};
+
+static unsigned int CountLeadingZeros(uint64_t x)
+{
+    unsigned int n = 0;
+    for (uint64_t mask = uint64_t(1) << 63; mask && !(x & mask); mask >>= 1) n++;
+    return n;
+}
+
+static unsigned int CountTrailingZeros(uint64_t x)
+{
+    unsigned int n = 0;
+    for (uint64_t mask = 1; mask && !(x & mask); mask <<= 1) n++;
+    return n;
+}
+
+static void AppendVarint(std::vector<char> *buffer, int64_t value)
+{
+    uint64_t zigzag = (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+    while (zigzag >= 0x80)
+    {
+        buffer->push_back(char((zigzag & 0x7f) | 0x80));
+        zigzag >>= 7;
+    }
+    buffer->push_back(char(zigzag));
+}
+
+static bool ExtractVarint(const unsigned char *data, size_t length, size_t *position, int64_t *value)
+{
+    uint64_t zigzag = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+        if (*position >= length) return false;
+        uint8_t byte = data[(*position)++];
+        zigzag |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            *value = int64_t(zigzag >> 1) ^ -int64_t(zigzag & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void DumpCodec::EncodeColumn(const double *values, size_t numValues, double quantum, std::vector<char> *buffer)
+{
+    if (quantum > 0)
+    {
+        size_t start = buffer->size();
+        buffer->push_back(char(QuantisedMethod));
+        if (EncodeQuantised(values, numValues, quantum, buffer)) return;
+        buffer->resize(start);
+    }
+    buffer->push_back(char(XORMethod));
+    EncodeXOR(values, numValues, buffer);
+}
+
+size_t DumpCodec::DecodeColumn(const unsigned char *data, size_t length, size_t numValues, double quantum, double *values)
+{
+    if (length < 1) return 0;
+    size_t used = 0;
+    switch (data[0])
+    {
+    case XORMethod:
+        used = DecodeXOR(data + 1, length - 1, numValues, values);
+        break;
+    case QuantisedMethod:
+        if (quantum <= 0) return 0;
+        used = DecodeQuantised(data + 1, length - 1, numValues, quantum, values);
+        break;
+    default:
+        return 0;
+    }
+    if (used == 0 && numValues) return 0;
+    return used + 1;
+}
+
+void DumpCodec::EncodeXOR(const double *values, size_t numValues, std::vector<char> *buffer)
+{
+    BitWriter bitWriter(buffer);
+    uint64_t previous = 0;
+    unsigned int previousLeading = 65, previousTrailing = 0; // 65 means there is no previous window
+    for (size_t i = 0; i < numValues; i++)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        uint64_t x = bits ^ previous;
+        previous = bits;
+        if (x == 0)
+        {
+            bitWriter.Write(0, 1);
+            continue;
+        }
+        bitWriter.Write(1, 1);
+        unsigned int leading = CountLeadingZeros(x);
+        unsigned int trailing = CountTrailingZeros(x);
+        if (leading > 31) leading = 31; // only 5 bits are available
+        if (previousLeading <= 64 && leading >= previousLeading && trailing >= previousTrailing)
+        {
+            bitWriter.Write(0, 1);
+            bitWriter.Write(x >> previousTrailing, 64 - previousLeading - previousTrailing);
+        }
+        else
+        {
+            unsigned int meaningful = 64 - leading - trailing;
+            bitWriter.Write(1, 1);
+            bitWriter.Write(leading, 5);
+            bitWriter.Write(meaningful - 1, 6);
+            bitWriter.Write(x >> trailing, meaningful);
+            previousLeading = leading;
+            previousTrailing = trailing;
+        }
+    }
+}
+
+size_t DumpCodec::DecodeXOR(const unsigned char *data, size_t length, size_t numValues, double *values)
+{
+    BitReader bitReader(data, length);
+    uint64_t previous = 0;
+    unsigned int previousLeading = 65, previousTrailing = 0;
+    uint64_t bit, field;
+    for (size_t i = 0; i < numValues; i++)
+    {
+        if (!bitReader.Read(1, &bit)) return 0;
+        if (bit)
+        {
+            if (!bitReader.Read(1, &bit)) return 0;
+            if (bit)
+            {
+                if (!bitReader.Read(5, &field)) return 0;
+                previousLeading = unsigned(field);
+                if (!bitReader.Read(6, &field)) return 0;
+                unsigned int meaningful = unsigned(field) + 1;
+                if (previousLeading + meaningful > 64) return 0;
+                previousTrailing = 64 - previousLeading - meaningful;
+            }
+            else if (previousLeading > 64)
+            {
+                return 0;
+            }
+            if (!bitReader.Read(64 - previousLeading - previousTrailing, &field)) return 0;
+            previous ^= field << previousTrailing;
+        }
+        std::memcpy(&values[i], &previous, sizeof(previous));
+    }
+    return bitReader.BytesUsed();
+}
+
+bool DumpCodec::EncodeQuantised(const double *values, size_t numValues, double quantum, std::vector<char> *buffer)
+{
+    int64_t q0 = 0, q1 = 0;
+    for (size_t i = 0; i < numValues; i++)
+    {
+        double scaled = std::round(values[i] / quantum);
+        if (!(std::fabs(scaled) < c_maxQuantisedValue)) return false; // this also catches NaN
+        int64_t q = int64_t(scaled);
+        // the differences are done unsigned so that any overflow wraps and the decoder wraps back
+        if (i == 0) AppendVarint(buffer, q);
+        else if (i == 1) AppendVarint(buffer, int64_t(uint64_t(q) - uint64_t(q1)));
+        else AppendVarint(buffer, int64_t(uint64_t(q) - uint64_t(q1) - (uint64_t(q1) - uint64_t(q0))));
+        q0 = q1;
+        q1 = q;
+    }
+    return true;
+}
+
+size_t DumpCodec::DecodeQuantised(const unsigned char *data, size_t length, size_t numValues, double quantum, double *values)
+{
+    size_t position = 0;
+    int64_t q0 = 0, q1 = 0, value;
+    for (size_t i = 0; i < numValues; i++)
+    {
+        if (!ExtractVarint(data, length, &position, &value)) return 0;
+        int64_t q;
+        if (i == 0) q = value;
+        else if (i == 1) q = int64_t(uint64_t(q1) + uint64_t(value));
+        else q = int64_t(uint64_t(q1) + (uint64_t(q1) - uint64_t(q0)) + uint64_t(value));
+        values[i] = double(q) * quantum;
+        q0 = q1;
+        q1 = q;
+    }
+    return position;
+}
@@ -0,0 +1,45 @@
+/*
+ *  DumpCodec.h
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+// DumpCodec compresses columns of dump values. Consecutive records change smoothly so
+// each column is encoded against the previous value in the column. The first byte of an
+// encoded column says which method was used:
+//
+// 0 XOR:       lossless. Each double is XORed with the previous one and the result is bit packed
+//              as in the Gorilla time series database: a 0 bit for a repeat, otherwise 1 then
+//              either 0 and the meaningful bits in the previous window, or 1, 5 bits of leading
+//              zeros, 6 bits of (length - 1) and the meaningful bits. Padded to a whole byte.
+// 1 QUANTISED: lossy. Values are rounded to integer multiples of the quantum and the first value,
+//              first difference and then the second differences are stored as zigzag varints.
+//
+// A quantum of zero or less, or values that cannot be quantised, use the XOR method.
+
+#ifndef DUMPCODEC_H
+#define DUMPCODEC_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class DumpCodec
+{
+public:
+    // appends the encoded column to buffer
+    static void EncodeColumn(const double *values, size_t numValues, double quantum, std::vector<char> *buffer);
+    // returns the number of bytes used or 0 if the data is invalid
+    static size_t DecodeColumn(const unsigned char *data, size_t length, size_t numValues, double quantum, double *values);
+
+private:
+    static void EncodeXOR(const double *values, size_t numValues, std::vector<char> *buffer);
+    static size_t DecodeXOR(const unsigned char *data, size_t length, size_t numValues, double *values);
+    static bool EncodeQuantised(const double *values, size_t numValues, double quantum, std::vector<char> *buffer);
+    static size_t DecodeQuantised(const unsigned char *data, size_t length, size_t numValues, double quantum, double *values);
+};
+
+#endif // DUMPCODEC_H
@@ -0,0 +1,547 @@
+/*
+ *  DumpFile.cpp
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+#include "DumpFile.h"
+#include "DataFile.h"
+#include "DumpCodec.h"
+
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+using namespace std::string_literals;
+
+static const char c_dumpFileMagic[8] = {'G', 'S', 'D', 'U', 'M', 'P', '0', '1'};
+
+// these functions write and read little-endian values whatever the native byte order
+static void AppendUInt32(std::vector<char> *buffer, uint32_t value)
+{
+    for (size_t i = 0; i < 4; i++) buffer->push_back(char((value >> (8 * i)) & 0xff));
+}
+
+static void AppendDouble(std::vector<char> *buffer, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (size_t i = 0; i < 8; i++) buffer->push_back(char((bits >> (8 * i)) & 0xff));
+}
+
+static void AppendFloat(std::vector<char> *buffer, double value)
+{
+    float f = float(value);
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    AppendUInt32(buffer, bits);
+}
+
+static uint32_t ExtractUInt32(const unsigned char *ptr)
+{
+    return uint32_t(ptr[0]) | (uint32_t(ptr[1]) << 8) | (uint32_t(ptr[2]) << 16) | (uint32_t(ptr[3]) << 24);
+}
+
+static double ExtractDouble(const unsigned char *ptr)
+{
+    uint64_t bits = 0;
+    for (size_t i = 0; i < 8; i++) bits |= uint64_t(ptr[i]) << (8 * i);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static double ExtractFloat(const unsigned char *ptr)
+{
+    uint32_t bits = ExtractUInt32(ptr);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return double(value);
+}
+
+DumpFileWriter::DumpFileWriter()
+{
+}
+
+DumpFileWriter::~DumpFileWriter()
+{
+    Close();
+}
+
+size_t DumpFileWriter::AddObject(const std::string &name, const std::vector<std::string> &channelNames, const std::vector<double> &quantisation)
+{
+    DumpObject dumpObject;
+    dumpObject.name = name;
+    dumpObject.channelNames = channelNames;
+    dumpObject.quantisation = quantisation;
+    dumpObject.quantisation.resize(channelNames.size(), 0);
+    m_objectList.push_back(std::move(dumpObject));
+    return m_objectList.size() - 1;
+}
+
+std::string *DumpFileWriter::Open(const std::string &filename, DumpValueFormat valueFormat)
+{
+    m_valueFormat = valueFormat;
+#if defined _WIN32 && defined _MSC_VER // required because windows and visual studio require wstring for full filename support
+    m_file.open(DataFile::ConvertUTF8ToWide(filename), std::ios::binary);
+#else
+    m_file.open(filename, std::ios::binary);
+#endif
+    if (!m_file.is_open())
+    {
+        m_lastError = "Error opening dump file \""s + filename + "\""s;
+        return &m_lastError;
+    }
+
+    m_writeBuffer.assign(std::begin(c_dumpFileMagic), std::end(c_dumpFileMagic));
+    AppendUInt32(&m_writeBuffer, uint32_t(m_valueFormat));
+    AppendUInt32(&m_writeBuffer, uint32_t(m_objectList.size()));
+    for (auto &&dumpObject : m_objectList)
+    {
+        WriteString(dumpObject.name);
+        AppendUInt32(&m_writeBuffer, uint32_t(dumpObject.channelNames.size()));
+        for (auto &&channelName : dumpObject.channelNames) WriteString(channelName);
+        if (m_valueFormat == DumpValueFormat::Compressed)
+        {
+            for (auto &&quantum : dumpObject.quantisation) AppendDouble(&m_writeBuffer, quantum);
+        }
+        dumpObject.buffer.resize(dumpObject.channelNames.size() * m_blockSize);
+        dumpObject.numRecords = 0;
+    }
+    m_file.write(m_writeBuffer.data(), std::streamsize(m_writeBuffer.size()));
+    return nullptr;
+}
+
+void DumpFileWriter::Close()
+{
+    if (!m_file.is_open()) return;
+    Flush();
+    m_file.close();
+}
+
+void DumpFileWriter::AddRecord(size_t objectIndex, const double *values, size_t numValues)
+{
+    DumpObject *dumpObject = &m_objectList[objectIndex];
+    size_t numChannels = dumpObject->channelNames.size();
+    for (size_t i = 0; i < numChannels; i++) dumpObject->buffer[i * m_blockSize + dumpObject->numRecords] = i < numValues ? values[i] : 0;
+    dumpObject->numRecords++;
+    if (dumpObject->numRecords >= m_blockSize) WriteBlock(dumpObject, objectIndex);
+}
+
+void DumpFileWriter::Flush()
+{
+    if (!m_file.is_open()) return;
+    for (size_t i = 0; i < m_objectList.size(); i++)
+    {
+        if (m_objectList[i].numRecords) WriteBlock(&m_objectList[i], i);
+    }
+    m_file.flush();
+}
+
+void DumpFileWriter::WriteBlock(DumpObject *dumpObject, size_t objectIndex)
+{
+    m_writeBuffer.clear();
+    AppendUInt32(&m_writeBuffer, uint32_t(objectIndex));
+    AppendUInt32(&m_writeBuffer, uint32_t(dumpObject->numRecords));
+    switch (m_valueFormat)
+    {
+    case DumpValueFormat::Compressed:
+        m_encodeBuffer.clear();
+        for (size_t i = 0; i < dumpObject->channelNames.size(); i++)
+            DumpCodec::EncodeColumn(&dumpObject->buffer[i * m_blockSize], dumpObject->numRecords, dumpObject->quantisation[i], &m_encodeBuffer);
+        AppendUInt32(&m_writeBuffer, uint32_t(m_encodeBuffer.size()));
+        m_writeBuffer.insert(m_writeBuffer.end(), m_encodeBuffer.begin(), m_encodeBuffer.end());
+        break;
+    case DumpValueFormat::Float:
+        for (size_t i = 0; i < dumpObject->channelNames.size(); i++)
+        {
+            const double *column = &dumpObject->buffer[i * m_blockSize];
+            for (size_t j = 0; j < dumpObject->numRecords; j++) AppendFloat(&m_writeBuffer, column[j]);
+        }
+        break;
+    case DumpValueFormat::Double:
+        for (size_t i = 0; i < dumpObject->channelNames.size(); i++)
+        {
+            const double *column = &dumpObject->buffer[i * m_blockSize];
+            for (size_t j = 0; j < dumpObject->numRecords; j++) AppendDouble(&m_writeBuffer, column[j]);
+        }
+        break;
+    }
+    m_file.write(m_writeBuffer.data(), std::streamsize(m_writeBuffer.size()));
+    dumpObject->numRecords = 0;
+}
+
+void DumpFileWriter::WriteString(const std::string &value)
+{
+    AppendUInt32(&m_writeBuffer, uint32_t(value.size()));
+    m_writeBuffer.insert(m_writeBuffer.end(), value.begin(), value.end());
+}
+
+void DumpFileWriter::SetBlockSize(size_t blockSize)
+{
+    m_blockSize = std::max(size_t(1), blockSize);
+}
+
+std::string DumpFileWriter::lastError() const
+{
+    return m_lastError;
+}
+
+// this is the standard .tab format used by NamedObject::dumpValuesToString
+static void AppendTabHeader(std::stringstream *ss, const std::vector<std::string> &channelNames)
+{
+    for (size_t i = 0; i < channelNames.size(); i++) *ss << (i ? "\t" : "") << channelNames[i];
+    *ss << "\n";
+}
+
+static void AppendTabRows(std::stringstream *ss, const std::vector<std::vector<double>> &channels, size_t start)
+{
+    size_t numRecords = channels.size() ? channels[0].size() : 0;
+    for (size_t j = start; j < numRecords; j++)
+    {
+        for (size_t i = 0; i < channels.size(); i++) *ss << (i ? "\t" : "") << channels[i][j];
+        *ss << "\n";
+    }
+}
+
+DumpFileStreamReader::DumpFileStreamReader()
+{
+}
+
+DumpFileStreamReader::~DumpFileStreamReader()
+{
+}
+
+std::string *DumpFileStreamReader::Open(const std::string &filename)
+{
+    m_objectList.clear();
+    m_truncated = false;
+    m_filename = filename;
+#if defined _WIN32 && defined _MSC_VER // required because windows and visual studio require wstring for full filename support
+    m_file.open(DataFile::ConvertUTF8ToWide(filename), std::ios::binary);
+#else
+    m_file.open(filename, std::ios::binary);
+#endif
+    if (!m_file.is_open())
+    {
+        m_lastError = "Error reading dump file \""s + filename + "\""s;
+        return &m_lastError;
+    }
+    // the file size is used to reject counts that cannot fit in the file before anything is allocated
+    m_file.seekg(0, std::ios::end);
+    m_fileSize = uint64_t(m_file.tellg());
+    m_file.seekg(0, std::ios::beg);
+
+    if (!ReadBytes(8) || std::memcmp(m_readBuffer.data(), c_dumpFileMagic, 8) != 0)
+    {
+        m_lastError = "\""s + filename + "\" is not a dump file"s;
+        return &m_lastError;
+    }
+    uint32_t valueFormat, numObjects;
+    if (!ReadUInt32(&valueFormat) || !ReadUInt32(&numObjects) || (valueFormat != 0 && valueFormat != 4 && valueFormat != 8))
+    {
+        m_lastError = "\""s + filename + "\" has an invalid header"s;
+        return &m_lastError;
+    }
+    m_valueFormat = DumpValueFormat(valueFormat);
+    for (uint32_t i = 0; i < numObjects; i++)
+    {
+        DumpObject dumpObject;
+        uint32_t numChannels;
+        bool ok = ReadString(&dumpObject.name) && ReadUInt32(&numChannels);
+        ok = ok && numChannels <= RemainingBytes() / 4; // every channel name has at least a length
+        if (ok)
+        {
+            dumpObject.channelNames.resize(numChannels);
+            for (auto &&channelName : dumpObject.channelNames) ok = ok && ReadString(&channelName);
+            dumpObject.quantisation.resize(numChannels, 0);
+            if (m_valueFormat == DumpValueFormat::Compressed)
+            {
+                ok = ok && ReadBytes(size_t(numChannels) * 8);
+                for (size_t j = 0; ok && j < numChannels; j++) dumpObject.quantisation[j] = ExtractDouble(m_readBuffer.data() + j * 8);
+            }
+        }
+        if (!ok)
+        {
+            m_lastError = "\""s + filename + "\" has an invalid header"s;
+            return &m_lastError;
+        }
+        m_objectList.push_back(std::move(dumpObject));
+    }
+    m_lastError.clear();
+    return nullptr;
+}
+
+bool DumpFileStreamReader::ReadBlock(size_t *objectIndex, std::vector<std::vector<double>> *channels)
+{
+    if (!m_file.is_open() || m_file.peek() == std::char_traits<char>::eof()) return false;
+    uint32_t index, numRecords;
+    if (!ReadUInt32(&index) || !ReadUInt32(&numRecords) || index >= m_objectList.size())
+    {
+        m_lastError = "\""s + m_filename + "\" has an invalid block"s;
+        return false;
+    }
+    const DumpObject &dumpObject = m_objectList[index];
+    size_t numChannels = dumpObject.channelNames.size();
+    uint64_t blockBytes;
+    if (m_valueFormat == DumpValueFormat::Compressed)
+    {
+        uint32_t numBytes;
+        if (!ReadUInt32(&numBytes))
+        {
+            m_lastError = "\""s + m_filename + "\" has an invalid block"s;
+            return false;
+        }
+        blockBytes = numBytes;
+        // every compressed value takes at least one bit so larger counts can only come from a corrupt block
+        if (numChannels && uint64_t(numRecords) > blockBytes * 8)
+        {
+            m_lastError = "\""s + m_filename + "\" has an invalid block"s;
+            return false;
+        }
+    }
+    else
+    {
+        blockBytes = uint64_t(numRecords) * numChannels * uint32_t(m_valueFormat);
+    }
+    if (!ReadBytes(size_t(blockBytes)))
+    {
+        // a truncated final block usually means the simulation did not exit cleanly
+        m_truncated = true;
+        m_lastError = "\""s + m_filename + "\" is truncated"s;
+        return false;
+    }
+
+    *objectIndex = index;
+    channels->resize(numChannels);
+    const unsigned char *ptr = m_readBuffer.data();
+    size_t remaining = m_readBuffer.size();
+    for (size_t i = 0; i < numChannels; i++)
+    {
+        std::vector<double> &channel = (*channels)[i];
+        channel.resize(numRecords);
+        switch (m_valueFormat)
+        {
+        case DumpValueFormat::Compressed:
+        {
+            size_t used = DumpCodec::DecodeColumn(ptr, remaining, numRecords, dumpObject.quantisation[i], channel.data());
+            if (used == 0)
+            {
+                m_lastError = "\""s + m_filename + "\" has an invalid compressed block"s;
+                return false;
+            }
+            ptr += used;
+            remaining -= used;
+            break;
+        }
+        case DumpValueFormat::Float:
+            for (uint32_t j = 0; j < numRecords; j++, ptr += 4) channel[j] = ExtractFloat(ptr);
+            break;
+        case DumpValueFormat::Double:
+            for (uint32_t j = 0; j < numRecords; j++, ptr += 8) channel[j] = ExtractDouble(ptr);
+            break;
+        }
+    }
+    return true;
+}
+
+bool DumpFileStreamReader::truncated() const
+{
+    return m_truncated;
+}
+
+size_t DumpFileStreamReader::GetNumObjects() const
+{
+    return m_objectList.size();
+}
+
+const std::string &DumpFileStreamReader::GetObjectName(size_t objectIndex) const
+{
+    return m_objectList.at(objectIndex).name;
+}
+
+const std::vector<std::string> &DumpFileStreamReader::GetChannelNames(size_t objectIndex) const
+{
+    return m_objectList.at(objectIndex).channelNames;
+}
+
+DumpValueFormat DumpFileStreamReader::GetValueFormat() const
+{
+    return m_valueFormat;
+}
+
+std::string *DumpFileStreamReader::WriteTabFiles(const std::string &prefix)
+{
+    std::vector<std::ofstream> outputList(m_objectList.size());
+    std::stringstream ss;
+    ss.precision(17);
+    ss.setf(std::ios::scientific);
+    for (size_t i = 0; i < m_objectList.size(); i++)
+    {
+        std::string filename = prefix + m_objectList[i].name + ".tab"s;
+#if defined _WIN32 && defined _MSC_VER // required because windows and visual studio require wstring for full filename support
+        outputList[i].open(DataFile::ConvertUTF8ToWide(filename), std::ios::binary);
+#else
+        outputList[i].open(filename, std::ios::binary);
+#endif
+        ss.str(""s);
+        AppendTabHeader(&ss, m_objectList[i].channelNames);
+        outputList[i] << ss.str();
+        if (!outputList[i])
+        {
+            m_lastError = "Error writing \""s + filename + "\""s;
+            return &m_lastError;
+        }
+    }
+    size_t objectIndex;
+    std::vector<std::vector<double>> channels;
+    while (ReadBlock(&objectIndex, &channels))
+    {
+        ss.str(""s);
+        AppendTabRows(&ss, channels, 0);
+        outputList[objectIndex] << ss.str();
+        if (!outputList[objectIndex])
+        {
+            m_lastError = "Error writing \""s + prefix + m_objectList[objectIndex].name + ".tab\""s;
+            return &m_lastError;
+        }
+    }
+    if (m_lastError.size() && !m_truncated) return &m_lastError;
+    return nullptr;
+}
+
+bool DumpFileStreamReader::ReadBytes(size_t numBytes)
+{
+    if (numBytes > RemainingBytes()) return false;
+    m_readBuffer.resize(numBytes);
+    if (numBytes == 0) return true;
+    m_file.read(reinterpret_cast<char *>(m_readBuffer.data()), std::streamsize(numBytes));
+    return size_t(m_file.gcount()) == numBytes;
+}
+
+bool DumpFileStreamReader::ReadUInt32(uint32_t *value)
+{
+    if (!ReadBytes(4)) return false;
+    *value = ExtractUInt32(m_readBuffer.data());
+    return true;
+}
+
+bool DumpFileStreamReader::ReadString(std::string *value)
+{
+    uint32_t length;
+    if (!ReadUInt32(&length) || !ReadBytes(length)) return false;
+    value->assign(reinterpret_cast<const char *>(m_readBuffer.data()), length);
+    return true;
+}
+
+uint64_t DumpFileStreamReader::RemainingBytes()
+{
+    std::streamoff position = m_file.tellg();
+    if (position < 0 || uint64_t(position) > m_fileSize) return 0;
+    return m_fileSize - uint64_t(position);
+}
+
+std::string DumpFileStreamReader::lastError() const
+{
+    return m_lastError;
+}
+
+DumpFileReader::DumpFileReader()
+{
+}
+
+DumpFileReader::~DumpFileReader()
+{
+}
+
+std::string *DumpFileReader::ReadFile(const std::string &filename)
+{
+    m_objectList.clear();
+    DumpFileStreamReader streamReader;
+    if (streamReader.Open(filename))
+    {
+        m_lastError = streamReader.lastError();
+        return &m_lastError;
+    }
+    for (size_t i = 0; i < streamReader.GetNumObjects(); i++)
+    {
+        DumpObject dumpObject;
+        dumpObject.name = streamReader.GetObjectName(i);
+        dumpObject.channelNames = streamReader.GetChannelNames(i);
+        dumpObject.channels.resize(dumpObject.channelNames.size());
+        m_objectList.push_back(std::move(dumpObject));
+    }
+    size_t objectIndex;
+    std::vector<std::vector<double>> channels;
+    while (streamReader.ReadBlock(&objectIndex, &channels))
+    {
+        for (size_t i = 0; i < channels.size(); i++)
+            m_objectList[objectIndex].channels[i].insert(m_objectList[objectIndex].channels[i].end(), channels[i].begin(), channels[i].end());
+    }
+    m_lastError = streamReader.lastError();
+    if (m_lastError.size() && !streamReader.truncated()) return &m_lastError;
+    return nullptr;
+}
+
+size_t DumpFileReader::GetNumObjects() const
+{
+    return m_objectList.size();
+}
+
+const std::string &DumpFileReader::GetObjectName(size_t objectIndex) const
+{
+    return m_objectList.at(objectIndex).name;
+}
+
+const std::vector<std::string> &DumpFileReader::GetChannelNames(size_t objectIndex) const
+{
+    return m_objectList.at(objectIndex).channelNames;
+}
+
+size_t DumpFileReader::GetNumRecords(size_t objectIndex) const
+{
+    const DumpObject &dumpObject = m_objectList.at(objectIndex);
+    if (dumpObject.channels.size() == 0) return 0;
+    return dumpObject.channels[0].size();
+}
+
+const std::vector<double> &DumpFileReader::GetChannel(size_t objectIndex, size_t channelIndex) const
+{
+    return m_objectList.at(objectIndex).channels.at(channelIndex);
+}
+
+std::string DumpFileReader::ObjectToTab(size_t objectIndex) const
+{
+    const DumpObject &dumpObject = m_objectList.at(objectIndex);
+    std::stringstream ss;
+    ss.precision(17);
+    ss.setf(std::ios::scientific);
+    AppendTabHeader(&ss, dumpObject.channelNames);
+    AppendTabRows(&ss, dumpObject.channels, 0);
+    return ss.str();
+}
+
+std::string *DumpFileReader::WriteTabFiles(const std::string &prefix)
+{
+    for (size_t i = 0; i < m_objectList.size(); i++)
+    {
+        std::string tab = ObjectToTab(i);
+        DataFile file;
+        file.SetExitOnError(false);
+        file.SetRawData(tab.data(), tab.size());
+        if (file.WriteFile(prefix + m_objectList[i].name + ".tab"s))
+        {
+            m_lastError = "Error writing \""s + prefix + m_objectList[i].name + ".tab\""s;
+            return &m_lastError;
+        }
+    }
+    return nullptr;
+}
+
+std::string DumpFileReader::lastError() const
+{
+    return m_lastError;
+}
@@ -0,0 +1,157 @@
+/*
+ *  DumpFile.h
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+// DumpFile is a binary alternative to the per object .tab dump files
+// All the objects share a single file. The layout (all little-endian) is:
+//
+// header:  "GSDUMP01" uint32 valueFormat (4 float, 8 double or 0 compressed) uint32 numObjects
+//          then for each object: string name uint32 numChannels then numChannels strings
+//          where a string is uint32 length followed by the characters
+//          and for compressed files this is followed by numChannels double quantisation values
+// blocks:  uint32 objectIndex uint32 numRecords
+//          then numChannels columns of numRecords float or double values
+//          or for compressed files uint32 numBytes followed by numChannels DumpCodec columns
+//
+// Records are buffered per object and written as blocks of columns so each block is
+// a contiguous run of values for each channel. Compressed blocks can be decoded on their own.
+
+#ifndef DUMPFILE_H
+#define DUMPFILE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+enum class DumpValueFormat : uint32_t { Compressed = 0, Float = 4, Double = 8 };
+
+class DumpFileWriter
+{
+public:
+    DumpFileWriter();
+    virtual ~DumpFileWriter();
+
+    // objects need to be added before the file is opened
+    // the quantisation is only used by compressed files and zero (or a missing value) means lossless
+    size_t AddObject(const std::string &name, const std::vector<std::string> &channelNames, const std::vector<double> &quantisation = {});
+    std::string *Open(const std::string &filename, DumpValueFormat valueFormat = DumpValueFormat::Double);
+    void Close();
+
+    // missing values are written as zero and extra values are ignored
+    void AddRecord(size_t objectIndex, const double *values, size_t numValues);
+    void Flush();
+
+    void SetBlockSize(size_t blockSize);
+    std::string lastError() const;
+
+private:
+    struct DumpObject
+    {
+        std::string name;
+        std::vector<std::string> channelNames;
+        std::vector<double> quantisation;
+        std::vector<double> buffer; // column major i.e. m_blockSize values for each channel
+        size_t numRecords = 0;
+    };
+
+    void WriteBlock(DumpObject *dumpObject, size_t objectIndex);
+    void WriteString(const std::string &value);
+
+    std::vector<DumpObject> m_objectList;
+    std::ofstream m_file;
+    std::vector<char> m_writeBuffer;
+    std::vector<char> m_encodeBuffer;
+    size_t m_blockSize = 256;
+    DumpValueFormat m_valueFormat = DumpValueFormat::Double;
+    std::string m_lastError;
+};
+
+// this reads a dump file a block at a time so files of any size can be processed
+class DumpFileStreamReader
+{
+public:
+    DumpFileStreamReader();
+    virtual ~DumpFileStreamReader();
+
+    // this reads the header
+    std::string *Open(const std::string &filename);
+    // reads the next block of records for one object as one vector per channel
+    // returns false at the end of the file or on error when lastError is set
+    bool ReadBlock(size_t *objectIndex, std::vector<std::vector<double>> *channels);
+    bool truncated() const;
+
+    size_t GetNumObjects() const;
+    const std::string &GetObjectName(size_t objectIndex) const;
+    const std::vector<std::string> &GetChannelNames(size_t objectIndex) const;
+    DumpValueFormat GetValueFormat() const;
+
+    // writes the rest of the file as a .tab file for every object with the optional prefix added to the filename
+    std::string *WriteTabFiles(const std::string &prefix);
+
+    std::string lastError() const;
+
+private:
+    struct DumpObject
+    {
+        std::string name;
+        std::vector<std::string> channelNames;
+        std::vector<double> quantisation;
+    };
+
+    bool ReadBytes(size_t numBytes);
+    bool ReadUInt32(uint32_t *value);
+    bool ReadString(std::string *value);
+    uint64_t RemainingBytes();
+
+    std::vector<DumpObject> m_objectList;
+    std::ifstream m_file;
+    uint64_t m_fileSize = 0;
+    std::string m_filename;
+    std::vector<unsigned char> m_readBuffer;
+    DumpValueFormat m_valueFormat = DumpValueFormat::Double;
+    bool m_truncated = false;
+    std::string m_lastError;
+};
+
+class DumpFileReader
+{
+public:
+    DumpFileReader();
+    virtual ~DumpFileReader();
+
+    // this reads the whole file into memory
+    // a truncated file is not an error but lastError is set
+    std::string *ReadFile(const std::string &filename);
+
+    size_t GetNumObjects() const;
+    const std::string &GetObjectName(size_t objectIndex) const;
+    const std::vector<std::string> &GetChannelNames(size_t objectIndex) const;
+    size_t GetNumRecords(size_t objectIndex) const;
+    const std::vector<double> &GetChannel(size_t objectIndex, size_t channelIndex) const;
+
+    // this produces the same text as the standard .tab dump file
+    std::string ObjectToTab(size_t objectIndex) const;
+    // writes a .tab file for every object with the optional prefix added to the filename
+    std::string *WriteTabFiles(const std::string &prefix);
+
+    std::string lastError() const;
+
+private:
+    struct DumpObject
+    {
+        std::string name;
+        std::vector<std::string> channelNames;
+        std::vector<std::vector<double>> channels;
+    };
+
+    std::vector<DumpObject> m_objectList;
+    std::string m_lastError;
+};
+
+#endif // DUMPFILE_H
@@ -0,0 +1,80 @@
+/*
+ *  DumpHistory.cpp
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+#include "DumpHistory.h"
+
+#include <algorithm>
+
+DumpHistory::DumpHistory()
+{
+}
+
+DumpHistory::~DumpHistory()
+{
+}
+
+void DumpHistory::Initialise(size_t maxRecords)
+{
+    m_maxRecords = std::max(size_t(1), maxRecords);
+    m_ringList.clear();
+}
+
+void DumpHistory::AddRecord(size_t target, double time, const double *values, size_t numValues)
+{
+    if (target >= m_ringList.size()) m_ringList.resize(target + 1);
+    Ring &ring = m_ringList[target];
+    if (ring.records.empty()) ring.records.resize(m_maxRecords);
+    ring.records[NextSlot(&ring, time)].assign(values, values + numValues);
+}
+
+void DumpHistory::AddText(size_t target, double time, const std::string &text)
+{
+    if (target >= m_ringList.size()) m_ringList.resize(target + 1);
+    Ring &ring = m_ringList[target];
+    if (ring.texts.empty()) ring.texts.resize(m_maxRecords);
+    ring.texts[NextSlot(&ring, time)].assign(text);
+}
+
+// adds a slot to the end of the ring overwriting the oldest if necessary
+size_t DumpHistory::NextSlot(Ring *ring, double time)
+{
+    if (ring->times.empty()) ring->times.resize(m_maxRecords);
+    size_t slot = (ring->first + ring->count) % m_maxRecords;
+    if (ring->count == m_maxRecords) ring->first = (ring->first + 1) % m_maxRecords;
+    else ring->count++;
+    ring->times[slot] = time;
+    return slot;
+}
+
+void DumpHistory::Flush(double fromTime, const std::function<void(size_t target, const double *values, size_t numValues)> &writeValues,
+                        const std::function<void(size_t target, const std::string &text)> &writeText)
+{
+    for (size_t target = 0; target < m_ringList.size(); target++)
+    {
+        Ring &ring = m_ringList[target];
+        for (size_t i = 0; i < ring.count; i++)
+        {
+            size_t slot = (ring.first + i) % m_maxRecords;
+            if (ring.times[slot] < fromTime) continue;
+            if (ring.texts.size()) writeText(target, ring.texts[slot]);
+            else writeValues(target, ring.records[slot].data(), ring.records[slot].size());
+        }
+        ring.first = 0;
+        ring.count = 0;
+    }
+}
+
+void DumpHistory::Clear()
+{
+    for (auto &&ring : m_ringList)
+    {
+        ring.first = 0;
+        ring.count = 0;
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ *  DumpHistory.h
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+// DumpHistory keeps the most recent dump records for a set of dump targets so that when
+// a dump trigger fires the records from just before the event can still be written.
+// Each target has a fixed size ring buffer of either numeric records or text records for
+// objects that only have text output. The slots keep their memory so once the buffer has
+// filled there is very little allocation.
+
+#ifndef DUMPHISTORY_H
+#define DUMPHISTORY_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstddef>
+
+class DumpHistory
+{
+public:
+    DumpHistory();
+    virtual ~DumpHistory();
+
+    // maxRecords is the most records that will be kept for each target
+    void Initialise(size_t maxRecords);
+    void AddRecord(size_t target, double time, const double *values, size_t numValues);
+    void AddText(size_t target, double time, const std::string &text);
+    // writes the records at or after fromTime in time order for each target and then empties the history
+    void Flush(double fromTime, const std::function<void(size_t target, const double *values, size_t numValues)> &writeValues,
+               const std::function<void(size_t target, const std::string &text)> &writeText);
+    void Clear();
+
+private:
+    struct Ring
+    {
+        std::vector<std::vector<double>> records;
+        std::vector<std::string> texts;
+        std::vector<double> times;
+        size_t first = 0;
+        size_t count = 0;
+    };
+    size_t NextSlot(Ring *ring, double time);
+
+    std::vector<Ring> m_ringList;
+    size_t m_maxRecords = 0;
+};
+
+#endif // DUMPHISTORY_H
@@ -15,19 +15,20 @@
 #include <functional>
 
 // this is glue to allow a C++ function (even a member function) to be called as a C callback
+// func is thread local so each thread can have its own target and calls from a thread without one are ignored
 template <typename T>
 struct Callback;
 
 template <typename Ret, typename... Params>
 struct Callback<Ret(Params...)> {
     template <typename... Args>
-    static Ret callback(Args... args) { return func(args...); }
-    static std::function<Ret(Params...)> func;
+    static Ret callback(Args... args) { if (func) return func(args...); return Ret(); }
+    static thread_local std::function<Ret(Params...)> func;
 };
 
 // Initialize the static member.
 template <typename Ret, typename... Params>
-std::function<Ret(Params...)> Callback<Ret(Params...)>::func;
+thread_local std::function<Ret(Params...)> Callback<Ret(Params...)>::func;
 
 class ErrorHandler
 {
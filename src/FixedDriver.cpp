@@ -23,7 +23,7 @@ FixedDriver::FixedDriver()
 
 void FixedDriver::Update()
 {
-    assert(simulation()->GetStepCount() == lastStepCount() + 1);
+    assert(simulation()->GetStepCount() == nextUpdateStepCount());
     setLastStepCount(simulation()->GetStepCount());
 }
 
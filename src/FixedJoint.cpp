@@ -17,6 +17,8 @@
 #include "Marker.h"
 
 #include <sstream>
+#include <algorithm>
+#include <cmath>
 
 using namespace std::string_literals;
 
@@ -111,98 +113,55 @@ void FixedJoint::CalculateStress()
         // precalculate invariant bits of the formula
         double t1 = (My * m_Ix + Mx * m_Ixy)/(m_Ix * m_Iy - m_Ixy * m_Ixy);
         double t2 = (Mx * m_Iy + My * m_Ixy)/(m_Ix * m_Iy - m_Ixy * m_Ixy);
-        double *xDistancePtr = m_xDistances.data();
-        double *yDistancePtr = m_yDistances.data();
-
-        double *stressPtr = m_stress.data();
-        m_minStress = DBL_MAX;
-        m_maxStress = -DBL_MAX;
-        for (size_t i = 0; i < m_nActivePixels; i++)
-        {
-            *stressPtr = -t1 * (*xDistancePtr) + t2 * (*yDistancePtr) + linearStress;
-            if (*stressPtr > m_maxStress) m_maxStress = *stressPtr;
-            if (*stressPtr < m_minStress) m_minStress = *stressPtr;
-            stressPtr++;
-            xDistancePtr++;
-            yDistancePtr++;
-        }
+        if (m_singlePrecisionStress)
+            BeamStressKernel<float>(m_xDistancesFloat.data(), m_yDistancesFloat.data(), m_nActivePixels, float(-t1), float(t2), float(linearStress), m_stress.data());
+        else
+            BeamStressKernel<double>(m_xDistances.data(), m_yDistances.data(), m_nActivePixels, -t1, t2, linearStress, m_stress.data());
+        CalculateRange(m_stress.data(), m_nActivePixels, &m_minStress, &m_maxStress);
     }
     else if (m_stressCalculationType == spring)
     {
         m_torqueScalar = m_torqueStressCoords.Magnitude();
-        m_torqueAxis = m_torqueStressCoords / m_torqueScalar;
+        if (m_torqueScalar > 0) m_torqueAxis = m_torqueStressCoords / m_torqueScalar;
+        else m_torqueAxis = pgd::Vector3(0, 0, 1); // any axis will do when there is no torque and this avoids a NaN stress map
 
         // assuming all the springs are the same then
         pgd::Vector3 forcePerSpring1 = m_forceStressCoords / double(m_nActivePixels);
 
-        // but for the torque we need to find the total torsional springiness
-        double *xDistancePtr = m_xDistances.data();
-        double *yDistancePtr = m_yDistances.data();
-        double totalNominalTorque = 0;
-
-        for (size_t i = 0; i < m_nActivePixels; i++)
-        {
-            pgd::Vector3 p(*xDistancePtr, *yDistancePtr, 0);
-            pgd::Vector3 closestPoint = m_torqueAxis * (m_torqueAxis * p);
-            pgd::Vector3 r = p - closestPoint;
-            double distance2 = r.Magnitude2();
-            double distance = sqrt(distance2);
-            if (distance2 > 1e-10)
-            {
-                pgd::Vector3 direction = m_torqueAxis ^ r;
-                direction.Normalize();
-                pgd::Vector3 forcePerSpring2 =  direction * distance; // force per spring is proportional to the perpendicular distance
-                totalNominalTorque += distance2; // but the torque per spring is proportional to the perpendicular distance squared
-                m_vectorList[i] = forcePerSpring2;
-            }
-            else
-            {
-                m_vectorList[i] = pgd::Vector3(0, 0, 0);
-            }
-            xDistancePtr++;
-            yDistancePtr++;
-        }
-
-        double torqueScale = m_torqueScalar / totalNominalTorque; // this will make the total torque produced by the springs add up to the actual torque
-        m_minStress = DBL_MAX;
-        m_maxStress = -DBL_MAX;
-        double *stressPtr = m_stress.data();
+        // each spring is at p = (x, y, 0) and the torsional force is proportional to the perpendicular distance r from the torque axis
+        // and in the direction m_torqueAxis ^ r. Since m_torqueAxis ^ r has magnitude |r| this is simply m_torqueAxis ^ p.
+        // The torque per spring is proportional to |r|^2 = |p|^2 - (m_torqueAxis * p)^2 so the total torsional springiness
+        // comes directly from the second moments of area without needing a pass through the pixels
         double dArea = m_dx * m_dy;
-        for (size_t i = 0; i < m_nActivePixels; i++)
-        {
-            //std::cerr << m_vectorList[i].x << " " << m_vectorList[i].y << " " << m_vectorList[i].z << "\n";
-            m_vectorList[i] = (m_vectorList[i] * torqueScale) + forcePerSpring1;
-            *stressPtr = m_vectorList[i].Magnitude() / dArea;
-            if (*stressPtr > m_maxStress) m_maxStress = *stressPtr;
-            if (*stressPtr < m_minStress) m_minStress = *stressPtr;
-            stressPtr++;
-        }
+        double ax = m_torqueAxis.x;
+        double ay = m_torqueAxis.y;
+        double totalNominalTorque = ((m_Ix + m_Iy) - (ax * ax * m_Iy + 2 * ax * ay * m_Ixy + ay * ay * m_Ix)) / dArea;
+        double torqueScale = totalNominalTorque > 0 ? m_torqueScalar / totalNominalTorque : 0; // this will make the total torque produced by the springs add up to the actual torque
+
+        // so the force on each spring is torqueScale * (m_torqueAxis ^ p) + forcePerSpring1 and the stress is the magnitude of this over the pixel area
+        pgd::Vector3 scaledAxis = m_torqueAxis * torqueScale;
+        if (m_singlePrecisionStress)
+            SpringStressKernel<float>(m_xDistancesFloat.data(), m_yDistancesFloat.data(), m_nActivePixels, float(scaledAxis.x), float(scaledAxis.y), float(scaledAxis.z),
+                                      float(forcePerSpring1.x), float(forcePerSpring1.y), float(forcePerSpring1.z), float(1.0 / dArea), m_stress.data());
+        else
+            SpringStressKernel<double>(m_xDistances.data(), m_yDistances.data(), m_nActivePixels, scaledAxis.x, scaledAxis.y, scaledAxis.z,
+                                       forcePerSpring1.x, forcePerSpring1.y, forcePerSpring1.z, 1.0 / dArea, m_stress.data());
+        CalculateRange(m_stress.data(), m_nActivePixels, &m_minStress, &m_maxStress);
 
 //#define SANITY_CHECK
 #ifdef SANITY_CHECK
         // check that my forces and my torqes add up
         pgd::Vector3 totalForce;
         pgd::Vector3 totalTorque;
-        size_t i = 0;
-        unsigned char *ptr = m_stiffness.data();
-        for (size_t iy = 0; iy < m_ny; iy++)
+        for (size_t i = 0; i < m_nActivePixels; i++)
         {
-            for (size_t ix = 0; ix < m_nx; ix++)
-            {
-                if (*ptr)
-                {
-                    totalForce += m_vectorList[i];
-
-                    pgd::Vector3 p(((ix) + 0.5) * m_dx - m_xOrigin, ((iy) + 0.5) * m_dy - m_yOrigin, 0);
-                    pgd::Vector3 closestPoint = m_torqueAxis * (m_torqueAxis * p);
-                    pgd::Vector3 r = p - closestPoint;
-                    pgd::Vector3 torque = r ^ m_vectorList[i];
-                    std::cerr << "torque " << torque.x << " " << torque.y << " " << torque.z << "\n";
-                    totalTorque += torque;
-                    i++;
-                }
-                ptr++;
-            }
+            pgd::Vector3 p(m_xDistances[i], m_yDistances[i], 0);
+            pgd::Vector3 force = (scaledAxis ^ p) + forcePerSpring1;
+            totalForce += force;
+            pgd::Vector3 closestPoint = m_torqueAxis * (m_torqueAxis * p);
+            pgd::Vector3 r = p - closestPoint;
+            pgd::Vector3 torque = r ^ force;
+            totalTorque += torque;
         }
         std::cerr << "m_forceStressCoords " << m_forceStressCoords.x << " " << m_forceStressCoords.y << " " << m_forceStressCoords.z << "\n";
         std::cerr << "totalForce " << totalForce.x << " " << totalForce.y << " " << totalForce.z << "\n";
@@ -227,15 +186,51 @@ void FixedJoint::CalculateStress()
         for (size_t i = 0; i < m_nActivePixels; i++)
         {
             m_filteredStress[i]->AddNewSample(m_stress[i]);
-            if (m_filteredStress[i]->Output() > m_lowPassMaxStress)
-                m_lowPassMaxStress = m_filteredStress[i]->Output();
-            if (m_filteredStress[i]->Output() < m_lowPassMinStress)
-                m_lowPassMinStress = m_filteredStress[i]->Output();
+            double output = m_filteredStress[i]->Output();
+            m_lowPassMaxStress = std::max(m_lowPassMaxStress, output);
+            m_lowPassMinStress = std::min(m_lowPassMinStress, output);
         }
         break;
     }
 }
 
+// the stress kernels work on separate x and y distance arrays with no branches so that the compiler can vectorise them
+// T is float or double but the stress is always returned as double
+template<typename T> void FixedJoint::BeamStressKernel(const T *xDistances, const T *yDistances, size_t n, T xCoefficient, T yCoefficient, T linearStress, double *stress)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        stress[i] = double(xCoefficient * xDistances[i] + yCoefficient * yDistances[i] + linearStress);
+    }
+}
+
+// force = (scaledAxis ^ p) + forcePerSpring where p = (x, y, 0) and stress = |force| / area
+template<typename T> void FixedJoint::SpringStressKernel(const T *xDistances, const T *yDistances, size_t n, T scaledAxisX, T scaledAxisY, T scaledAxisZ,
+                                                         T forcePerSpringX, T forcePerSpringY, T forcePerSpringZ, T inverseArea, double *stress)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        T fx = forcePerSpringX - scaledAxisZ * yDistances[i];
+        T fy = forcePerSpringY + scaledAxisZ * xDistances[i];
+        T fz = forcePerSpringZ + scaledAxisX * yDistances[i] - scaledAxisY * xDistances[i];
+        stress[i] = double(std::sqrt(fx * fx + fy * fy + fz * fz) * inverseArea);
+    }
+}
+
+// branch free min and max so that the compiler can vectorise the loop
+void FixedJoint::CalculateRange(const double *values, size_t n, double *minValue, double *maxValue)
+{
+    double localMin = DBL_MAX;
+    double localMax = -DBL_MAX;
+    for (size_t i = 0; i < n; i++)
+    {
+        localMin = std::min(localMin, values[i]);
+        localMax = std::max(localMax, values[i]);
+    }
+    *minValue = localMin;
+    *maxValue = localMax;
+}
+
 const std::vector<unsigned char> &FixedJoint::pixMap() const
 {
     return m_pixMap;
@@ -376,13 +371,27 @@ void FixedJoint::SetCrossSection(const std::vector<unsigned char> &stiffness, si
         }
     }
 
-    // allocate the vector list
-    m_vectorList.clear();
-    m_vectorList.resize(m_nActivePixels);
+    CreateSinglePrecisionDistances();
     m_stress.clear();
     m_stress.resize(m_nActivePixels);
 }
 
+void FixedJoint::SetSinglePrecisionStress(bool singlePrecisionStress)
+{
+    m_singlePrecisionStress = singlePrecisionStress;
+    CreateSinglePrecisionDistances();
+}
+
+// float copies of the distances are only kept if they are going to be used
+void FixedJoint::CreateSinglePrecisionDistances()
+{
+    m_xDistancesFloat.clear();
+    m_yDistancesFloat.clear();
+    if (!m_singlePrecisionStress) return;
+    m_xDistancesFloat.assign(m_xDistances.begin(), m_xDistances.end());
+    m_yDistancesFloat.assign(m_yDistances.begin(), m_yDistances.end());
+}
+
 // note: m_StressOrigin is in Body1 local coordinates
 void FixedJoint::SetStressOrigin(double x, double y, double z)
 {
@@ -416,7 +425,7 @@ void FixedJoint::SetWindow(size_t window)
 void FixedJoint::SetCutoffFrequency(double cutoffFrequency)
 {
     m_cutoffFrequency = cutoffFrequency;
-    double samplingFrequency = 1.0 / simulation()->GetTimeIncrement();
+    double samplingFrequency = 1.0 / (simulation()->GetTimeIncrement() * double(m_stressCalculationInterval)); // the filters are only fed when the stress is calculated
 //    m_minStressButterworth = new ButterworthFilter(cutoffFrequency, samplingFrequency);
 //    m_maxStressButterworth = new ButterworthFilter(cutoffFrequency, samplingFrequency);
     m_lowPassType = Butterworth2ndOrderLowPass;
@@ -432,7 +441,7 @@ void FixedJoint::SetCutoffFrequency(double cutoffFrequency)
 
 bool FixedJoint::CheckStressAbort()
 {
-    if (m_stressCalculationType == none) return false;
+    if (m_stressCalculationType == none || m_stressLimit <= 0) return false;
     if (m_lowPassMaxStress > m_stressLimit) return true;
     if (m_lowPassMinStress < -m_stressLimit) return true;
     return false;
@@ -440,7 +449,16 @@ bool FixedJoint::CheckStressAbort()
 
 void FixedJoint::Update()
 {
-    if (m_stressCalculationType != none) CalculateStress();
+    if (m_stressCalculationType == none) return;
+    if (!StressNeeded()) return;
+    if (m_stressCalculationInterval > 1 && simulation()->GetStepCount() % m_stressCalculationInterval) return;
+    CalculateStress();
+}
+
+// the stress calculation is expensive so it is only done if something is going to use the values
+bool FixedJoint::StressNeeded()
+{
+    return m_stressLimit > 0 || dump() || m_stressDisplayed;
 }
 
 std::string *FixedJoint::createFromAttributes()
@@ -475,6 +493,7 @@ std::string *FixedJoint::createFromAttributes()
 
         if (findAttribute("StressLimit"s, &buf) == nullptr) return lastErrorPtr();
         this->SetStressLimit(GSUtil::Double(buf));
+        if (findAttribute("StressCalculationInterval"s, &buf)) this->SetStressCalculationInterval(size_t(std::max(1, GSUtil::Int(buf))));
 
         double doubleList[2];
         if (findAttribute("StressBitmapPixelSize"s, &buf) == nullptr) return lastErrorPtr();
@@ -487,6 +506,7 @@ std::string *FixedJoint::createFromAttributes()
         int ny = int(doubleList[1] + 0.5);
         if (findAttribute("StressBitmap"s, &buf) == nullptr) return lastErrorPtr();
         this->SetCrossSection(AsciiToBitMap(buf, nx, ny, '1', true), nx, ny, dx, dy);
+        if (findAttribute("SinglePrecisionStress"s, &buf)) this->SetSinglePrecisionStress(GSUtil::Bool(buf));
 
         switch (m_lowPassType)
         {
@@ -551,6 +571,8 @@ void FixedJoint::appendToAttributes()
             break;
         }
         setAttribute("StressLimit"s, *GSUtil::ToString(m_stressLimit, &buf));
+        setAttribute("StressCalculationInterval"s, *GSUtil::ToString(m_stressCalculationInterval, &buf));
+        setAttribute("SinglePrecisionStress"s, *GSUtil::ToString(m_singlePrecisionStress, &buf));
         double doubleList[2] = { m_dx, m_dy };
         setAttribute("StressBitmapPixelSize"s, *GSUtil::ToString(doubleList, 2, &buf));
         size_t intList[2] = { m_nx, m_ny };
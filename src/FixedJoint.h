@@ -15,6 +15,7 @@
 #include "PGDMath.h"
 
 #include <memory>
+#include <algorithm>
 
 class ButterworthFilter;
 class MovingAverage;
@@ -47,9 +48,18 @@ class FixedJoint: public Joint
     double GetMaxStress() { return m_maxStress; }
     double GetMinStress() { return m_minStress; }
 
-    void SetStressLimit(double stressLimit) { m_stressLimit = stressLimit; }
+    void SetStressLimit(double stressLimit) { m_stressLimit = stressLimit; } // a stress limit <= 0 means no limit
+    double GetStressLimit() { return m_stressLimit; }
     bool CheckStressAbort();
 
+    // the stress is only calculated every m_stressCalculationInterval steps and only if there is something that uses it
+    void SetStressCalculationInterval(size_t stressCalculationInterval) { m_stressCalculationInterval = std::max(size_t(1), stressCalculationInterval); }
+    size_t GetStressCalculationInterval() { return m_stressCalculationInterval; }
+    void SetStressDisplayed(bool stressDisplayed) { m_stressDisplayed = stressDisplayed; }
+    void SetSinglePrecisionStress(bool singlePrecisionStress);
+    bool GetSinglePrecisionStress() { return m_singlePrecisionStress; }
+    bool StressNeeded();
+
     void SetLowPassType(LowPassType lowPassType) { m_lowPassType = lowPassType; }
     LowPassType GetLowPassType() { return m_lowPassType; }
     void SetWindow(size_t window);
@@ -97,6 +107,11 @@ class FixedJoint: public Joint
 private:
 
     void CalculateStress();
+    void CreateSinglePrecisionDistances();
+    static void CalculateRange(const double *values, size_t n, double *minValue, double *maxValue);
+    template<typename T> static void BeamStressKernel(const T *xDistances, const T *yDistances, size_t n, T xCoefficient, T yCoefficient, T linearStress, double *stress);
+    template<typename T> static void SpringStressKernel(const T *xDistances, const T *yDistances, size_t n, T scaledAxisX, T scaledAxisY, T scaledAxisZ,
+                                                        T forcePerSpringX, T forcePerSpringY, T forcePerSpringZ, T inverseArea, double *stress);
     static std::vector<unsigned char> AsciiToBitMap(const std::string &buffer, size_t width, size_t height, char setChar, bool reverseY);
 
     bool m_lateFix = false;
@@ -106,6 +121,9 @@ private:
     std::vector<double> m_stress;
     std::vector<double> m_xDistances;
     std::vector<double> m_yDistances;
+    std::vector<float> m_xDistancesFloat;
+    std::vector<float> m_yDistancesFloat;
+    bool m_singlePrecisionStress = false;
     size_t m_nx = 0;
     size_t m_ny = 0;
     size_t m_nActivePixels = 0;
@@ -131,6 +149,8 @@ private:
     double m_torqueScalar = 0;
 
     double m_stressLimit = -1;
+    size_t m_stressCalculationInterval = 1;
+    bool m_stressDisplayed = false;
     std::vector<std::unique_ptr<Filter>> m_filteredStress;
     double m_lowPassMinStress = 0;
     double m_lowPassMaxStress = 0;
@@ -138,8 +158,6 @@ private:
     double m_cutoffFrequency = 0;
     size_t m_window = 0;
 
-    std::vector<pgd::Vector3> m_vectorList;
-
     std::vector<unsigned char> m_colourMap;
     std::vector<unsigned char> m_pixMap;
     double m_lastDisplayTime = -1;
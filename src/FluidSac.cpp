@@ -26,78 +26,94 @@ FluidSac::FluidSac()
 
 void FluidSac::calculateVolume()
 {
-    for (size_t i = 0; i < m_markerList.size(); i++) m_vertexList[i] = m_markerList[i]->GetWorldPosition();
-    double currentVolume = volumeOfMesh(m_triangleList, m_vertexList);
-    double deltaT = simulation()->GetTimeIncrement() / 1e-6;
-    std::vector<pgd::Vector3> deltaList(m_markerList.size());
-    for (size_t i = 0; i < m_markerList.size(); i++) deltaList[i] = m_markerList[i]->GetWorldLinearVelocity() * deltaT; // using the marker velocities gives a semi-implicit solution which should be more stable
-    std::vector<pgd::Vector3> vertexList1 = m_vertexList;
-    std::vector<pgd::Vector3> vertexList2 = m_vertexList;
-    for (size_t i = 0; i < m_markerList.size(); i++) vertexList1[i] -= deltaList[i];
-    for (size_t i = 0; i < m_markerList.size(); i++) vertexList2[i] += deltaList[i];
-    double volume1 = volumeOfMesh(m_triangleList, vertexList1);
-    double volume2 = volumeOfMesh(m_triangleList, vertexList1);
-    setSacVolume(currentVolume);
-    setDotSacVolume((volume2 - volume1) / (2 * deltaT));
+    for (size_t i = 0; i < m_markerList.size(); i++)
+    {
+        pgd::Vector3 position = m_markerList[i]->GetWorldPosition();
+        pgd::Vector3 velocity = m_markerList[i]->GetWorldLinearVelocity();
+        m_vertexX[i] = position.x;
+        m_vertexY[i] = position.y;
+        m_vertexZ[i] = position.z;
+        m_velocityX[i] = velocity.x;
+        m_velocityY[i] = velocity.y;
+        m_velocityZ[i] = velocity.z;
+    }
+
+    // the signed volume is the sum of a.(b x c)/6 over the triangles and its time derivative is
+    // the sum of (da/dt.(b x c) + db/dt.(c x a) + dc/dt.(a x b))/6 which uses the marker velocities directly
+    const double *x = m_vertexX.data();
+    const double *y = m_vertexY.data();
+    const double *z = m_vertexZ.data();
+    const double *vx = m_velocityX.data();
+    const double *vy = m_velocityY.data();
+    const double *vz = m_velocityZ.data();
+    const Triangle *triangles = m_triangleList.data();
+    size_t numTriangles = m_triangleList.size();
+    double volumeSum = 0;
+    double dotVolumeSum = 0;
+    for (size_t i = 0; i < numTriangles; i++)
+    {
+        size_t i0 = triangles[i].v0, i1 = triangles[i].v1, i2 = triangles[i].v2;
+        double ax = x[i0], ay = y[i0], az = z[i0];
+        double bx = x[i1], by = y[i1], bz = z[i1];
+        double cx = x[i2], cy = y[i2], cz = z[i2];
+        double bcx = by * cz - bz * cy, bcy = bz * cx - bx * cz, bcz = bx * cy - by * cx;
+        double cax = cy * az - cz * ay, cay = cz * ax - cx * az, caz = cx * ay - cy * ax;
+        double abx = ay * bz - az * by, aby = az * bx - ax * bz, abz = ax * by - ay * bx;
+        volumeSum += ax * bcx + ay * bcy + az * bcz;
+        dotVolumeSum += vx[i0] * bcx + vy[i0] * bcy + vz[i0] * bcz +
+                        vx[i1] * cax + vy[i1] * cay + vz[i1] * caz +
+                        vx[i2] * abx + vy[i2] * aby + vz[i2] * abz;
+    }
+    // the volume is reported as positive whatever the winding order so the derivative needs the same sign change
+    if (volumeSum < 0)
+    {
+        volumeSum = -volumeSum;
+        dotVolumeSum = -dotVolumeSum;
+    }
+    setSacVolume(volumeSum / 6.0);
+    setDotSacVolume(dotVolumeSum / 6.0);
 }
 
 
 void FluidSac::calculateLoadsOnMarkers()
 {
-    pgd::Vector3 v01, v12, v20;
-    m_pointForceList.resize(m_triangleList.size() * 3);
-    size_t pointListIndex = 0;
-    for (size_t i = 0; i < m_triangleList.size(); i++)
+    // the pressure force on a triangle acts at the centroid which means it is shared equally between the vertices
+    // and normal * area * pressure / 3 simplifies to (edge0 x edge1) * pressure / 6
+    std::fill(m_forceX.begin(), m_forceX.end(), 0.0);
+    std::fill(m_forceY.begin(), m_forceY.end(), 0.0);
+    std::fill(m_forceZ.begin(), m_forceZ.end(), 0.0);
+    const double *x = m_vertexX.data();
+    const double *y = m_vertexY.data();
+    const double *z = m_vertexZ.data();
+    double *fx = m_forceX.data();
+    double *fy = m_forceY.data();
+    double *fz = m_forceZ.data();
+    const Triangle *triangles = m_triangleList.data();
+    size_t numTriangles = m_triangleList.size();
+    double scale = m_pressure / 6.0;
+    for (size_t i = 0; i < numTriangles; i++)
+    {
+        size_t i0 = triangles[i].v0, i1 = triangles[i].v1, i2 = triangles[i].v2;
+        double e0x = x[i1] - x[i0], e0y = y[i1] - y[i0], e0z = z[i1] - z[i0];
+        double e1x = x[i2] - x[i1], e1y = y[i2] - y[i1], e1z = z[i2] - z[i1];
+        double px = (e0y * e1z - e0z * e1y) * scale;
+        double py = (e0z * e1x - e0x * e1z) * scale;
+        double pz = (e0x * e1y - e0y * e1x) * scale;
+        fx[i0] += px; fy[i0] += py; fz[i0] += pz;
+        fx[i1] += px; fy[i1] += py; fz[i1] += pz;
+        fx[i2] += px; fy[i2] += py; fz[i2] += pz;
+    }
+
+    // one point force per marker
+    for (size_t i = 0; i < m_markerList.size(); i++)
     {
-        // for each triangle calculate the equivalent force and torque on each marker.
-        FluidSac::Triangle *it = &m_triangleList[i];
-        areaCentroidNormal(m_vertexList[it->v0], m_vertexList[it->v1], m_vertexList[it->v2], &it->area, &it->centroid, &it->normal);
-
-        // now rotate the system so that the normal is aligned to the z axis
-        pgd::Quaternion r = pgd::FindRotation(it->normal, pgd::Vector3(0, 0, 1));
-        pgd::Vector3 v0 = pgd::QVRotate(r, m_vertexList[it->v0]);
-        pgd::Vector3 v1 = pgd::QVRotate(r, m_vertexList[it->v1]);
-        pgd::Vector3 v2 = pgd::QVRotate(r, m_vertexList[it->v2]);
-        pgd::Vector3 centroid = pgd::QVRotate(r, it->centroid);
-
-        // now we can use the Z=0 triangle formulae
-        // the triangle is in the z=0 plane
-        // the applied vertical force is F
-        // the reaction forces are R0, R1, R2
-        // the position of the applied force is specified as x, y
-        // the positions of the vertices are x0,y0, x1,y1, x2,y2
-
-        // R0 = (F*(x*y1 - x1*y - x*y2 + x2*y + x1*y2 - x2*y1))/(x0*y1 - x1*y0 - x0*y2 + x2*y0 + x1*y2 - x2*y1)
-        // R1 = -(F*(x*y0 - x0*y - x*y2 + x0*y2 + x2*y - x2*y0))/(x0*y1 - x1*y0 - x0*y2 + x2*y0 + x1*y2 - x2*y1)
-        // R2 = (F*(x*y0 - x0*y - x*y1 + x0*y1 + x1*y - x1*y0))/(x0*y1 - x1*y0 - x0*y2 + x2*y0 + x1*y2 - x2*y1)
-
-        double x = centroid.x;
-        double y = centroid.y;
-        double x0 = v0.x;
-        double x1 = v1.x;
-        double x2 = v2.x;
-        double y0 = v0.y;
-        double y1 = v1.y;
-        double y2 = v2.y;
-        double F = it->area * m_pressure;
-        double denom = (x0*y1 - x1*y0 - x0*y2 + x2*y0 + x1*y2 - x2*y1);
-        double R0 = (F*(x*y1 - x1*y - x*y2 + x2*y + x1*y2 - x2*y1)) / denom;
-        double R1 = -(F*(x*y0 - x0*y - x*y2 + x0*y2 + x2*y - x2*y0)) / denom;
-        double R2 = (F*(x*y0 - x0*y - x*y1 + x0*y1 + x1*y - x1*y0)) / denom;
-
-        // and add the reaction forces to the body
-        m_pointForceList[pointListIndex].body = m_markerList[it->v0]->GetBody();
-        std::copy_n(m_vertexList[it->v0].data(), 3, m_pointForceList[pointListIndex].point);
-        std::copy_n((it->normal * R0).data(), 3, m_pointForceList[pointListIndex].vector);
-        pointListIndex++;
-        m_pointForceList[pointListIndex].body = m_markerList[it->v1]->GetBody();
-        std::copy_n(m_vertexList[it->v1].data(), 3, m_pointForceList[pointListIndex].point);
-        std::copy_n((it->normal * R1).data(), 3, m_pointForceList[pointListIndex].vector);
-        pointListIndex++;
-        m_pointForceList[pointListIndex].body = m_markerList[it->v2]->GetBody();
-        std::copy_n(m_vertexList[it->v2].data(), 3, m_pointForceList[pointListIndex].point);
-        std::copy_n((it->normal * R2).data(), 3, m_pointForceList[pointListIndex].vector);
-        pointListIndex++;
+        PointForce *pointForce = &m_pointForceList[i];
+        pointForce->point[0] = x[i];
+        pointForce->point[1] = y[i];
+        pointForce->point[2] = z[i];
+        pointForce->vector[0] = fx[i];
+        pointForce->vector[1] = fy[i];
+        pointForce->vector[2] = fz[i];
     }
 }
 
@@ -242,15 +258,15 @@ size_t FluidSac::numTriangles() const
 void FluidSac::triangleVertices(size_t triangleIndex, double vertices[9]) const
 {
     const Triangle *tri = &m_triangleList[triangleIndex];
-    vertices[0] = m_vertexList[tri->v0].x;
-    vertices[1] = m_vertexList[tri->v0].y;
-    vertices[2] = m_vertexList[tri->v0].z;
-    vertices[3] = m_vertexList[tri->v1].x;
-    vertices[4] = m_vertexList[tri->v1].y;
-    vertices[5] = m_vertexList[tri->v1].z;
-    vertices[6] = m_vertexList[tri->v2].x;
-    vertices[7] = m_vertexList[tri->v2].y;
-    vertices[8] = m_vertexList[tri->v2].z;
+    vertices[0] = m_vertexX[tri->v0];
+    vertices[1] = m_vertexY[tri->v0];
+    vertices[2] = m_vertexZ[tri->v0];
+    vertices[3] = m_vertexX[tri->v1];
+    vertices[4] = m_vertexY[tri->v1];
+    vertices[5] = m_vertexZ[tri->v1];
+    vertices[6] = m_vertexX[tri->v2];
+    vertices[7] = m_vertexY[tri->v2];
+    vertices[8] = m_vertexZ[tri->v2];
 }
 
 void FluidSac::LateInitialisation()
@@ -306,13 +322,24 @@ std::string *FluidSac::createFromAttributes()
         m_triangleList[i].v0 = size_t(GSUtil::Int(markerIndices[i * 3 + 0]));
         m_triangleList[i].v1 = size_t(GSUtil::Int(markerIndices[i * 3 + 1]));
         m_triangleList[i].v2 = size_t(GSUtil::Int(markerIndices[i * 3 + 2]));
-        m_triangleList[i].area = 0;
-        m_triangleList[i].normal = {0, 0, 0};
-        m_triangleList[i].centroid = {0, 0, 0};
+        if (m_triangleList[i].v0 >= numMarkers || m_triangleList[i].v1 >= numMarkers || m_triangleList[i].v2 >= numMarkers)
+        {
+            setLastError("FLUIDSAC ID=\""s + name() +"\" TriangleIndexList index out of range"s);
+            return lastErrorPtr();
+        }
     }
     // create the storage for the derived values
-    m_vertexList.resize(m_markerList.size());
-    m_pointForceList.resize(m_triangleList.size() * 3);
+    m_vertexX.assign(numMarkers, 0);
+    m_vertexY.assign(numMarkers, 0);
+    m_vertexZ.assign(numMarkers, 0);
+    m_velocityX.assign(numMarkers, 0);
+    m_velocityY.assign(numMarkers, 0);
+    m_velocityZ.assign(numMarkers, 0);
+    m_forceX.assign(numMarkers, 0);
+    m_forceY.assign(numMarkers, 0);
+    m_forceZ.assign(numMarkers, 0);
+    m_pointForceList.resize(numMarkers);
+    for (size_t i = 0; i < numMarkers; i++) m_pointForceList[i].body = m_markerList[i]->GetBody();
 
     std::vector<NamedObject *> upstreamObjects;
     upstreamObjects.reserve(m_markerList.size());
@@ -368,7 +395,7 @@ std::string FluidSac::dumpToString()
     ss << simulation()->GetTime() << "\t" << m_sacVolume << "\t" << m_pressure << "\t" << m_pointForceList.size();
     for (size_t i = 0; i < m_pointForceList.size(); i++)
     {
-        ss << "\t" << m_pointForceList[i].body->name() << "\t" << m_pointForceList[i].point[0] << "\t" << m_pointForceList[i].point[1] << "\t" << m_pointForceList[i].point[2] << "\t" <<
+        ss << "\t" << (m_pointForceList[i].body ? m_pointForceList[i].body->name() : "World"s) << "\t" << m_pointForceList[i].point[0] << "\t" << m_pointForceList[i].point[1] << "\t" << m_pointForceList[i].point[2] << "\t" <<
               m_pointForceList[i].vector[0] << "\t" << m_pointForceList[i].vector[1] << "\t" << m_pointForceList[i].vector[2];
     }
     ss << "\n";
@@ -27,9 +27,6 @@ public:
     struct Triangle
     {
         size_t v0; size_t v1; size_t v2;
-        double area;
-        pgd::Vector3 normal;
-        pgd::Vector3 centroid;
     };
 
     static double signedVolumeOfTriangle(pgd::Vector3 p1, pgd::Vector3 p2, pgd::Vector3 p3);
@@ -65,9 +62,19 @@ public:
 private:
     std::vector<FluidSac::Triangle> m_triangleList;
     std::vector<Marker *> m_markerList;
-    std::vector<pgd::Vector3> m_vertexList;
     std::vector<PointForce> m_pointForceList;
 
+    // per marker working values stored as separate x, y, z arrays and allocated once in createFromAttributes
+    std::vector<double> m_vertexX;
+    std::vector<double> m_vertexY;
+    std::vector<double> m_vertexZ;
+    std::vector<double> m_velocityX;
+    std::vector<double> m_velocityY;
+    std::vector<double> m_velocityZ;
+    std::vector<double> m_forceX;
+    std::vector<double> m_forceY;
+    std::vector<double> m_forceZ;
+
     double m_sacVolume = 0;
     double m_pressure = 0;
     // double m_lastSacVolume = 0;
@@ -9,6 +9,7 @@
 
 #if defined(_WIN32) || defined(WIN32)
 #include <Windows.h>
+#include <Psapi.h>
 #endif
 
 #include "GSUtil.h"
@@ -30,9 +31,12 @@
 #include <cinttypes>
 #include <cstdarg>
 #include <chrono>
+#include <algorithm>
+#include <functional>
 
 #if !defined(_WIN32) && !defined(WIN32)
 #include <sys/time.h>
+#include <sys/resource.h>
 #include <arpa/inet.h>
 #endif
 
@@ -604,6 +608,23 @@ double GSUtil::GetTime()
 #endif
 }
 
+uint64_t GSUtil::GetPeakMemoryUsage()
+{
+#if defined(_WIN32) || defined(WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return uint64_t(counters.PeakWorkingSetSize);
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) return 0;
+#if defined(__APPLE__)
+    return uint64_t(usage.ru_maxrss); // macOS reports bytes
+#else
+    return uint64_t(usage.ru_maxrss) * 1024; // linux reports kilobytes
+#endif
+#endif
+}
+
 int GSUtil::QuickInt(const char *p)
 {
     int x = 0;
@@ -2318,3 +2339,43 @@ double GSUtil::zeroin(double ax, double bx, double (*f)(double x, void *info), v
 }
 
 #endif
+
+// this fills table with g(x) at tableSize + 1 evenly spaced points from 0 to 1 inclusive
+// (a tableSize of zero gives an empty table)
+void GSUtil::TabulateUnitInterval(size_t tableSize, const std::function<double(double x)> &g, std::vector<double> *table)
+{
+    table->clear();
+    if (tableSize == 0) return;
+    table->resize(tableSize + 1);
+    for (size_t i = 0; i <= tableSize; i++)
+    {
+        double x = (i == tableSize) ? 1.0 : double(i) / double(tableSize);
+        (*table)[i] = g(x);
+    }
+}
+
+// this finds the x in [0, 1] where g(x) == target using a monotonic table from TabulateUnitInterval
+// and f(x, info) which must return g(x) - target. The binary search finds the bracketing interval so zeroin
+// is only needed within that single interval which takes far fewer calls to f than the full range.
+// Out of range targets return the end of the range.
+double GSUtil::InvertUnitIntervalTable(const std::vector<double> &table, double target, double (*f)(double x, void *info), void *info, double tol)
+{
+    size_t n = table.size() - 1;
+    bool increasing = table.back() > table.front();
+    auto it = increasing ? std::lower_bound(table.begin(), table.end(), target) :
+                           std::lower_bound(table.begin(), table.end(), target, std::greater<double>());
+    size_t index = size_t(it - table.begin());
+    if (index == 0)
+    {
+        (*f)(0, info);
+        return 0;
+    }
+    if (index > n)
+    {
+        (*f)(1, info);
+        return 1;
+    }
+    double low = double(index - 1) / double(n);
+    double high = (index == n) ? 1.0 : double(index) / double(n);
+    return zeroin(low, high, f, info, tol);
+}
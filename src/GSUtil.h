@@ -19,6 +19,7 @@
 #include <cmath>
 #include <stdlib.h>
 #include <vector>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <stdint.h>
@@ -502,6 +503,7 @@ static void FindAndReplace( std::string *source, const std::string &find, const
 static void FindBoundsCheck(double *list, double x, int *lowBound, int *highBound); // might be quicker than BinarySearchRange for special case
 static void FindBounds(double *list, double x, int *lowBound, int *highBound);
 static double GetTime();
+static uint64_t GetPeakMemoryUsage(); // peak resident memory in bytes (0 if unknown)
 static int QuickInt(const char *p);
 static double QuickDouble(const char *p);
 static double QuickPow(double base, int exp);
@@ -594,6 +596,8 @@ static void nelmin ( double fn ( double x[] , void *data ), void *data, int n, d
                      double *ynewlo, double reqmin, double step[], int konvge, int kcount,
                      int *icount, int *numres, int *ifault );
 static double zeroin(double ax, double bx, double (*f)(double x, void *info), void *info, double tol);
+static void TabulateUnitInterval(size_t tableSize, const std::function<double(double x)> &g, std::vector<double> *table);
+static double InvertUnitIntervalTable(const std::vector<double> &table, double target, double (*f)(double x, void *info), void *info, double tol);
 
 };
 
@@ -18,6 +18,7 @@
 #include "ode/ode.h"
 
 #include <vector>
+#include <cstdint>
 
 class Contact;
 class SimulationWindow;
@@ -78,6 +79,10 @@ public:
     std::vector<Contact *> *GetContactList() { return &m_ContactList; }
     void ClearContacts() { m_ContactList.clear(); }
 
+    // index into the simulation contact aggregate list
+    void SetContactAggregateIndex(size_t contactAggregateIndex) { m_ContactAggregateIndex = contactAggregateIndex; }
+    size_t GetContactAggregateIndex() { return m_ContactAggregateIndex; }
+
     std::vector<Geom *> *GetExcludeList() { return &m_ExcludeList; }
 
     virtual std::string dumpToString();
@@ -107,6 +112,7 @@ private:
     bool m_Adhesion = false;
 
     std::vector<Contact *> m_ContactList;
+    size_t m_ContactAggregateIndex = SIZE_MAX;
 
     Marker *m_geomMarker = nullptr;
 
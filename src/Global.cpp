@@ -114,6 +114,96 @@ void Global::setAngularDamping(double AngularDamping)
     m_AngularDamping = AngularDamping;
 }
 
+double Global::ControlPeriod() const
+{
+    return m_ControlPeriod;
+}
+
+void Global::setControlPeriod(double ControlPeriod)
+{
+    m_ControlPeriod = ControlPeriod;
+}
+
+int Global::DumpInterval() const
+{
+    return m_DumpInterval;
+}
+
+void Global::setDumpInterval(int DumpInterval)
+{
+    m_DumpInterval = DumpInterval;
+}
+
+double Global::DumpTimeInterval() const
+{
+    return m_DumpTimeInterval;
+}
+
+void Global::setDumpTimeInterval(double DumpTimeInterval)
+{
+    m_DumpTimeInterval = DumpTimeInterval;
+}
+
+double Global::DumpStartTime() const
+{
+    return m_DumpStartTime;
+}
+
+void Global::setDumpStartTime(double DumpStartTime)
+{
+    m_DumpStartTime = DumpStartTime;
+}
+
+double Global::DumpEndTime() const
+{
+    return m_DumpEndTime;
+}
+
+void Global::setDumpEndTime(double DumpEndTime)
+{
+    m_DumpEndTime = DumpEndTime;
+}
+
+double Global::DumpQuantisation() const
+{
+    return m_DumpQuantisation;
+}
+
+void Global::setDumpQuantisation(double DumpQuantisation)
+{
+    m_DumpQuantisation = DumpQuantisation;
+}
+
+std::string Global::DumpTriggers() const
+{
+    return m_DumpTriggers;
+}
+
+void Global::setDumpTriggers(const std::string &DumpTriggers)
+{
+    m_DumpTriggers = DumpTriggers;
+}
+
+double Global::DumpPreTriggerTime() const
+{
+    return m_DumpPreTriggerTime;
+}
+
+void Global::setDumpPreTriggerTime(double DumpPreTriggerTime)
+{
+    m_DumpPreTriggerTime = DumpPreTriggerTime;
+}
+
+double Global::DumpPostTriggerTime() const
+{
+    return m_DumpPostTriggerTime;
+}
+
+void Global::setDumpPostTriggerTime(double DumpPostTriggerTime)
+{
+    m_DumpPostTriggerTime = DumpPostTriggerTime;
+}
+
 // this function initialises the data in the object based on the contents
 // of an xml_node node. It uses information from the simulation as required
 // to satisfy dependencies
@@ -231,6 +321,15 @@ std::string *Global::createFromAttributes()
     findAttribute("AllowConnectedCollisions", &buf);
     if (buf.size()) m_AllowConnectedCollisions = GSUtil::Bool(buf);
 
+    if (findAttribute("ControlPeriod"s, &buf)) this->setControlPeriod(GSUtil::Double(buf));
+    if (findAttribute("DumpInterval"s, &buf)) this->setDumpInterval(GSUtil::Int(buf));
+    if (findAttribute("DumpTimeInterval"s, &buf)) this->setDumpTimeInterval(GSUtil::Double(buf));
+    if (findAttribute("DumpStartTime"s, &buf)) this->setDumpStartTime(GSUtil::Double(buf));
+    if (findAttribute("DumpEndTime"s, &buf)) this->setDumpEndTime(GSUtil::Double(buf));
+    if (findAttribute("DumpQuantisation"s, &buf)) this->setDumpQuantisation(GSUtil::Double(buf));
+    if (findAttribute("DumpTriggers"s, &buf)) this->setDumpTriggers(buf);
+    if (findAttribute("DumpPreTriggerTime"s, &buf)) this->setDumpPreTriggerTime(GSUtil::Double(buf));
+    if (findAttribute("DumpPostTriggerTime"s, &buf)) this->setDumpPostTriggerTime(GSUtil::Double(buf));
     if (findAttribute("LinearDamping"s, &buf)) this->setLinearDamping(GSUtil::Double(buf));
     if (findAttribute("AngularDamping"s, &buf)) this->setAngularDamping(GSUtil::Double(buf));
 
@@ -310,6 +409,16 @@ void Global::appendToAttributes()
     setAttribute("ContactMaxCorrectingVel", *GSUtil::ToString(m_ContactMaxCorrectingVel, &buf));
     setAttribute("ContactSurfaceLayer", *GSUtil::ToString(m_ContactSurfaceLayer, &buf));
     setAttribute("DistanceTravelledBodyID", m_DistanceTravelledBodyIDName);
+    // the control period and dump options are only written when they differ from the defaults to keep the files tidy
+    if (m_ControlPeriod != 0) setAttribute("ControlPeriod", *GSUtil::ToString(m_ControlPeriod, &buf));
+    if (m_DumpEndTime >= 0) setAttribute("DumpEndTime", *GSUtil::ToString(m_DumpEndTime, &buf));
+    if (m_DumpInterval != 1) setAttribute("DumpInterval", *GSUtil::ToString(m_DumpInterval, &buf));
+    if (m_DumpPostTriggerTime != 0.1) setAttribute("DumpPostTriggerTime", *GSUtil::ToString(m_DumpPostTriggerTime, &buf));
+    if (m_DumpPreTriggerTime != 0.1) setAttribute("DumpPreTriggerTime", *GSUtil::ToString(m_DumpPreTriggerTime, &buf));
+    if (m_DumpQuantisation != 0) setAttribute("DumpQuantisation", *GSUtil::ToString(m_DumpQuantisation, &buf));
+    if (m_DumpStartTime != 0) setAttribute("DumpStartTime", *GSUtil::ToString(m_DumpStartTime, &buf));
+    if (m_DumpTimeInterval != 0) setAttribute("DumpTimeInterval", *GSUtil::ToString(m_DumpTimeInterval, &buf));
+    if (m_DumpTriggers.size()) setAttribute("DumpTriggers", m_DumpTriggers);
     setAttribute("ERP", *GSUtil::ToString(m_ERP, &buf));
     setAttribute("FitnessType", fitnessTypeStrings(m_FitnessType));
     setAttribute("LinearDamping", *GSUtil::ToString(m_LinearDamping, &buf));
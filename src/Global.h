@@ -124,6 +124,33 @@ public:
     double NumericalErrorsScore() const;
     void setNumericalErrorsScore(double NumericalErrorsScore);
 
+    double ControlPeriod() const;
+    void setControlPeriod(double ControlPeriod);
+
+    int DumpInterval() const;
+    void setDumpInterval(int DumpInterval);
+
+    double DumpTimeInterval() const;
+    void setDumpTimeInterval(double DumpTimeInterval);
+
+    double DumpStartTime() const;
+    void setDumpStartTime(double DumpStartTime);
+
+    double DumpEndTime() const;
+    void setDumpEndTime(double DumpEndTime);
+
+    double DumpQuantisation() const;
+    void setDumpQuantisation(double DumpQuantisation);
+
+    std::string DumpTriggers() const;
+    void setDumpTriggers(const std::string &DumpTriggers);
+
+    double DumpPreTriggerTime() const;
+    void setDumpPreTriggerTime(double DumpPreTriggerTime);
+
+    double DumpPostTriggerTime() const;
+    void setDumpPostTriggerTime(double DumpPostTriggerTime);
+
 private:
     FitnessType m_FitnessType = KinematicMatch;
     StepType m_StepType = World;
@@ -148,6 +175,15 @@ private:
     double m_LinearDamping = 0;
     double m_AngularDamping = 0;
     double m_NumericalErrorsScore = 0;
+    double m_ControlPeriod = 0; // the default time between driver updates (0 means every step)
+    int m_DumpInterval = 1; // the default number of steps between dump records
+    double m_DumpTimeInterval = 0; // the default time between dump records (0 means use m_DumpInterval)
+    double m_DumpStartTime = 0;
+    double m_DumpEndTime = -1; // less than zero means no end time
+    double m_DumpQuantisation = 0; // the default quantum for compressed dump files (0 means lossless)
+    std::string m_DumpTriggers; // space separated events that turn dumping on (empty means always dump)
+    double m_DumpPreTriggerTime = 0.1; // how much history is written when a trigger fires
+    double m_DumpPostTriggerTime = 0.1; // how long dumping continues after a trigger
     std::string m_CurrentWarehouseFile;
     std::string m_DistanceTravelledBodyIDName;
     std::vector<std::string> m_MeshSearchPath = {"."s};
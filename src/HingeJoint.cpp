@@ -72,6 +72,7 @@ void HingeJoint::SetTorqueLimits(double loStopTorqueLimit, double hiStopTorqueLi
 {
     m_LoStopTorqueLimit = loStopTorqueLimit;
     m_HiStopTorqueLimit = hiStopTorqueLimit;
+    m_torqueLimitsSet = true;
 }
 
 void HingeJoint::SetJointStops(double loStop, double hiStop)
@@ -315,29 +316,29 @@ void HingeJoint::appendToAttributes()
 
 std::string HingeJoint::dumpToString()
 {
-    std::stringstream ss;
-    ss.precision(17);
-    ss.setf(std::ios::scientific);
-    if (firstDump())
-    {
-        setFirstDump(false);
-        ss << "Time\tXP\tYP\tZP\tXP2\tYP2\tZP2\tXA\tYA\tZA\tAngle\tAngleRate\tFX1\tFY1\tFZ1\tTX1\tTY1\tTZ1\tFX2\tFY2\tFZ2\tTX2\tTY2\tTZ2\tStopTorque\n";
-    }
+    return dumpValuesToString();
+}
+
+std::vector<std::string> HingeJoint::dumpNames() const
+{
+    return {"Time"s, "XP"s, "YP"s, "ZP"s, "XP2"s, "YP2"s, "ZP2"s, "XA"s, "YA"s, "ZA"s, "Angle"s, "AngleRate"s, "FX1"s, "FY1"s, "FZ1"s, "TX1"s, "TY1"s, "TZ1"s, "FX2"s, "FY2"s, "FZ2"s, "TX2"s, "TY2"s, "TZ2"s, "StopTorque"s};
+}
+
+void HingeJoint::dumpValues(std::vector<double> *values)
+{
     dVector3 p, p2, a;
     GetHingeAnchor(p);
     GetHingeAnchor2(p2);
     GetHingeAxis(a);
 
-    ss << simulation()->GetTime() << "\t" << p[0] << "\t" << p[1] << "\t" << p[2] << "\t" <<
-          p2[0] << "\t" << p2[1] << "\t" << p2[2] << "\t" <<
-          a[0] << "\t" << a[1] << "\t" << a[2] << "\t" << GetHingeAngle() << "\t" << GetHingeAngleRate() << "\t" <<
-          JointFeedback()->f1[0] << "\t" << JointFeedback()->f1[1] << "\t" << JointFeedback()->f1[2] << "\t" <<
-          JointFeedback()->t1[0] << "\t" << JointFeedback()->t1[1] << "\t" << JointFeedback()->t1[2] << "\t" <<
-          JointFeedback()->f2[0] << "\t" << JointFeedback()->f2[1] << "\t" << JointFeedback()->f2[2] << "\t" <<
-          JointFeedback()->t2[0] << "\t" << JointFeedback()->t2[1] << "\t" << JointFeedback()->t2[2] << "\t" <<
-          m_axisTorque <<
-          "\n";
-    return ss.str();
+    *values = {simulation()->GetTime(), p[0], p[1], p[2],
+               p2[0], p2[1], p2[2],
+               a[0], a[1], a[2], GetHingeAngle(), GetHingeAngleRate(),
+               JointFeedback()->f1[0], JointFeedback()->f1[1], JointFeedback()->f1[2],
+               JointFeedback()->t1[0], JointFeedback()->t1[1], JointFeedback()->t1[2],
+               JointFeedback()->f2[0], JointFeedback()->f2[1], JointFeedback()->f2[2],
+               JointFeedback()->t2[0], JointFeedback()->t2[1], JointFeedback()->t2[2],
+               m_axisTorque};
 }
 
 
@@ -39,10 +39,13 @@ public:
 
     void SetTorqueLimits(double loStopTorqueLimit, double hiStopTorqueLimit);
     int TestLimits();
+    bool HasTorqueLimits() const { return m_torqueLimitsSet; }
     void SetStopTorqueWindow(int window);
 
     virtual void Update();
     virtual std::string dumpToString();
+    virtual std::vector<std::string> dumpNames() const;
+    virtual void dumpValues(std::vector<double> *values);
     virtual std::string *createFromAttributes();
     virtual void appendToAttributes();
 
@@ -52,6 +55,7 @@ private:
 
     double m_HiStopTorqueLimit = dInfinity;
     double m_LoStopTorqueLimit = -dInfinity;
+    bool m_torqueLimitsSet = false;
     double m_axisTorque = 0;
 
     std::vector<double> m_axisTorqueList;
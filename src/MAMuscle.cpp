@@ -199,19 +199,19 @@ void MAMuscle::appendToAttributes()
 
 std::string MAMuscle::dumpToString()
 {
-    std::stringstream ss;
-    ss.precision(17);
-    ss.setf(std::ios::scientific);
-    if (firstDump())
-    {
-        setFirstDump(false);
-        ss << "Time\tVMax\tF0\tK\tAlpha\tFCE\tLCE\tVCE\tPMECH\tPMET\n";
-    }
-    ss << simulation()->GetTime() << "\t" << m_VMax << "\t" << m_F0 << "\t" << m_K << "\t" << m_Alpha <<
-          "\t" << GetStrap()->GetTension() << "\t" << GetStrap()->GetLength() << "\t" << GetStrap()->GetVelocity() <<
-          "\t" << GetStrap()->GetVelocity() * GetStrap()->GetTension() << "\t" << GetMetabolicPower() <<
-          "\n";
-    return ss.str();
+    return dumpValuesToString();
+}
+
+std::vector<std::string> MAMuscle::dumpNames() const
+{
+    return {"Time"s, "VMax"s, "F0"s, "K"s, "Alpha"s, "FCE"s, "LCE"s, "VCE"s, "PMECH"s, "PMET"s};
+}
+
+void MAMuscle::dumpValues(std::vector<double> *values)
+{
+    *values = {simulation()->GetTime(), m_VMax, m_F0, m_K, m_Alpha,
+               GetStrap()->GetTension(), GetStrap()->GetLength(), GetStrap()->GetVelocity(),
+               GetStrap()->GetVelocity() * GetStrap()->GetTension(), GetMetabolicPower()};
 }
 
 
@@ -39,6 +39,8 @@ public:
     virtual double GetElasticEnergy();
 
     virtual std::string dumpToString();
+    virtual std::vector<std::string> dumpNames() const;
+    virtual void dumpValues(std::vector<double> *values);
 
     virtual std::string *createFromAttributes();
     virtual void appendToAttributes();
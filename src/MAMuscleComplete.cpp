@@ -177,15 +177,22 @@ void MAMuscleComplete::LateInitialisation()
 
 void MAMuscleComplete::SetActivation()
 {
-    double activation = dataSum();
     // set variable input parameters
-
-    if (activation < m_MinimumActivation) activation = m_MinimumActivation;
-    else if (activation > 1) activation = 1;
-    m_Stim = activation;
+    // the stimulation only changes when the summed driver input changes
+    if (dataSumChanged())
+    {
+        double activation = dataSum();
+        if (activation < m_MinimumActivation) activation = m_MinimumActivation;
+        else if (activation > 1) activation = 1;
+        m_Stim = activation;
+    }
 
     m_Params.timeIncrement = simulation()->GetTimeIncrement();
-    if (m_ActivationKinetics || m_ActivationRate != 0)
+    if (m_Params.alpha == m_Stim)
+    {
+        // nothing to do because the activation has already reached the stimulation
+    }
+    else if (m_ActivationKinetics || m_ActivationRate != 0)
     {
         if (m_Params.alpha == -1) // special case for first run through if I just want disable rate
         {
@@ -792,23 +799,23 @@ void MAMuscleComplete::setParallelStrainModel(const std::string &parallelStrainM
 
 std::string MAMuscleComplete::dumpToString()
 {
-    std::stringstream ss;
-    ss.precision(17);
-    ss.setf(std::ios::scientific);
-    if (firstDump())
-    {
-        setFirstDump(false);
-        ss << "Time\tm_Stim\talpha\tlen\tv\tlastlpe\tfce\tlpe\tfpe\tlse\tfse\tvce\tvse\ttargetFce\tf0\terr\tESE\tEPE\tPSE\tPPE\tPCE\ttension\tlength\tvelocity\tPMECH\tPMET\n";
-    }
-    ss << simulation()->GetTime() << "\t" <<
-          m_Stim << "\t" << m_Params.alpha << "\t" << m_Params.len << "\t" << m_Params.v << "\t" << m_Params.lastlpe << "\t" <<
-          m_Params.fce << "\t" << m_Params.lpe << "\t" << m_Params.fpe << "\t" << m_Params.lse << "\t" << m_Params.fse << "\t" <<
-          m_Params.vce << "\t" << m_Params.vse << "\t" << m_Params.targetFce << "\t" << m_Params.f0 << "\t" << m_Params.err << "\t" <<
-          GetESE() << "\t" << GetEPE() << "\t" << GetPSE() << "\t" << GetPPE() << "\t" << GetPCE() << "\t" <<
-          GetTension() << "\t" << GetLength() << "\t" << GetVelocity() << "\t" <<
-          GetPower() << "\t" << GetMetabolicPower() <<
-          "\n";
-    return ss.str();
+    return dumpValuesToString();
+}
+
+std::vector<std::string> MAMuscleComplete::dumpNames() const
+{
+    return {"Time"s, "m_Stim"s, "alpha"s, "len"s, "v"s, "lastlpe"s, "fce"s, "lpe"s, "fpe"s, "lse"s, "fse"s, "vce"s, "vse"s, "targetFce"s, "f0"s, "err"s, "ESE"s, "EPE"s, "PSE"s, "PPE"s, "PCE"s, "tension"s, "length"s, "velocity"s, "PMECH"s, "PMET"s};
+}
+
+void MAMuscleComplete::dumpValues(std::vector<double> *values)
+{
+    *values = {simulation()->GetTime(),
+               m_Stim, m_Params.alpha, m_Params.len, m_Params.v, m_Params.lastlpe,
+               m_Params.fce, m_Params.lpe, m_Params.fpe, m_Params.lse, m_Params.fse,
+               m_Params.vce, m_Params.vse, m_Params.targetFce, m_Params.f0, m_Params.err,
+               GetESE(), GetEPE(), GetPSE(), GetPPE(), GetPCE(),
+               GetTension(), GetLength(), GetVelocity(),
+               GetPower(), GetMetabolicPower()};
 }
 
 
@@ -108,6 +108,8 @@ public:
     double GetSPE() { return m_Params.spe; }
 
     virtual std::string dumpToString();
+    virtual std::vector<std::string> dumpNames() const;
+    virtual void dumpValues(std::vector<double> *values);
     virtual void LateInitialisation();
 
     virtual std::string *createFromAttributes();
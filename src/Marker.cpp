@@ -29,12 +29,14 @@ Marker::Marker(Body *body)
 void Marker::SetPosition(double x, double y, double z)
 {
     m_position.x = x; m_position.y = y; m_position.z = z;
+    InvalidateWorldCache();
 }
 
 void Marker::SetQuaternion(double qs0, double qx1, double qy2, double qz3)
 {
     m_quaternion.n = qs0;
     m_quaternion.x = qx1; m_quaternion.y = qy2; m_quaternion.z = qz3;
+    InvalidateWorldCache();
 }
 
 // parses the position allowing a relative position specified by BODY ID
@@ -301,6 +303,7 @@ std::string *Marker::SetWorldQuaternion(double qs0, double qx1, double qy2, doub
 void Marker::OffsetPosition(double x, double y, double z)
 {
     m_position.x += x; m_position.y += y; m_position.z += z;
+    InvalidateWorldCache();
 }
 
 pgd::Vector3 Marker::GetPosition() const
@@ -349,8 +352,8 @@ pgd::Vector3 Marker::GetWorldPosition() const
 //        dVector3 p;
 //        dBodyGetRelPointPos(m_body->GetBodyID(), m_position.x, m_position.y, m_position.z, p);
 //        return pgd::Vector3(p[0], p[1], p[2]);
-        pgd::Vector3 bodyWorldPosition = pgd::QVRotate(m_body->GetQuaternion(), m_position) + pgd::Vector3(m_body->GetPosition());
-        return bodyWorldPosition;
+        UpdateWorldPoseCache();
+        return m_worldPositionCache;
     }
     else
     {
@@ -395,19 +398,8 @@ pgd::Vector3 Marker::GetWorldLinearVelocity()
 {
     if (m_body)
     {
-        // get the velocity in world coordinates
-        pgd::Vector3 worldVelocity(m_body->GetLinearVelocity());
-        pgd::Vector3 av(m_body->GetAngularVelocity());
-        pgd::Quaternion q(m_body->GetQuaternion());
-        pgd::Vector3 p = pgd::QVRotate(q, m_position);
-        pgd::Vector3 v1 = pgd::Cross(av, p);
-        worldVelocity += v1;
-#ifdef CHECK_MARKER_MATH
-        dVector3 p1;
-        dBodyGetRelPointVel(m_body->GetBodyID(), m_position.x, m_position.y, m_position.z, p1);
-        worldVelocity.Set(p1[0], p1[1], p1[2]);
-#endif
-        return worldVelocity;
+        UpdateWorldVelocityCache();
+        return m_worldLinearVelocityCache;
     }
     else
     {
@@ -426,9 +418,8 @@ pgd::Quaternion Marker::GetWorldQuaternion() const
 {
     if (m_body)
     {
-        const double *bodyRotation = m_body->GetQuaternion();
-        pgd::Quaternion bodyQuaternion(bodyRotation[0], bodyRotation[1], bodyRotation[2], bodyRotation[3]);
-        return bodyQuaternion * m_quaternion;
+        UpdateWorldPoseCache();
+        return m_worldQuaternionCache;
     }
     else
     {
@@ -466,20 +457,20 @@ void Marker::GetWorldBasis(pgd::Vector3 *x, pgd::Vector3 *y, pgd::Vector3 *z)
 
 std::string Marker::dumpToString()
 {
-    std::stringstream ss;
-    ss.precision(17);
-    ss.setf(std::ios::scientific);
-    if (firstDump())
-    {
-        setFirstDump(false);
-        ss << "Time\tXP\tYP\tZP\tQW\tQX\tQY\tQZ\n";
-    }
+    return dumpValuesToString();
+}
+
+std::vector<std::string> Marker::dumpNames() const
+{
+    return {"Time"s, "XP"s, "YP"s, "ZP"s, "QW"s, "QX"s, "QY"s, "QZ"s};
+}
+
+void Marker::dumpValues(std::vector<double> *values)
+{
     pgd::Vector3 p = GetWorldPosition();
     pgd::Quaternion q = GetWorldQuaternion();
 
-    ss << simulation()->GetTime() << "\t" << p.x << "\t" << p.y << "\t" << p.z <<
-          "\t" << q.n << "\t" << q.x << "\t" << q.y << "\t" << q.z << "\n";
-    return ss.str();
+    *values = {simulation()->GetTime(), p.x, p.y, p.z, q.n, q.x, q.y, q.z};
 }
 
 // this function initialises the data in the object based on the contents
@@ -544,6 +535,23 @@ void Marker::appendToAttributes()
     setAttribute("WorldPosition"s, *GSUtil::ToString(GetWorldPosition(), &buf));
 }
 
+void Marker::appendStateValues(std::vector<double> *values)
+{
+    NamedObject::appendStateValues(values);
+    pgd::Quaternion q = GetWorldQuaternion();
+    pgd::Vector3 p = GetWorldPosition();
+    values->insert(values->end(), {q.n, q.x, q.y, q.z, p.x, p.y, p.z});
+}
+
+const double *Marker::stateValuesToAttributes(const double *values, std::map<std::string, std::string> *attributeMap) const
+{
+    values = NamedObject::stateValuesToAttributes(values, attributeMap);
+    std::string buf;
+    (*attributeMap)["WorldQuaternion"s] = *GSUtil::ToString(pgd::Quaternion(values[0], values[1], values[2], values[3]), &buf);
+    (*attributeMap)["WorldPosition"s] = *GSUtil::ToString(pgd::Vector3(values[4], values[5], values[6]), &buf);
+    return values + 7;
+}
+
 Body *Marker::GetBody() const
 {
     return m_body;
@@ -552,5 +560,52 @@ Body *Marker::GetBody() const
 void Marker::SetBody(Body *body)
 {
     m_body = body;
+    InvalidateWorldCache();
+}
+
+void Marker::InvalidateWorldCache()
+{
+    m_worldPoseCacheValid = false;
+    m_worldVelocityCacheValid = false;
+}
+
+// the world pose only needs recalculating if the step has changed or the body has been moved
+void Marker::UpdateWorldPoseCache() const
+{
+    int64_t stepCount = simulation() ? simulation()->GetStepCount() : -1;
+    uint64_t bodyStateVersion = m_body->GetStateVersion();
+    if (m_worldPoseCacheValid && m_worldPoseCacheStepCount == stepCount && m_worldPoseCacheBodyStateVersion == bodyStateVersion) return;
+
+    const double *bodyRotation = m_body->GetQuaternion();
+    pgd::Quaternion bodyQuaternion(bodyRotation[0], bodyRotation[1], bodyRotation[2], bodyRotation[3]);
+    m_worldPositionCache = pgd::QVRotate(bodyQuaternion, m_position) + pgd::Vector3(m_body->GetPosition());
+    m_worldQuaternionCache = bodyQuaternion * m_quaternion;
+    m_worldPoseCacheStepCount = stepCount;
+    m_worldPoseCacheBodyStateVersion = bodyStateVersion;
+    m_worldPoseCacheValid = true;
+}
+
+void Marker::UpdateWorldVelocityCache()
+{
+    int64_t stepCount = simulation() ? simulation()->GetStepCount() : -1;
+    uint64_t bodyStateVersion = m_body->GetStateVersion();
+    if (m_worldVelocityCacheValid && m_worldVelocityCacheStepCount == stepCount && m_worldVelocityCacheBodyStateVersion == bodyStateVersion) return;
+
+    // get the velocity in world coordinates
+    pgd::Vector3 worldVelocity(m_body->GetLinearVelocity());
+    pgd::Vector3 av(m_body->GetAngularVelocity());
+    pgd::Quaternion q(m_body->GetQuaternion());
+    pgd::Vector3 p = pgd::QVRotate(q, m_position);
+    pgd::Vector3 v1 = pgd::Cross(av, p);
+    worldVelocity += v1;
+#ifdef CHECK_MARKER_MATH
+    dVector3 p1;
+    dBodyGetRelPointVel(m_body->GetBodyID(), m_position.x, m_position.y, m_position.z, p1);
+    worldVelocity.Set(p1[0], p1[1], p1[2]);
+#endif
+    m_worldLinearVelocityCache = worldVelocity;
+    m_worldVelocityCacheStepCount = stepCount;
+    m_worldVelocityCacheBodyStateVersion = bodyStateVersion;
+    m_worldVelocityCacheValid = true;
 }
 
@@ -15,6 +15,7 @@
 #include "SmartEnum.h"
 
 #include <set>
+#include <cstdint>
 
 class Body;
 
@@ -59,18 +60,39 @@ public:
 
 
     virtual std::string dumpToString();
+    virtual std::vector<std::string> dumpNames() const;
+    virtual void dumpValues(std::vector<double> *values);
     virtual std::string *createFromAttributes();
     virtual void saveToAttributes();
     virtual void appendToAttributes();
+    virtual void appendStateValues(std::vector<double> *values);
+    virtual const double *stateValuesToAttributes(const double *values, std::map<std::string, std::string> *attributeMap) const;
 
     Body *GetBody() const;
     void SetBody(Body *body);
 
+    void InvalidateWorldCache();
+
 private:
 
+    void UpdateWorldPoseCache() const;
+    void UpdateWorldVelocityCache();
+
     Body *m_body = nullptr; // if nullptr then this is the World, otherwise a pre-existing body
     pgd::Vector3 m_position; // this is the position with respect to m_body (which can be World)
     pgd::Quaternion m_quaternion = {1, 0, 0, 0}; // this is the orientation with respect to m_body (which can be World)
+
+    // markers are queried many times per step so the world values are cached
+    // the cache is keyed on the simulation step count and the body state version
+    mutable pgd::Vector3 m_worldPositionCache;
+    mutable pgd::Quaternion m_worldQuaternionCache = {1, 0, 0, 0};
+    mutable bool m_worldPoseCacheValid = false;
+    mutable int64_t m_worldPoseCacheStepCount = -1;
+    mutable uint64_t m_worldPoseCacheBodyStateVersion = 0;
+    pgd::Vector3 m_worldLinearVelocityCache;
+    bool m_worldVelocityCacheValid = false;
+    int64_t m_worldVelocityCacheStepCount = -1;
+    uint64_t m_worldVelocityCacheBodyStateVersion = 0;
 };
 
 
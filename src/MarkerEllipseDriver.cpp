@@ -79,7 +79,7 @@ void MarkerEllipseDriver::SendData()
 
 void MarkerEllipseDriver::Update()
 {
-    assert(simulation()->GetStepCount() == lastStepCount() + 1);
+    assert(simulation()->GetStepCount() == nextUpdateStepCount());
     setLastStepCount(simulation()->GetStepCount());
 
     if (m_omegaDriver) m_omega = m_omegaDriver->value();
@@ -117,7 +117,7 @@ void MarkerEllipseDriver::Update()
     }
 
     // update m_phi depending on m_phi_dot values
-    m_phi = std::fmod(2 * M_PI + std::fmod(m_phi + m_phiDot * simulation()->GetTimeIncrement(), 2 * M_PI), 2 * M_PI); // do fmod twice to get a value from 0 to 2pi
+    m_phi = std::fmod(2 * M_PI + std::fmod(m_phi + m_phiDot * controlTimeIncrement(), 2 * M_PI), 2 * M_PI); // do fmod twice to get a value from 0 to 2pi
 
     while (true)
     {
@@ -424,7 +424,7 @@ std::string *MarkerEllipseDriver::createFromAttributes()
     Initialise(omega, sigma, XRV, YRV, phi, markerEllipseCentre, markerEllipseRim, phaseControlInput);
 
     if (findAttribute("LowPassFrequency"s, &buf) == nullptr) return lastErrorPtr();
-    m_butterworthFilter.CalculateCoefficients(GSUtil::Double(buf), 1.0 / simulation()->GetTimeIncrement());
+    m_butterworthFilter.CalculateCoefficients(GSUtil::Double(buf), 1.0 / controlTimeIncrement());
     if (findAttribute("PhaseOffset"s, &buf) == nullptr) return lastErrorPtr();
     m_phaseOffset = GSUtil::Double(buf);
     if (findAttribute("MaxPhiDot"s, &buf) == nullptr) return lastErrorPtr();
@@ -541,3 +541,24 @@ void MarkerEllipseDriver::appendToAttributes()
     if (m_XRDriver3) setAttribute("XRDriver3ID"s, m_XRDriver3->name());
     if (m_YRDriver3) setAttribute("YRDriver3ID"s, m_YRDriver3->name());
 }
+
+void MarkerEllipseDriver::appendStateValues(std::vector<double> *values)
+{
+    Driver::appendStateValues(values);
+    values->insert(values->end(), {m_omega, m_sigma});
+    values->insert(values->end(), m_XR.data(), m_XR.data() + 4);
+    values->insert(values->end(), m_YR.data(), m_YR.data() + 4);
+    values->push_back(m_phi);
+}
+
+const double *MarkerEllipseDriver::stateValuesToAttributes(const double *values, std::map<std::string, std::string> *attributeMap) const
+{
+    values = Driver::stateValuesToAttributes(values, attributeMap);
+    std::string buf;
+    (*attributeMap)["Omega"s] = *GSUtil::ToString(values[0], &buf);
+    (*attributeMap)["Sigma"s] = *GSUtil::ToString(values[1], &buf);
+    (*attributeMap)["XR"s] = *GSUtil::ToString(values + 2, 4, &buf);
+    (*attributeMap)["YR"s] = *GSUtil::ToString(values + 6, 4, &buf);
+    (*attributeMap)["Phi"s] = *GSUtil::ToString(values[10], &buf);
+    return values + 11;
+}
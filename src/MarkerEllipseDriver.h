@@ -41,6 +41,8 @@ public:
 
     virtual std::string *createFromAttributes();
     virtual void appendToAttributes();
+    virtual void appendStateValues(std::vector<double> *values);
+    virtual const double *stateValuesToAttributes(const double *values, std::map<std::string, std::string> *attributeMap) const;
 
 private:
     int detectSignChange(double value); // 0 is no change, +1 is switching to decreasing (phase = pi/2), -1 is switching to increasing (phase = 3pi/2)
@@ -31,7 +31,7 @@ MarkerPositionDriver::~MarkerPositionDriver()
 
 void MarkerPositionDriver::Update()
 {
-    assert(simulation()->GetStepCount() == lastStepCount() + 1);
+    assert(simulation()->GetStepCount() == nextUpdateStepCount());
     setLastStepCount(simulation()->GetStepCount());
 
     double time = simulation()->GetTime();
@@ -0,0 +1,104 @@
+/*
+ *  ModelStateWriter.cpp
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+#include "ModelStateWriter.h"
+#include "DataFile.h"
+#include "NamedObject.h"
+
+#include <iostream>
+#include <algorithm>
+
+using namespace std::string_literals;
+
+ModelStateWriter::ModelStateWriter()
+{
+}
+
+ModelStateWriter::~ModelStateWriter()
+{
+    Stop();
+}
+
+void ModelStateWriter::Push(std::unique_ptr<ModelState> modelState)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable())
+    {
+        m_stop = false;
+        m_thread = std::thread(&ModelStateWriter::WriterThread, this);
+    }
+    // the captured states can be large so only a few are allowed to queue up
+    m_condition.wait(lock, [this] { return m_pendingList.size() < m_maxPending; });
+    m_pendingList.push_back(std::move(modelState));
+    m_condition.notify_all();
+}
+
+void ModelStateWriter::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_thread.joinable()) return;
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+}
+
+size_t ModelStateWriter::maxPending() const
+{
+    return m_maxPending;
+}
+
+void ModelStateWriter::setMaxPending(size_t maxPending)
+{
+    m_maxPending = std::max(size_t(1), maxPending);
+}
+
+void ModelStateWriter::SetTemplate(std::vector<std::unique_ptr<ParseXML::XMLElement>> *elementList, const std::vector<NamedObject *> &objectList)
+{
+    m_elementList.swap(*elementList);
+    m_objectList = objectList;
+}
+
+const std::vector<NamedObject *> &ModelStateWriter::objectList() const
+{
+    return m_objectList;
+}
+
+void ModelStateWriter::WriterThread()
+{
+    ParseXML parseXML;
+    while (true)
+    {
+        std::unique_ptr<ModelState> modelState;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stop || m_pendingList.size(); });
+            if (m_pendingList.empty()) break; // only stop once everything has been written
+            modelState = std::move(m_pendingList.front());
+            m_pendingList.pop_front();
+        }
+        m_condition.notify_all();
+
+        // the objects only format the values passed in so they can carry on simulating
+        std::vector<std::unique_ptr<ParseXML::XMLElement>> *elementList = parseXML.elementList();
+        elementList->clear();
+        const double *values = modelState->stateValues.data();
+        for (size_t i = 0; i < m_elementList.size(); i++)
+        {
+            elementList->push_back(std::make_unique<ParseXML::XMLElement>(*m_elementList[i]));
+            values = m_objectList[i]->stateValuesToAttributes(values, &elementList->back()->attributes);
+        }
+        std::string xmlString = parseXML.SaveModel("GAITSYM2019"s, modelState->comment);
+        DataFile outputFile;
+        outputFile.SetExitOnError(false);
+        outputFile.SetRawData(xmlString.c_str(), xmlString.size());
+        if (outputFile.WriteFile(modelState->filename)) std::cerr << "Error writing model state \"" << modelState->filename << "\"\n";
+    }
+}
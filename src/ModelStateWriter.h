@@ -0,0 +1,69 @@
+/*
+ *  ModelStateWriter.h
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+// ModelStateWriter turns captured model states into XML and writes them to file on a
+// background thread. The attributes that do not change during a run are captured once
+// and each state only copies the raw values that do change. The attribute formatting,
+// XML generation and file writing all happen in the writer thread.
+
+#ifndef MODELSTATEWRITER_H
+#define MODELSTATEWRITER_H
+
+#include "ParseXML.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class NamedObject;
+
+class ModelStateWriter
+{
+public:
+    ModelStateWriter();
+    virtual ~ModelStateWriter();
+
+    struct ModelState
+    {
+        std::string filename;
+        std::string comment;
+        std::vector<double> stateValues; // from appendStateValues for each object in objectList()
+    };
+
+    // the captured attributes and the object that each element came from
+    // this has to be set before the first Push and is used for every state
+    void SetTemplate(std::vector<std::unique_ptr<ParseXML::XMLElement>> *elementList, const std::vector<NamedObject *> &objectList);
+    const std::vector<NamedObject *> &objectList() const;
+
+    // the writer thread is started when needed and this only waits if too many states are pending
+    void Push(std::unique_ptr<ModelState> modelState);
+    // writes everything that is pending and stops the thread
+    void Stop();
+
+    size_t maxPending() const;
+    void setMaxPending(size_t maxPending);
+
+private:
+    void WriterThread();
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::unique_ptr<ModelState>> m_pendingList;
+    std::vector<std::unique_ptr<ParseXML::XMLElement>> m_elementList;
+    std::vector<NamedObject *> m_objectList;
+    size_t m_maxPending = 4;
+    bool m_stop = false;
+};
+
+#endif // MODELSTATEWRITER_H
@@ -0,0 +1,350 @@
+/*
+ *  MomentArmSweep.cpp
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 18/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+#include "MomentArmSweep.h"
+#include "Simulation.h"
+#include "Body.h"
+#include "Joint.h"
+#include "Muscle.h"
+#include "Strap.h"
+#include "Marker.h"
+#include "GSUtil.h"
+
+#include "pystring.h"
+
+#include <thread>
+#include <sstream>
+#include <algorithm>
+#include <set>
+
+using namespace std::string_literals;
+
+MomentArmSweep::MomentArmSweep()
+{
+}
+
+MomentArmSweep::~MomentArmSweep()
+{
+}
+
+std::string *MomentArmSweep::AddJoint(const std::string &definition)
+{
+    std::vector<std::string> tokens;
+    pystring::split(definition, tokens);
+    if (tokens.size() != 4 && tokens.size() != 5)
+    {
+        setLastError("MomentArmSweep: \""s + definition + "\" should be \"JointID LowAngle HighAngle Steps [X|Y|Z]\""s);
+        return lastErrorPtr();
+    }
+    double lowAngle = GSUtil::Double(tokens[1]);
+    double highAngle = GSUtil::Double(tokens[2]);
+    int steps = GSUtil::Int(tokens[3]);
+    if (steps < 1)
+    {
+        setLastError("MomentArmSweep: \""s + definition + "\" Steps must be at least 1"s);
+        return lastErrorPtr();
+    }
+    Marker::Axis axis = Marker::Axis::X;
+    if (tokens.size() == 5)
+    {
+        size_t i;
+        for (i = 0; i < Marker::axisCount; i++)
+        {
+            if (tokens[4] == Marker::axisStrings(i))
+            {
+                axis = static_cast<Marker::Axis>(i);
+                break;
+            }
+        }
+        if (i >= Marker::axisCount)
+        {
+            setLastError("MomentArmSweep: \""s + definition + "\" unrecognised axis \""s + tokens[4] + "\""s);
+            return lastErrorPtr();
+        }
+    }
+    AddJoint(tokens[0], lowAngle, highAngle, size_t(steps), axis);
+    return nullptr;
+}
+
+void MomentArmSweep::AddJoint(const std::string &jointID, double lowAngle, double highAngle, size_t steps, Marker::Axis axis)
+{
+    SweepJoint sweepJoint;
+    sweepJoint.jointID = jointID;
+    sweepJoint.lowAngle = lowAngle;
+    sweepJoint.highAngle = highAngle;
+    sweepJoint.steps = std::max(steps, size_t(1));
+    sweepJoint.axis = axis;
+    m_sweepJointList.push_back(sweepJoint);
+}
+
+void MomentArmSweep::SetMuscleList(const std::vector<std::string> &muscleList)
+{
+    m_muscleList = muscleList;
+}
+
+void MomentArmSweep::SetThreads(size_t threads)
+{
+    m_threads = threads;
+}
+
+std::string *MomentArmSweep::Run(const char *xmlBuffer, size_t xmlLength)
+{
+    if (m_sweepJointList.size() == 0)
+    {
+        setLastError("MomentArmSweep: no joints have been specified"s);
+        return lastErrorPtr();
+    }
+
+    m_numRows = 1;
+    for (auto &&it : m_sweepJointList) m_numRows *= it.steps;
+
+    size_t threads = m_threads;
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    threads = std::max(std::min(threads, m_numRows), size_t(1));
+
+    // the simulation copies are created in the main thread because the ODE setup is not thread safe
+    std::vector<SweepInstance> instanceList(threads);
+    for (size_t i = 0; i < threads; i++)
+    {
+        if (CreateInstance(xmlBuffer, xmlLength, &instanceList[i])) return lastErrorPtr();
+    }
+
+    m_columnNames.clear();
+    for (auto &&it : m_sweepJointList) m_columnNames.push_back(it.jointID);
+    for (auto &&muscleIt : m_muscleList)
+    {
+        m_columnNames.push_back(muscleIt + "_Length"s);
+        for (auto &&jointIt : m_sweepJointList) m_columnNames.push_back(muscleIt + "_"s + jointIt.jointID + "_MomentArm"s);
+    }
+    m_results.assign(m_numRows * m_columnNames.size(), 0);
+
+    // each thread gets a contiguous block of rows and writes directly into its own part of m_results
+    std::vector<std::thread> threadList;
+    size_t rowsPerThread = m_numRows / threads;
+    size_t extraRows = m_numRows % threads;
+    size_t firstRow = 0;
+    for (size_t i = 0; i < threads; i++)
+    {
+        size_t lastRow = firstRow + rowsPerThread + (i < extraRows ? 1 : 0);
+        if (i == threads - 1) Calculate(&instanceList[i], firstRow, lastRow); // the main thread does the last block
+        else threadList.push_back(std::thread(&MomentArmSweep::Calculate, this, &instanceList[i], firstRow, lastRow));
+        firstRow = lastRow;
+    }
+    for (auto &&it : threadList) it.join();
+
+    return nullptr;
+}
+
+std::string *MomentArmSweep::CreateInstance(const char *xmlBuffer, size_t xmlLength, SweepInstance *instance)
+{
+    instance->simulation = std::make_unique<Simulation>();
+    std::string *errorMessage = instance->simulation->LoadModel(xmlBuffer, xmlLength);
+    if (errorMessage)
+    {
+        setLastError("MomentArmSweep: error loading model\n"s + *errorMessage);
+        return lastErrorPtr();
+    }
+    Simulation *simulation = instance->simulation.get();
+
+    for (auto &&it : *simulation->GetBodyList())
+    {
+        pgd::Vector3 position;
+        pgd::Quaternion quaternion;
+        it.second->GetPosition(&position);
+        it.second->GetQuaternion(&quaternion);
+        instance->bodyList.push_back(it.second.get());
+        instance->initialPositions.push_back(position);
+        instance->initialQuaternions.push_back(quaternion);
+    }
+
+    // the moving bodies for each joint are everything connected to Body1 without going through this joint
+    // but if that side is fixed to the world then the Body2 side is moved instead with the rotation reversed
+    // so that the angles always match the sign convention of HingeJoint::GetHingeAngle
+    for (auto &&sweepJoint : m_sweepJointList)
+    {
+        Joint *joint = simulation->GetJoint(sweepJoint.jointID);
+        if (!joint)
+        {
+            setLastError("MomentArmSweep: joint \""s + sweepJoint.jointID + "\" not found"s);
+            return lastErrorPtr();
+        }
+        std::vector<Body *> movingBodies;
+        double rotationSign = 1;
+        if (FindConnectedBodies(simulation, joint, joint->GetBody1(), joint->GetBody2(), &movingBodies) == false)
+        {
+            rotationSign = -1;
+            if (FindConnectedBodies(simulation, joint, joint->GetBody2(), joint->GetBody1(), &movingBodies) == false)
+            {
+                setLastError("MomentArmSweep: joint \""s + sweepJoint.jointID + "\" is part of a closed chain"s);
+                return lastErrorPtr();
+            }
+        }
+        instance->jointList.push_back(joint);
+        instance->movingBodyList.push_back(movingBodies);
+        instance->rotationSignList.push_back(rotationSign);
+    }
+
+    if (m_muscleList.size() == 0)
+    {
+        for (auto &&it : *simulation->GetMuscleList()) m_muscleList.push_back(it.first);
+    }
+    for (auto &&muscleID : m_muscleList)
+    {
+        Muscle *muscle = simulation->GetMuscle(muscleID);
+        if (!muscle)
+        {
+            setLastError("MomentArmSweep: muscle \""s + muscleID + "\" not found"s);
+            return lastErrorPtr();
+        }
+        instance->strapList.push_back(muscle->GetStrap());
+    }
+    return nullptr;
+}
+
+// this finds all the bodies linked to startBody except via excludeJoint
+// it returns false if the search reaches the world or stopBody
+bool MomentArmSweep::FindConnectedBodies(Simulation *simulation, Joint *excludeJoint, Body *startBody, Body *stopBody, std::vector<Body *> *connectedBodies)
+{
+    std::set<Body *> bodySet;
+    std::vector<Body *> stack = {startBody};
+    while (stack.size())
+    {
+        Body *body = stack.back();
+        stack.pop_back();
+        if (body == nullptr || body == stopBody) return false;
+        if (bodySet.count(body)) continue;
+        bodySet.insert(body);
+        for (auto &&it : *simulation->GetJointList())
+        {
+            if (it.second.get() == excludeJoint) continue;
+            if (it.second->GetBody1() == body) stack.push_back(it.second->GetBody2());
+            if (it.second->GetBody2() == body) stack.push_back(it.second->GetBody1());
+        }
+    }
+    connectedBodies->assign(bodySet.begin(), bodySet.end());
+    return true;
+}
+
+void MomentArmSweep::Calculate(SweepInstance *instance, size_t firstRow, size_t lastRow)
+{
+    size_t numJoints = m_sweepJointList.size();
+    size_t numColumns = m_columnNames.size();
+    std::vector<double> angles(numJoints);
+    std::vector<pgd::Vector3> anchors(numJoints);
+    std::vector<pgd::Vector3> axes(numJoints);
+    for (size_t row = firstRow; row < lastRow; row++)
+    {
+        // the grid is ordered with the last joint varying fastest
+        size_t index = row;
+        for (size_t j = numJoints; j > 0; j--)
+        {
+            const SweepJoint &sweepJoint = m_sweepJointList[j - 1];
+            size_t i = index % sweepJoint.steps;
+            index /= sweepJoint.steps;
+            if (sweepJoint.steps > 1) angles[j - 1] = sweepJoint.lowAngle + (sweepJoint.highAngle - sweepJoint.lowAngle) * double(i) / double(sweepJoint.steps - 1);
+            else angles[j - 1] = sweepJoint.lowAngle;
+        }
+
+        // start from the pose in the model file and then rotate the moving bodies of each joint in turn
+        for (size_t i = 0; i < instance->bodyList.size(); i++)
+        {
+            const pgd::Vector3 &p = instance->initialPositions[i];
+            const pgd::Quaternion &q = instance->initialQuaternions[i];
+            instance->bodyList[i]->SetPosition(p.x, p.y, p.z);
+            instance->bodyList[i]->SetQuaternion(q.n, q.x, q.y, q.z);
+        }
+        for (size_t j = 0; j < numJoints; j++)
+        {
+            Marker *marker = instance->jointList[j]->body1Marker();
+            pgd::Vector3 anchor = marker->GetWorldPosition();
+            pgd::Quaternion rotation = pgd::MakeQFromAxisAngle(marker->GetWorldAxis(m_sweepJointList[j].axis), angles[j] * instance->rotationSignList[j]);
+            for (auto &&body : instance->movingBodyList[j])
+            {
+                pgd::Vector3 p;
+                pgd::Quaternion q;
+                body->GetPosition(&p);
+                body->GetQuaternion(&q);
+                p = anchor + pgd::QVRotate(rotation, p - anchor);
+                q = rotation * q;
+                body->SetPosition(p.x, p.y, p.z);
+                body->SetQuaternion(q.n, q.x, q.y, q.z);
+            }
+        }
+        // later rotations can move earlier joints so the axes are read once the pose is complete
+        for (size_t j = 0; j < numJoints; j++)
+        {
+            Marker *marker = instance->jointList[j]->body1Marker();
+            anchors[j] = marker->GetWorldPosition();
+            axes[j] = marker->GetWorldAxis(m_sweepJointList[j].axis);
+        }
+
+        // the moment arm is the moment about the joint axis of the unit strap forces acting on the moving bodies
+        // so a positive moment arm means that shortening the strap increases the joint angle
+        double *output = &m_results[row * numColumns];
+        std::copy(angles.begin(), angles.end(), output);
+        output += numJoints;
+        for (auto &&strap : instance->strapList)
+        {
+            strap->Calculate();
+            *output++ = strap->Length();
+            for (size_t j = 0; j < numJoints; j++)
+            {
+                pgd::Vector3 momentArm;
+                for (auto &&pointForce : *strap->GetPointForceList())
+                {
+                    if (std::find(instance->movingBodyList[j].begin(), instance->movingBodyList[j].end(), pointForce->body) == instance->movingBodyList[j].end()) continue;
+                    pgd::Vector3 point(pointForce->point[0], pointForce->point[1], pointForce->point[2]);
+                    pgd::Vector3 direction(pointForce->vector[0], pointForce->vector[1], pointForce->vector[2]);
+                    momentArm += (point - anchors[j]) ^ direction;
+                }
+                *output++ = (momentArm * axes[j]) * instance->rotationSignList[j];
+            }
+        }
+    }
+}
+
+size_t MomentArmSweep::GetNumRows() const
+{
+    return m_numRows;
+}
+
+size_t MomentArmSweep::GetNumColumns() const
+{
+    return m_columnNames.size();
+}
+
+const std::vector<std::string> &MomentArmSweep::GetColumnNames() const
+{
+    return m_columnNames;
+}
+
+const std::vector<double> &MomentArmSweep::GetResults() const
+{
+    return m_results;
+}
+
+std::string MomentArmSweep::OutputTable() const
+{
+    std::stringstream ss;
+    ss.precision(17);
+    ss.setf(std::ios::scientific);
+    ss << pystring::join("\t"s, m_columnNames) << "\n";
+    size_t numColumns = m_columnNames.size();
+    for (size_t row = 0; row < m_numRows; row++)
+    {
+        const double *values = &m_results[row * numColumns];
+        for (size_t column = 0; column < numColumns; column++)
+        {
+            if (column) ss << "\t";
+            ss << values[column];
+        }
+        ss << "\n";
+    }
+    return ss.str();
+}
@@ -0,0 +1,90 @@
+/*
+ *  MomentArmSweep.h
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 18/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+// MomentArmSweep poses a model kinematically over a grid of joint angles and calculates the
+// strap lengths and moment arms of a list of muscles at every grid point. No dynamics are
+// involved so the whole grid can be evaluated very quickly, and the work is split across
+// threads with each thread owning its own copy of the simulation.
+
+#ifndef MOMENTARMSWEEP_H
+#define MOMENTARMSWEEP_H
+
+#include "NamedObject.h"
+#include "Marker.h"
+#include "PGDMath.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+class Simulation;
+class Body;
+class Joint;
+class Strap;
+
+class MomentArmSweep : public NamedObject
+{
+public:
+    MomentArmSweep();
+    virtual ~MomentArmSweep();
+
+    // definition is "JointID LowAngle HighAngle Steps [X|Y|Z]" with angles in radians
+    // the rotation is about the chosen axis of the joint Body1Marker (default X which is the hinge axis)
+    std::string *AddJoint(const std::string &definition);
+    void AddJoint(const std::string &jointID, double lowAngle, double highAngle, size_t steps, Marker::Axis axis);
+    void SetMuscleList(const std::vector<std::string> &muscleList);
+    void SetThreads(size_t threads);
+
+    // this creates the simulation copies and does all the calculations
+    std::string *Run(const char *xmlBuffer, size_t xmlLength);
+
+    // results are stored as a row per grid point and a column per value
+    size_t GetNumRows() const;
+    size_t GetNumColumns() const;
+    const std::vector<std::string> &GetColumnNames() const;
+    const std::vector<double> &GetResults() const;
+    std::string OutputTable() const;
+
+private:
+    struct SweepJoint
+    {
+        std::string jointID;
+        double lowAngle = 0;
+        double highAngle = 0;
+        size_t steps = 1;
+        Marker::Axis axis = Marker::Axis::X;
+    };
+
+    // all the pointers here are into a single simulation copy
+    struct SweepInstance
+    {
+        std::unique_ptr<Simulation> simulation;
+        std::vector<Body *> bodyList;
+        std::vector<pgd::Vector3> initialPositions;
+        std::vector<pgd::Quaternion> initialQuaternions;
+        std::vector<Joint *> jointList;
+        std::vector<std::vector<Body *>> movingBodyList;
+        std::vector<double> rotationSignList;
+        std::vector<Strap *> strapList;
+    };
+
+    std::string *CreateInstance(const char *xmlBuffer, size_t xmlLength, SweepInstance *instance);
+    bool FindConnectedBodies(Simulation *simulation, Joint *excludeJoint, Body *startBody, Body *stopBody, std::vector<Body *> *connectedBodies);
+    void Calculate(SweepInstance *instance, size_t firstRow, size_t lastRow);
+
+    std::vector<SweepJoint> m_sweepJointList;
+    std::vector<std::string> m_muscleList;
+    size_t m_threads = 0;
+
+    std::vector<std::string> m_columnNames;
+    std::vector<double> m_results;
+    size_t m_numRows = 0;
+};
+
+#endif // MOMENTARMSWEEP_H
@@ -44,6 +44,35 @@ std::string NamedObject::dumpToString()
     return s;
 }
 
+std::vector<std::string> NamedObject::dumpNames() const
+{
+    return std::vector<std::string>();
+}
+
+void NamedObject::dumpValues(std::vector<double> *values)
+{
+    values->clear();
+}
+
+std::string NamedObject::dumpValuesToString()
+{
+    std::stringstream ss;
+    ss.precision(17);
+    ss.setf(std::ios::scientific);
+    if (firstDump())
+    {
+        setFirstDump(false);
+        std::vector<std::string> names = dumpSelectedNames();
+        for (size_t i = 0; i < names.size(); i++) ss << (i ? "\t" : "") << names[i];
+        ss << "\n";
+    }
+    std::vector<double> values;
+    dumpSelectedValues(&values);
+    for (size_t i = 0; i < values.size(); i++) ss << (i ? "\t" : "") << values[i];
+    ss << "\n";
+    return ss.str();
+}
+
 // returns the value of a named attribute
 // using caller provided string
 // returns "" if attribute is not found
@@ -141,6 +170,29 @@ std::string *NamedObject::createFromAttributes()
     if (findAttribute("Colour1"s, &buf)) m_colour1.SetColour(buf);
     if (findAttribute("Colour2"s, &buf)) m_colour2.SetColour(buf);
     if (findAttribute("Colour3"s, &buf)) m_colour3.SetColour(buf);
+    if (findAttribute("Dump"s, &buf)) m_dump = GSUtil::Bool(buf);
+    if (findAttribute("DumpInterval"s, &buf)) m_dumpInterval = GSUtil::Int(buf);
+    if (findAttribute("DumpTimeInterval"s, &buf)) m_dumpTimeInterval = GSUtil::Double(buf);
+    if (findAttribute("DumpStartTime"s, &buf)) m_dumpStartTime = GSUtil::Double(buf);
+    if (findAttribute("DumpEndTime"s, &buf)) m_dumpEndTime = GSUtil::Double(buf);
+    if (findAttribute("DumpChannels"s, &buf))
+    {
+        std::vector<std::string> tokens;
+        pystring::split(buf, tokens);
+        setDumpChannels(tokens);
+    }
+    if (findAttribute("DumpQuantisation"s, &buf))
+    {
+        // either a single value for all the channels or a list of Channel:Quantum pairs
+        std::vector<std::string> tokens, parts;
+        pystring::split(buf, tokens);
+        for (auto &&token : tokens)
+        {
+            pystring::rpartition(token, ":"s, parts);
+            if (parts[1].empty()) setDumpQuantisation(GSUtil::Double(token));
+            else setDumpQuantisation(parts[0], GSUtil::Double(parts[2]));
+        }
+    }
     return nullptr;
 }
 
@@ -162,6 +214,29 @@ void NamedObject::appendToAttributes()
     setAttribute("Colour1"s, m_colour1.GetIntColourRGBA());
     setAttribute("Colour2"s, m_colour2.GetIntColourRGBA());
     setAttribute("Colour3"s, m_colour3.GetIntColourRGBA());
+    // the dump options are only written when they have been set to keep the files tidy
+    if (m_dump) setAttribute("Dump"s, *GSUtil::ToString(m_dump, &buf));
+    if (m_dumpInterval > 0) setAttribute("DumpInterval"s, *GSUtil::ToString(m_dumpInterval, &buf));
+    if (m_dumpTimeInterval > 0) setAttribute("DumpTimeInterval"s, *GSUtil::ToString(m_dumpTimeInterval, &buf));
+    if (m_dumpStartTime >= 0) setAttribute("DumpStartTime"s, *GSUtil::ToString(m_dumpStartTime, &buf));
+    if (m_dumpEndTime >= 0) setAttribute("DumpEndTime"s, *GSUtil::ToString(m_dumpEndTime, &buf));
+    if (m_dumpChannels.size()) setAttribute("DumpChannels"s, pystring::join(" "s, m_dumpChannels));
+    if (m_dumpQuantisation >= 0 || m_dumpChannelQuantisation.size())
+    {
+        std::vector<std::string> tokens;
+        if (m_dumpQuantisation >= 0) tokens.push_back(*GSUtil::ToString(m_dumpQuantisation, &buf));
+        for (auto &&it : m_dumpChannelQuantisation) tokens.push_back(it.first + ":"s + *GSUtil::ToString(it.second, &buf));
+        setAttribute("DumpQuantisation"s, pystring::join(" "s, tokens));
+    }
+}
+
+void NamedObject::appendStateValues(std::vector<double> * /* values */)
+{
+}
+
+const double *NamedObject::stateValuesToAttributes(const double *values, std::map<std::string, std::string> * /* attributeMap */) const
+{
+    return values;
 }
 
 void NamedObject::createAttributeMap(const std::map<std::string, std::string> &attributeMap)
@@ -218,6 +293,12 @@ void NamedObject::setUpstreamObjects(const std::vector<NamedObject *> &&upstream
     m_upstreamObjects = std::move(upstreamObjects);
 }
 
+void NamedObject::releaseConstructionData()
+{
+    std::map<std::string, std::string>().swap(m_attributeMap);
+    std::vector<NamedObject *>().swap(m_upstreamObjects);
+}
+
 void NamedObject::allUpstreamObjects(std::vector<NamedObject *> *upstreamObjects)
 {
     if (m_upstreamObjects.size() == 0) return;
@@ -286,9 +367,127 @@ bool NamedObject::dump() const
 
 void NamedObject::setDump(bool dump)
 {
+    if (dump != m_dump && m_simulation) m_simulation->InvalidateContactAggregateList();
     m_dump = dump;
 }
 
+int NamedObject::dumpInterval() const
+{
+    return m_dumpInterval;
+}
+
+void NamedObject::setDumpInterval(int dumpInterval)
+{
+    m_dumpInterval = dumpInterval;
+}
+
+double NamedObject::dumpTimeInterval() const
+{
+    return m_dumpTimeInterval;
+}
+
+void NamedObject::setDumpTimeInterval(double dumpTimeInterval)
+{
+    m_dumpTimeInterval = dumpTimeInterval;
+}
+
+double NamedObject::dumpStartTime() const
+{
+    return m_dumpStartTime;
+}
+
+void NamedObject::setDumpStartTime(double dumpStartTime)
+{
+    m_dumpStartTime = dumpStartTime;
+}
+
+double NamedObject::dumpEndTime() const
+{
+    return m_dumpEndTime;
+}
+
+void NamedObject::setDumpEndTime(double dumpEndTime)
+{
+    m_dumpEndTime = dumpEndTime;
+}
+
+double NamedObject::dumpQuantisation(const std::string &channel) const
+{
+    auto it = m_dumpChannelQuantisation.find(channel);
+    if (it != m_dumpChannelQuantisation.end()) return it->second;
+    return m_dumpQuantisation;
+}
+
+void NamedObject::setDumpQuantisation(double dumpQuantisation)
+{
+    m_dumpQuantisation = dumpQuantisation;
+}
+
+void NamedObject::setDumpQuantisation(const std::string &channel, double dumpQuantisation)
+{
+    m_dumpChannelQuantisation[channel] = dumpQuantisation;
+}
+
+std::vector<std::string> NamedObject::dumpChannels() const
+{
+    return m_dumpChannels;
+}
+
+void NamedObject::setDumpChannels(const std::vector<std::string> &dumpChannels)
+{
+    m_dumpChannels = dumpChannels;
+    m_dumpChannelIndexListValid = false;
+}
+
+std::vector<std::string> NamedObject::dumpSelectedNames()
+{
+    std::vector<std::string> names = dumpNames();
+    if (m_dumpChannels.empty()) return names;
+    if (!m_dumpChannelIndexListValid) createDumpChannelIndexList();
+    std::vector<std::string> selectedNames;
+    selectedNames.reserve(m_dumpChannelIndexList.size());
+    for (auto &&index : m_dumpChannelIndexList) selectedNames.push_back(names[index]);
+    return selectedNames;
+}
+
+void NamedObject::dumpSelectedValues(std::vector<double> *values)
+{
+    dumpValues(values);
+    if (m_dumpChannels.empty()) return;
+    if (!m_dumpChannelIndexListValid) createDumpChannelIndexList();
+    // the index list is in ascending order so this can be done in place
+    for (size_t i = 0; i < m_dumpChannelIndexList.size(); i++) (*values)[i] = (*values)[m_dumpChannelIndexList[i]];
+    values->resize(m_dumpChannelIndexList.size());
+}
+
+// the selected channels are kept in the order that dumpNames returns them
+// and the Time channel is always kept so that decimated output still makes sense
+// if nothing matches then all the channels are kept rather than losing the output altogether
+void NamedObject::createDumpChannelIndexList()
+{
+    m_dumpChannelIndexListValid = true;
+    m_dumpChannelIndexList.clear();
+    std::vector<std::string> names = dumpNames();
+    if (names.empty())
+    {
+        std::cerr << "Warning: DumpChannels ignored for ID=\"" << m_name << "\" because it only supports text output\n";
+        return;
+    }
+    std::set<std::string> channelSet(m_dumpChannels.begin(), m_dumpChannels.end());
+    size_t numRequested = channelSet.size();
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (channelSet.erase(names[i]) || names[i] == "Time"s) m_dumpChannelIndexList.push_back(i);
+    }
+    for (auto &&it : channelSet) std::cerr << "Warning: DumpChannels \"" << it << "\" not found in ID=\"" << m_name << "\"\n";
+    if (channelSet.size() == numRequested)
+    {
+        std::cerr << "Warning: DumpChannels matched no channels in ID=\"" << m_name << "\" so all channels will be dumped\n";
+        m_dumpChannelIndexList.clear();
+        for (size_t i = 0; i < names.size(); i++) m_dumpChannelIndexList.push_back(i);
+    }
+}
+
 Simulation *NamedObject::simulation() const
 {
     return m_simulation;
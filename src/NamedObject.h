@@ -53,10 +53,19 @@ public:
     std::string className() const; // return value optimisation RVO makes via reference unnecessary
 
     virtual std::string dumpToString();
+    // numeric dump output (used for example by the binary dump file)
+    // objects that support this return a non-empty list of channel names and one value per channel
+    virtual std::vector<std::string> dumpNames() const;
+    virtual void dumpValues(std::vector<double> *values);
     void createAttributeMap(const std::map<std::string, std::string> &attributeMap);
     virtual std::string *createFromAttributes();
     virtual void saveToAttributes();
     virtual void appendToAttributes();
+    // model states written during a run only format the constant attributes once
+    // appendStateValues copies the values that change during a run and stateValuesToAttributes
+    // formats them later (possibly on another thread) so it must only use the values passed in
+    virtual void appendStateValues(std::vector<double> *values);
+    virtual const double *stateValuesToAttributes(const double *values, std::map<std::string, std::string> *attributeMap) const;
     std::string findAttribute(const std::string &name);
     virtual const std::map<std::string, std::string> &serialise();
     virtual std::string *unserialise(const std::map<std::string, std::string> &serialiseMap);
@@ -65,6 +74,9 @@ public:
     void setUpstreamObjects(const std::vector<NamedObject *> &&upstreamObjects);
     void allUpstreamObjects(std::vector<NamedObject *> *upstreamObjects);
     bool isUpstreamObject(NamedObject *findObject);
+    // frees the attribute map and the upstream object list which are only needed for construction and editing
+    // saveToAttributes regenerates the attribute map when it is needed
+    virtual void releaseConstructionData();
 
     Simulation *simulation() const;
     void setSimulation(Simulation *simulation);
@@ -103,6 +115,26 @@ public:
     void setDump(bool dumpToString);
     bool firstDump() const;
 
+    // per object dump options (zero or negative values mean use the Global defaults)
+    int dumpInterval() const;
+    void setDumpInterval(int dumpInterval);
+    double dumpTimeInterval() const;
+    void setDumpTimeInterval(double dumpTimeInterval);
+    double dumpStartTime() const;
+    void setDumpStartTime(double dumpStartTime);
+    double dumpEndTime() const;
+    void setDumpEndTime(double dumpEndTime);
+    // quantum used by compressed dump files (negative values mean use the Global default, 0 is lossless)
+    double dumpQuantisation(const std::string &channel) const;
+    void setDumpQuantisation(double dumpQuantisation);
+    void setDumpQuantisation(const std::string &channel, double dumpQuantisation);
+    // an empty channel list means all the channels
+    std::vector<std::string> dumpChannels() const;
+    void setDumpChannels(const std::vector<std::string> &dumpChannels);
+    // these apply the channel list to dumpNames and dumpValues
+    std::vector<std::string> dumpSelectedNames();
+    void dumpSelectedValues(std::vector<double> *values);
+
     bool redraw() const;
     void setRedraw(bool redraw);
 
@@ -117,6 +149,7 @@ protected:
     void setAttribute(const std::string &name, const std::string &attributeValue);
     void clearAttributeMap();
     void setFirstDump(bool firstDump);
+    std::string dumpValuesToString(); // the standard text output built from dumpNames and dumpValues
 
 private:
 
@@ -138,6 +171,16 @@ private:
 
     bool m_dump = false;
     bool m_firstDump = true;
+    int m_dumpInterval = 0;
+    double m_dumpTimeInterval = 0;
+    double m_dumpStartTime = -1;
+    double m_dumpEndTime = -1;
+    double m_dumpQuantisation = -1;
+    std::map<std::string, double> m_dumpChannelQuantisation;
+    std::vector<std::string> m_dumpChannels;
+    std::vector<size_t> m_dumpChannelIndexList;
+    bool m_dumpChannelIndexListValid = false;
+    void createDumpChannelIndexList();
 
     std::map<std::string, std::string> m_attributeMap;
     std::string m_tag;
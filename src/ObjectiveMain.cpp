@@ -18,7 +18,13 @@
 #include "Muscle.h"
 #include "Body.h"
 #include "Geom.h"
+#include "FluidSac.h"
 #include "ArgParse.h"
+#include "MomentArmSweep.h"
+#include "DumpFile.h"
+#include "RunSummary.h"
+
+#include "pystring.h"
 
 #define MAX_ARGS 4096
 
@@ -38,8 +44,9 @@ ObjectiveMain::ObjectiveMain(int argc, const char **argv)
     std::string compileTime(__TIME__);
     m_argparse.Initialise(argc, argv, "ObjectiveMain command line interface to GaitSym2019 build "s + compileDate + " "s + compileTime, 0, 0);
     m_argparse.AddArgument("-sc"s, "--score"s, "Score filename"s, ""s, 1, false, ArgParse::String);
-    m_argparse.AddArgument("-co"s, "--config"s, "Config filename"s, ""s, 1, true, ArgParse::String);
+    m_argparse.AddArgument("-co"s, "--config"s, "Config filename (required unless converting a dump file)"s, ""s, 1, false, ArgParse::String);
     m_argparse.AddArgument("-ow"s, "--outputWarehouse"s, "Output warehouse filename"s, ""s, 1, false, ArgParse::String);
+    m_argparse.AddArgument("-wt"s, "--outputWarehouseAsText"s, "Write the output warehouse as tab separated text rather than binary"s);
     m_argparse.AddArgument("-iw"s, "--inputWarehouse"s, "Input warehouse filename"s, ""s, 1, false, ArgParse::String);
     m_argparse.AddArgument("-ms"s, "--modelState"s, "Model state filename"s, ""s, 1, false, ArgParse::String);
     m_argparse.AddArgument("-rt"s, "--runTimeLimit"s, "Run time limit"s, ""s, 1, false, ArgParse::Double);
@@ -47,10 +54,31 @@ ObjectiveMain::ObjectiveMain(int argc, const char **argv)
     m_argparse.AddArgument("-mc"s, "--outputModelStateAtCycle"s, "Output model state at this cycle"s, ""s, 1, false, ArgParse::Double);
     m_argparse.AddArgument("-mt"s, "--outputModelStateAtTime"s, "Output model state at this cycle"s, ""s, 1, false, ArgParse::Double);
     m_argparse.AddArgument("-mw"s, "--outputModelStateAtWarehouseDistance"s, "Output model state at this warehouse distance"s, ""s, 1, false, ArgParse::Double);
+    m_argparse.AddArgument("-me"s, "--outputModelStateEvery"s, "Output numbered model states at this simulation time interval"s, ""s, 1, false, ArgParse::Double);
     m_argparse.AddArgument("-wd"s, "--warehouseFailDistanceAbort"s, "Abort the simulation when the warehouse distance fails"s);
+    m_argparse.AddArgument("-ai"s, "--abortCheckInterval"s, "Check the non-critical abort conditions every N steps"s, "1"s, 1, false, ArgParse::Int);
+    m_argparse.AddArgument("-ln"s, "--lean"s, "Free the construction only data after loading to reduce memory use"s);
+    m_argparse.AddArgument("-rs"s, "--runSummary"s, "Write a JSON performance summary of the run to this file"s, ""s, 1, false, ArgParse::String);
     m_argparse.AddArgument("-de"s, "--debug"s, "Turn debugging on"s);
 
     m_argparse.AddArgument("-ol"s, "--outputList"s, "List of objects to produce output"s, ""s, 1, MAX_ARGS, false, ArgParse::String);
+    m_argparse.AddArgument("-df"s, "--dumpFile"s, "Write the output list to a single binary dump file"s, ""s, 1, false, ArgParse::String);
+    m_argparse.AddArgument("-dt"s, "--dumpFileFloat"s, "Store the binary dump file values as floats rather than doubles"s);
+    m_argparse.AddArgument("-dz"s, "--dumpFileCompress"s, "Compress the binary dump file values (lossless unless --dumpQuantisation is set)"s);
+    m_argparse.AddArgument("-dq"s, "--dumpQuantisation"s, "Round the compressed dump file values to multiples of this value"s, ""s, 1, false, ArgParse::Double);
+    m_argparse.AddArgument("-di"s, "--dumpInterval"s, "Only dump every N steps"s, ""s, 1, false, ArgParse::Int);
+    m_argparse.AddArgument("-dp"s, "--dumpTimeInterval"s, "Only dump every T seconds of simulation time (overrides --dumpInterval)"s, ""s, 1, false, ArgParse::Double);
+    m_argparse.AddArgument("-dw"s, "--dumpWindow"s, "Only dump between these start and end times (an end time less than zero means no end)"s, ""s, 2, false, ArgParse::Double);
+    m_argparse.AddArgument("-dc"s, "--dumpChannels"s, "Channel subsets for dumped objects as \"ID:Channel1,Channel2,...\""s, ""s, 1, MAX_ARGS, false, ArgParse::String);
+    m_argparse.AddArgument("-dr"s, "--dumpTriggers"s, "Only dump around these events: Touchdown[:GeomID] LiftOff[:GeomID] ODEWarning Abort or an abort reason"s, ""s, 1, MAX_ARGS, false, ArgParse::String);
+    m_argparse.AddArgument("-dh"s, "--dumpTriggerWindow"s, "Dump this much time before and after each trigger"s, ""s, 2, false, ArgParse::Double);
+    m_argparse.AddArgument("-da"s, "--dumpAsyncBuffer"s, "Format and write the dump and warehouse output in a background thread using a buffer of this many MB (0 writes synchronously)"s, "0"s, 1, false, ArgParse::Int);
+    m_argparse.AddArgument("-cd"s, "--convertDump"s, "Convert a binary dump file to .tab files (no simulation is run)"s, ""s, 1, false, ArgParse::String);
+
+    m_argparse.AddArgument("-aj"s, "--momentArmJoints"s, "Moment arm sweep joints as \"JointID LowAngle HighAngle Steps [X|Y|Z]\" (no simulation is run)"s, ""s, 1, MAX_ARGS, false, ArgParse::String);
+    m_argparse.AddArgument("-am"s, "--momentArmMuscles"s, "Moment arm sweep muscles (default all)"s, ""s, 1, MAX_ARGS, false, ArgParse::String);
+    m_argparse.AddArgument("-ao"s, "--momentArmOutput"s, "Moment arm sweep output filename (default stdout)"s, ""s, 1, false, ArgParse::String);
+    m_argparse.AddArgument("-at"s, "--momentArmThreads"s, "Moment arm sweep threads (default all cores)"s, ""s, 1, false, ArgParse::Int);
 
     int err = m_argparse.Parse();
     if (err)
@@ -58,24 +86,55 @@ ObjectiveMain::ObjectiveMain(int argc, const char **argv)
         m_argparse.Usage();
         exit(1);
     }
+    m_argparse.Get("--convertDump"s, &m_convertDumpFilename);
+    m_argparse.Get("--config"s, &m_configFilename);
+    if (m_configFilename.empty() && m_convertDumpFilename.empty())
+    {
+        std::cerr << "-co --config required in argument list\n";
+        m_argparse.Usage();
+        exit(1);
+    }
 
     m_argparse.Get("--outputList"s, &m_outputList);
     m_argparse.Get("--runTimeLimit"s, &m_runTimeLimit);
     m_argparse.Get("--outputModelStateAtTime"s, &m_outputModelStateAtTime);
     m_argparse.Get("--outputModelStateAtCycle"s, &m_outputModelStateAtCycle);
     m_argparse.Get("--outputModelStateAtWarehouseDistance"s, &m_outputModelStateAtWarehouseDistance);
+    m_argparse.Get("--outputModelStateEvery"s, &m_outputModelStateEvery);
     m_argparse.Get("--simulationTimeLimit"s, &m_simulationTimeLimit);
     m_argparse.Get("--warehouseFailDistanceAbort"s, &m_warehouseFailDistanceAbort);
-    m_argparse.Get("--config"s, &m_configFilename);
+    m_argparse.Get("--abortCheckInterval"s, &m_abortCheckInterval);
     m_argparse.Get("--score"s, &m_scoreFilename);
     m_argparse.Get("--modelState"s, &m_outputModelStateFilename);
     m_argparse.Get("--inputWarehouse"s, &m_inputWarehouseFilename);
     m_argparse.Get("--outputWarehouse"s, &m_outputWarehouseFilename);
+    m_argparse.Get("--outputWarehouseAsText"s, &m_outputWarehouseAsText);
+    m_argparse.Get("--runSummary"s, &m_runSummaryFilename);
+    m_argparse.Get("--lean"s, &m_lean);
     m_argparse.Get("--debug"s, &m_debug);
+    m_argparse.Get("--momentArmJoints"s, &m_momentArmJointList);
+    m_argparse.Get("--momentArmMuscles"s, &m_momentArmMuscleList);
+    m_argparse.Get("--momentArmOutput"s, &m_momentArmOutputFilename);
+    m_argparse.Get("--momentArmThreads"s, &m_momentArmThreads);
+    m_argparse.Get("--dumpFile"s, &m_dumpFilename);
+    m_argparse.Get("--dumpFileFloat"s, &m_dumpFileFloat);
+    m_argparse.Get("--dumpFileCompress"s, &m_dumpFileCompress);
+    m_argparse.Get("--dumpQuantisation"s, &m_dumpQuantisation);
+    m_argparse.Get("--dumpAsyncBuffer"s, &m_dumpAsyncBuffer);
+    m_argparse.Get("--dumpInterval"s, &m_dumpInterval);
+    m_argparse.Get("--dumpTimeInterval"s, &m_dumpTimeInterval);
+    m_argparse.Get("--dumpWindow"s, &m_dumpWindow);
+    m_argparse.Get("--dumpChannels"s, &m_dumpChannelList);
+    m_argparse.Get("--dumpTriggers"s, &m_dumpTriggerList);
+    m_argparse.Get("--dumpTriggerWindow"s, &m_dumpTriggerWindow);
 }
 
 int ObjectiveMain::Run()
 {
+    if (m_convertDumpFilename.size()) return ConvertDumpFile();
+    if (m_momentArmJointList.size()) return RunMomentArmSweep();
+
+    double loadStartTime = GSUtil::GetTime();
     if (ReadModel()) return __LINE__;
 
     for (size_t i = 0; i < m_outputList.size(); i++)
@@ -88,7 +147,44 @@ int ObjectiveMain::Run()
         if (m_simulation->GetDriverList()->find(m_outputList[i]) != m_simulation->GetDriverList()->end()) (*m_simulation->GetDriverList())[m_outputList[i]]->setDump(true);
         if (m_simulation->GetDataTargetList()->find(m_outputList[i]) != m_simulation->GetDataTargetList()->end()) (*m_simulation->GetDataTargetList())[m_outputList[i]]->setDump(true);
         if (m_simulation->GetReporterList()->find(m_outputList[i]) != m_simulation->GetReporterList()->end()) (*m_simulation->GetReporterList())[m_outputList[i]]->setDump(true);
+        if (m_simulation->GetFluidSacList()->find(m_outputList[i]) != m_simulation->GetFluidSacList()->end()) (*m_simulation->GetFluidSacList())[m_outputList[i]]->setDump(true);
+    }
+
+    for (auto &&dumpChannels : m_dumpChannelList)
+    {
+        std::vector<std::string> tokens, channels;
+        pystring::rpartition(dumpChannels, ":"s, tokens);
+        NamedObject *namedObject = m_simulation->GetNamedObject(tokens[0]);
+        if (!namedObject)
+        {
+            std::cerr << "Warning: --dumpChannels \"" << dumpChannels << "\" does not match an ID\n";
+            continue;
+        }
+        pystring::split(tokens[2], channels, ","s);
+        namedObject->setDumpChannels(channels);
     }
+    if (m_dumpInterval > 0) m_simulation->GetGlobal()->setDumpInterval(m_dumpInterval);
+    if (m_dumpTimeInterval > 0) m_simulation->GetGlobal()->setDumpTimeInterval(m_dumpTimeInterval);
+    if (m_dumpWindow.size() == 2)
+    {
+        m_simulation->GetGlobal()->setDumpStartTime(m_dumpWindow[0]);
+        m_simulation->GetGlobal()->setDumpEndTime(m_dumpWindow[1]);
+    }
+    if (m_dumpQuantisation >= 0) m_simulation->GetGlobal()->setDumpQuantisation(m_dumpQuantisation);
+    if (m_dumpTriggerList.size()) m_simulation->GetGlobal()->setDumpTriggers(pystring::join(" "s, m_dumpTriggerList));
+    if (m_dumpTriggerWindow.size() == 2)
+    {
+        m_simulation->GetGlobal()->setDumpPreTriggerTime(m_dumpTriggerWindow[0]);
+        m_simulation->GetGlobal()->setDumpPostTriggerTime(m_dumpTriggerWindow[1]);
+    }
+    if (m_dumpFilename.size())
+    {
+        DumpValueFormat valueFormat = DumpValueFormat::Double;
+        if (m_dumpFileFloat) valueFormat = DumpValueFormat::Float;
+        if (m_dumpFileCompress) valueFormat = DumpValueFormat::Compressed;
+        m_simulation->SetDumpFile(m_dumpFilename, valueFormat);
+    }
+    if (m_dumpAsyncBuffer > 0) m_simulation->SetAsyncDumpBufferSize(size_t(m_dumpAsyncBuffer));
 
     double startTime = GSUtil::GetTime();
 
@@ -100,8 +196,25 @@ int ObjectiveMain::Run()
         m_simulation->UpdateSimulation();
     }
 
+    double outputStartTime = GSUtil::GetTime();
     if (WriteOutput()) return __LINE__;
 
+    if (m_runSummaryFilename.size())
+    {
+        RunSummary runSummary;
+        runSummary.configFilename = m_configFilename;
+        runSummary.loadTime = startTime - loadStartTime;
+        runSummary.simulateTime = outputStartTime - startTime;
+        runSummary.outputTime = GSUtil::GetTime() - outputStartTime;
+        if (m_runTimeLimit > 0 && m_simulationTime > m_runTimeLimit) runSummary.abortReason = "RunTimeLimit"s;
+        runSummary.CaptureSimulation(m_simulation.get());
+        if (runSummary.WriteFile(m_runSummaryFilename, false))
+        {
+            std::cerr << "Error writing run summary \"" << m_runSummaryFilename << "\"\n";
+            return __LINE__;
+        }
+    }
+
     return 0;
 }
 
@@ -119,11 +232,14 @@ int ObjectiveMain::ReadModel()
     // create the simulation object
     m_simulation = std::make_unique<Simulation>();
     if (m_outputWarehouseFilename.size()) m_simulation->SetOutputWarehouseFile(m_outputWarehouseFilename);
+    if (m_outputWarehouseAsText) m_simulation->SetOutputWarehouseAsText(true);
     if (m_outputModelStateFilename.size()) m_simulation->SetOutputModelStateFile(m_outputModelStateFilename);
     if (m_outputModelStateAtTime >= 0) m_simulation->SetOutputModelStateAtTime(m_outputModelStateAtTime);
     if (m_outputModelStateAtCycle >= 0) m_simulation->SetOutputModelStateAtCycle(m_outputModelStateAtCycle);
     if (m_inputWarehouseFilename.size()) m_simulation->AddWarehouse(m_inputWarehouseFilename);
     if (m_outputModelStateAtWarehouseDistance >= 0) m_simulation->SetOutputModelStateAtWarehouseDistance(m_outputModelStateAtWarehouseDistance);
+    if (m_outputModelStateEvery > 0) m_simulation->SetOutputModelStateEvery(m_outputModelStateEvery);
+    if (m_lean) m_simulation->SetLeanMode(true);
 
     if (m_debug) std::cerr << "Loading model\n";
     if (m_simulation->LoadModel(myFile.GetRawData(), myFile.GetSize()))
@@ -136,6 +252,7 @@ int ObjectiveMain::ReadModel()
     // late initialisation options
     if (m_simulationTimeLimit >= 0) m_simulation->SetTimeLimit(m_simulationTimeLimit);
     if (m_warehouseFailDistanceAbort != 0) m_simulation->SetWarehouseFailDistanceAbort(m_warehouseFailDistanceAbort);
+    if (m_abortCheckInterval > 1) m_simulation->SetAbortCheckInterval(m_abortCheckInterval);
 
     return 0;
 }
@@ -164,5 +281,67 @@ int ObjectiveMain::WriteOutput()
     return 0;
 }
 
+// this routine poses the model over a grid of joint angles and outputs a table of muscle lengths and moment arms
+// it returns zero on success
+int ObjectiveMain::RunMomentArmSweep()
+{
+    DataFile myFile;
+    myFile.SetExitOnError(true);
+    if (m_debug) std::cerr << "Reading file \"" << m_configFilename << "\"\n";
+    myFile.ReadFile(m_configFilename);
+
+    MomentArmSweep momentArmSweep;
+    for (auto &&it : m_momentArmJointList)
+    {
+        if (momentArmSweep.AddJoint(it))
+        {
+            std::cerr << momentArmSweep.lastError() << "\n";
+            return __LINE__;
+        }
+    }
+    momentArmSweep.SetMuscleList(m_momentArmMuscleList);
+    if (m_momentArmThreads > 0) momentArmSweep.SetThreads(size_t(m_momentArmThreads));
+
+    double startTime = GSUtil::GetTime();
+    if (momentArmSweep.Run(myFile.GetRawData(), myFile.GetSize()))
+    {
+        std::cerr << momentArmSweep.lastError() << "\n";
+        return __LINE__;
+    }
+    if (m_debug) std::cerr << "Calculated " << momentArmSweep.GetNumRows() << " poses in " << GSUtil::GetTime() - startTime << " s\n";
 
+    std::string table = momentArmSweep.OutputTable();
+    if (m_momentArmOutputFilename.size())
+    {
+        DataFile outputFile;
+        outputFile.SetExitOnError(false);
+        outputFile.SetRawData(table.data(), table.size());
+        if (outputFile.WriteFile(m_momentArmOutputFilename)) return __LINE__;
+    }
+    else
+    {
+        std::cout << table;
+    }
+    return 0;
+}
 
+// this converts a binary dump file into the standard .tab files
+// it returns zero on success
+int ObjectiveMain::ConvertDumpFile()
+{
+    // the stream reader converts a block at a time so the whole file never needs to be in memory
+    DumpFileStreamReader dumpFileReader;
+    if (dumpFileReader.Open(m_convertDumpFilename))
+    {
+        std::cerr << dumpFileReader.lastError() << "\n";
+        return __LINE__;
+    }
+    if (m_debug) std::cerr << "Reading " << dumpFileReader.GetNumObjects() << " objects from \"" << m_convertDumpFilename << "\"\n";
+    if (dumpFileReader.WriteTabFiles(""s))
+    {
+        std::cerr << dumpFileReader.lastError() << "\n";
+        return __LINE__;
+    }
+    if (dumpFileReader.truncated()) std::cerr << "Warning: " << dumpFileReader.lastError() << "\n";
+    return 0;
+}
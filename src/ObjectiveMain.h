@@ -18,6 +18,8 @@ public:
     int Run();
     int ReadModel();
     int WriteOutput();
+    int RunMomentArmSweep();
+    int ConvertDumpFile();
 
 private:
     std::vector<std::string> m_outputList;
@@ -28,14 +30,36 @@ private:
     double m_outputModelStateAtTime = -1;
     double m_outputModelStateAtCycle = -1;
     double m_outputModelStateAtWarehouseDistance = -1;
+    double m_outputModelStateEvery = 0;
     double m_simulationTimeLimit = -1;
     double m_warehouseFailDistanceAbort = 0;
+    int m_abortCheckInterval = 1;
 
     std::string m_configFilename;
     std::string m_outputWarehouseFilename;
+    bool m_outputWarehouseAsText = false;
+    bool m_lean = false;
     std::string m_outputModelStateFilename;
     std::string m_inputWarehouseFilename;
     std::string m_scoreFilename;
+    std::string m_runSummaryFilename;
+    std::string m_momentArmOutputFilename;
+    std::string m_dumpFilename;
+    std::string m_convertDumpFilename;
+    bool m_dumpFileFloat = false;
+    bool m_dumpFileCompress = false;
+    double m_dumpQuantisation = -1;
+    int m_dumpAsyncBuffer = 0;
+    int m_dumpInterval = 0;
+    double m_dumpTimeInterval = 0;
+    std::vector<double> m_dumpWindow;
+    std::vector<std::string> m_dumpChannelList;
+    std::vector<std::string> m_dumpTriggerList;
+    std::vector<double> m_dumpTriggerWindow;
+
+    std::vector<std::string> m_momentArmJointList;
+    std::vector<std::string> m_momentArmMuscleList;
+    int m_momentArmThreads = 0;
 
     XMLConverter m_XMLConverter;
     ArgParse m_argparse;
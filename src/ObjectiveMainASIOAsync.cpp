@@ -17,6 +17,8 @@
 #include "Muscle.h"
 #include "Body.h"
 #include "Geom.h"
+#include "TrimeshGeom.h"
+#include "Global.h"
 #include "ArgParse.h"
 
 #include "pystring.h"
@@ -25,6 +27,7 @@
 #include <thread>
 #include <algorithm>
 #include <random>
+#include <sstream>
 
 #if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
 #include <WinSock2.h>
@@ -59,6 +62,9 @@ ObjectiveMainASIOAsync::ObjectiveMainASIOAsync(int argc, const char **argv)
     m_argparse.AddArgument("-mt"s, "--outputModelStateAtTime"s, "Output model state at this cycle"s, ""s, 1, false, ArgParse::Double);
     m_argparse.AddArgument("-mw"s, "--outputModelStateAtWarehouseDistance"s, "Output model state at this warehouse distance"s, ""s, 1, false, ArgParse::Double);
     m_argparse.AddArgument("-wd"s, "--warehouseFailDistanceAbort"s, "Abort the simulation when the warehouse distance fails"s, "0"s, 1, false, ArgParse::Bool);
+    m_argparse.AddArgument("-ln"s, "--lean"s, "Free the construction only data after loading to reduce memory use"s);
+    m_argparse.AddArgument("-rs"s, "--runSummary"s, "Append a JSON performance summary of each run to this file"s, ""s, 1, false, ArgParse::String);
+    m_argparse.AddArgument("-th"s, "--threads"s, "Number of simulations to run at once (0 uses all cores). Values greater than 1 cannot be used with the model state, output warehouse or output list options or with QuickStep or trimesh models"s, "1"s, 1, false, ArgParse::Int);
     m_argparse.AddArgument("-de"s, "--debug"s, "Turn debugging on"s);
 
     m_argparse.AddArgument("-ol"s, "--outputList"s, "List of objects to produce output"s, ""s, 1, MAX_ARGS, false, ArgParse::String);
@@ -84,7 +90,18 @@ ObjectiveMainASIOAsync::ObjectiveMainASIOAsync(int argc, const char **argv)
     m_argparse.Get("--modelState"s, &m_outputModelStateFilename);
     m_argparse.Get("--inputWarehouse"s, &m_inputWarehouseFilename);
     m_argparse.Get("--outputWarehouse"s, &m_outputWarehouseFilename);
+    m_argparse.Get("--runSummary"s, &m_runSummaryFilename);
+    m_argparse.Get("--lean"s, &m_lean);
+    m_argparse.Get("--threads"s, &m_threads);
     m_argparse.Get("--debug"s, &m_debug);
+    if (m_threads <= 0) m_threads = std::max(int(std::thread::hardware_concurrency()), 1);
+    // these files have fixed names so simulations running at the same time would write over each other
+    if (m_threads > 1 && (m_outputWarehouseFilename.size() || m_outputModelStateFilename.size() || m_outputModelStateAtTime >= 0 ||
+                          m_outputModelStateAtCycle >= 0 || m_outputModelStateAtWarehouseDistance >= 0 || m_outputList.size()))
+    {
+        std::cerr << "Error: --outputWarehouse, --modelState, --outputModelStateAtTime, --outputModelStateAtCycle, --outputModelStateAtWarehouseDistance and --outputList cannot be used with --threads greater than 1\n";
+        exit(1);
+    }
 
     std::string rawHost;
     std::vector<std::string> result;
@@ -111,6 +128,8 @@ ObjectiveMainASIOAsync::ObjectiveMainASIOAsync(int argc, const char **argv)
 
 int ObjectiveMainASIOAsync::Run()
 {
+    if (m_threads > 1) return RunWorkerPool();
+
     double startTime = GSUtil::GetTime();
     double runTime = 0;
     double computeTime = 0;
@@ -131,7 +150,7 @@ int ObjectiveMainASIOAsync::Run()
             m_XMLConverter.GetFormattedXML(&xmlCopy);
         }
         m_statusDoSimulation = __LINE__;
-        std::thread simulationThread(&ObjectiveMainASIOAsync::DoSimulation, this, xmlCopy.data(), xmlCopy.size(), &score, &computeTime);
+        std::thread simulationThread([&]() { m_statusDoSimulation = DoSimulation(xmlCopy.data(), xmlCopy.size(), &score, &computeTime, &m_runSummary); });
 
         // while the simulation is running send off the last result and get the new task
         if (m_scoreToSend)
@@ -140,27 +159,7 @@ int ObjectiveMainASIOAsync::Run()
             if (status && m_debug) std::cerr << "Failed to write output score\n";
             m_scoreToSend = false;
         }
-        status = ReadGenome(m_host, m_port, &m_lastGenomeDataMessageRaw);
-        if (status) m_lastGenomeValid = false;
-        else m_lastGenomeValid = true;
-        if (m_lastGenomeValid)
-        {
-            if (!hashEqual(m_hash.data(), reinterpret_cast<const DataMessage *>(m_lastGenomeDataMessageRaw.data())->md5, m_hash.size()))
-            {
-                std::string rawMessage;
-                ReadXML(m_host, m_port, &rawMessage);
-                if (hashEqual(reinterpret_cast<const DataMessage *>(rawMessage.data())->md5, reinterpret_cast<const DataMessage *>(m_lastGenomeDataMessageRaw.data())->md5, m_hash.size())
-                        && reinterpret_cast<const DataMessage *>(rawMessage.data())->evolveIdentifier == reinterpret_cast<const DataMessage *>(m_lastGenomeDataMessageRaw.data())->evolveIdentifier)
-                {
-                    for (size_t i = 0; i < m_hash.size(); i++) { m_hash[i] = reinterpret_cast<const DataMessage *>(rawMessage.data())->md5[i]; }
-                    m_XMLConverter.LoadBaseXMLString(reinterpret_cast<const DataMessage *>(rawMessage.data())->payload.xml, reinterpret_cast<const DataMessage *>(rawMessage.data())->xmlLength);
-                }
-                else
-                {
-                    m_lastGenomeValid = false;
-                }
-            }
-        }
+        m_lastGenomeValid = FetchGenome();
 
         // wait for the simulation thread
         simulationThread.join();
@@ -178,6 +177,12 @@ int ObjectiveMainASIOAsync::Run()
             m_lastRunID = std::numeric_limits<uint32_t>::max() - 1;;
             m_lastEvolveIdentifier = 0;
         }
+        if (m_runSummaryFilename.size() && xmlCopy.size())
+        {
+            m_runSummary.runID = runID;
+            m_runSummary.evolveIdentifier = evolveIdentifier;
+            if (m_runSummary.WriteFile(m_runSummaryFilename, true)) std::cerr << "Error writing run summary \"" << m_runSummaryFilename << "\"\n";
+        }
 
         runTime = GSUtil::GetTime() - startTime;
         double housekeeping = runTime - computeTime;
@@ -187,16 +192,160 @@ int ObjectiveMainASIOAsync::Run()
     return 0;
 }
 
-void ObjectiveMainASIOAsync::DoSimulation(const char *xmlPtr, size_t xmlLen, double *score, double *computeTime)
+// the worker pool runs m_threads simulations at once using a single XMLConverter and a single connection
+// this thread does all the network communication and keeps a genome queued for each worker so that
+// fetching the next genome and returning the scores happens while the simulations are running
+int ObjectiveMainASIOAsync::RunWorkerPool()
+{
+    double startTime = GSUtil::GetTime();
+    double runTime = 0;
+    double computeTime = 0;
+    size_t maxQueued = size_t(m_threads);
+    m_poolStop = false;
+    std::vector<std::thread> workerList;
+    for (int i = 0; i < m_threads; i++) workerList.push_back(std::thread(&ObjectiveMainASIOAsync::WorkerThread, this));
+
+    while(m_runTimeLimit == 0 || runTime <= m_runTimeLimit)
+    {
+        std::deque<std::unique_ptr<SimulationResult>> resultList;
+        size_t queued;
+        {
+            std::lock_guard<std::mutex> lock(m_poolMutex);
+            resultList.swap(m_resultList);
+            queued = m_taskList.size();
+        }
+        for (auto &&result : resultList) { SendResult(result.get()); computeTime += result->computeTime; }
+
+        bool fetchFailed = false;
+        if (queued < maxQueued)
+        {
+            std::unique_ptr<SimulationTask> task = std::make_unique<SimulationTask>();
+            if (FetchGenome() && m_XMLConverter.BaseXMLString().size())
+            {
+                const DataMessage *dataMessage = reinterpret_cast<const DataMessage *>(m_lastGenomeDataMessageRaw.data());
+                task->runID = dataMessage->runID;
+                task->evolveIdentifier = dataMessage->evolveIdentifier;
+                if (m_debug) std::cerr <<  "RunWorkerPool runID = " << task->runID << " evolveIdentifier = " << task->evolveIdentifier << "\n";
+                m_XMLConverter.ApplyGenome(int(dataMessage->genomeLength), dataMessage->payload.genome);
+                m_XMLConverter.GetFormattedXML(&task->xml);
+                {
+                    std::lock_guard<std::mutex> lock(m_poolMutex);
+                    m_taskList.push_back(std::move(task));
+                }
+                m_poolCondition.notify_all();
+            }
+            else
+            {
+                fetchFailed = true;
+            }
+        }
+
+        // wait for something to do but if the server has no work then only wait a short time before asking again
+        {
+            std::unique_lock<std::mutex> lock(m_poolMutex);
+            if (fetchFailed) m_poolCondition.wait_for(lock, std::chrono::seconds(1), [this] { return m_resultList.size() > 0; });
+            else m_poolCondition.wait(lock, [this, maxQueued] { return m_resultList.size() > 0 || m_taskList.size() < maxQueued; });
+        }
+
+        runTime = GSUtil::GetTime() - startTime;
+        if (resultList.size())
+        {
+            double housekeeping = runTime * m_threads - computeTime;
+            double utilisation = computeTime / (runTime * m_threads);
+            std::cerr << "runTime: " << runTime << " computeTime: " << computeTime << " housekeeping: " << housekeeping << " utilisation: " << utilisation * 100.0 << "%\n";
+        }
+    }
+
+    // queued genomes are abandoned but the simulations already running are allowed to finish and report
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        m_poolStop = true;
+        m_taskList.clear();
+    }
+    m_poolCondition.notify_all();
+    for (auto &&it : workerList) it.join();
+    for (auto &&result : m_resultList) SendResult(result.get());
+    m_resultList.clear();
+    return 0;
+}
+
+void ObjectiveMainASIOAsync::WorkerThread()
+{
+    while (true)
+    {
+        std::unique_ptr<SimulationTask> task;
+        {
+            std::unique_lock<std::mutex> lock(m_poolMutex);
+            m_poolCondition.wait(lock, [this] { return m_poolStop || m_taskList.size(); });
+            if (m_poolStop) break;
+            task = std::move(m_taskList.front());
+            m_taskList.pop_front();
+        }
+        m_poolCondition.notify_all();
+
+        std::unique_ptr<SimulationResult> result = std::make_unique<SimulationResult>();
+        result->runID = task->runID;
+        result->evolveIdentifier = task->evolveIdentifier;
+        result->status = DoSimulation(task->xml.data(), task->xml.size(), &result->score, &result->computeTime, &result->runSummary);
+        {
+            std::lock_guard<std::mutex> lock(m_poolMutex);
+            m_resultList.push_back(std::move(result));
+        }
+        m_poolCondition.notify_all();
+    }
+}
+
+void ObjectiveMainASIOAsync::SendResult(SimulationResult *result)
+{
+    if (result->status == 0)
+    {
+        int status = WriteOutput(m_host, m_port, result->evolveIdentifier, result->runID, result->score);
+        if (status && m_debug) std::cerr << "Failed to write output score\n";
+    }
+    if (m_runSummaryFilename.size())
+    {
+        result->runSummary.runID = result->runID;
+        result->runSummary.evolveIdentifier = result->evolveIdentifier;
+        if (result->runSummary.WriteFile(m_runSummaryFilename, true)) std::cerr << "Error writing run summary \"" << m_runSummaryFilename << "\"\n";
+    }
+}
+
+// reads the next genome into m_lastGenomeDataMessageRaw and if the genome is for a different model
+// reads the new XML into m_XMLConverter
+// returns true if a usable genome was read
+bool ObjectiveMainASIOAsync::FetchGenome()
+{
+    int status = ReadGenome(m_host, m_port, &m_lastGenomeDataMessageRaw);
+    if (status) return false;
+    if (!hashEqual(m_hash.data(), reinterpret_cast<const DataMessage *>(m_lastGenomeDataMessageRaw.data())->md5, m_hash.size()))
+    {
+        std::string rawMessage;
+        ReadXML(m_host, m_port, &rawMessage);
+        if (hashEqual(reinterpret_cast<const DataMessage *>(rawMessage.data())->md5, reinterpret_cast<const DataMessage *>(m_lastGenomeDataMessageRaw.data())->md5, m_hash.size())
+                && reinterpret_cast<const DataMessage *>(rawMessage.data())->evolveIdentifier == reinterpret_cast<const DataMessage *>(m_lastGenomeDataMessageRaw.data())->evolveIdentifier)
+        {
+            for (size_t i = 0; i < m_hash.size(); i++) { m_hash[i] = reinterpret_cast<const DataMessage *>(rawMessage.data())->md5[i]; }
+            m_XMLConverter.LoadBaseXMLString(reinterpret_cast<const DataMessage *>(rawMessage.data())->payload.xml, reinterpret_cast<const DataMessage *>(rawMessage.data())->xmlLength);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// this can be called from several threads at once so everything it changes is passed in
+// returns 0 on success
+int ObjectiveMainASIOAsync::DoSimulation(const char *xmlPtr, size_t xmlLen, double *score, double *computeTime, RunSummary *runSummary)
 {
     if (xmlLen == 0)
     {
-        m_statusDoSimulation = __LINE__;
-        return;
+        return __LINE__;
     }
-    m_statusDoSimulation = 0;
 
     double startTime = GSUtil::GetTime();
+    *runSummary = RunSummary();
 
     // create the simulation object locally so delete happens before the next one is create otherwise we get problems with ODE error tracking
     std::unique_ptr<Simulation> simulation = std::make_unique<Simulation>();
@@ -206,11 +355,35 @@ void ObjectiveMainASIOAsync::DoSimulation(const char *xmlPtr, size_t xmlLen, dou
     if (m_outputModelStateAtCycle >= 0) simulation->SetOutputModelStateAtCycle(m_outputModelStateAtCycle);
     if (m_inputWarehouseFilename.size()) simulation->AddWarehouse(m_inputWarehouseFilename);
     if (m_outputModelStateAtWarehouseDistance >= 0) simulation->SetOutputModelStateAtWarehouseDistance(m_outputModelStateAtWarehouseDistance);
+    if (m_lean) simulation->SetLeanMode(true);
 
     if (simulation->LoadModel(xmlPtr, xmlLen))
     {
-        m_statusDoSimulation = __LINE__;
-        return;
+        runSummary->abortReason = "LoadError"s;
+        runSummary->loadTime = GSUtil::GetTime() - startTime;
+        return __LINE__;
+    }
+    // dWorldQuickStep uses the ODE random number generator which is a single unprotected global
+    // so simulations running at the same time would interfere and the scores would not be reproducible
+    if (m_threads > 1 && simulation->GetGlobal()->stepType() == Global::Quick)
+    {
+        std::cerr << "Error: QuickStep models cannot be run with --threads greater than 1\n";
+        runSummary->abortReason = "QuickStepThreads"s;
+        runSummary->loadTime = GSUtil::GetTime() - startTime;
+        return __LINE__;
+    }
+    // the bundled ODE is built without dTLS_ENABLED so the trimesh colliders share a single cache
+    // and simulations running at the same time would corrupt each other's contacts
+    if (m_threads > 1)
+    {
+        for (auto &&iter : *simulation->GetGeomList())
+        {
+            if (dynamic_cast<TrimeshGeom *>(iter.second.get()) == nullptr) continue;
+            std::cerr << "Error: Trimesh models cannot be run with --threads greater than 1\n";
+            runSummary->abortReason = "TrimeshThreads"s;
+            runSummary->loadTime = GSUtil::GetTime() - startTime;
+            return __LINE__;
+        }
     }
 
     // late initialisation options
@@ -227,19 +400,33 @@ void ObjectiveMainASIOAsync::DoSimulation(const char *xmlPtr, size_t xmlLen, dou
         if (simulation->GetReporterList()->find(m_outputList[i]) != simulation->GetReporterList()->end()) (*simulation->GetReporterList())[m_outputList[i]]->setDump(true);
     }
 
+    double simulateStartTime = GSUtil::GetTime();
     while (simulation->ShouldQuit() == false)
     {
         simulation->UpdateSimulation();
         if (simulation->TestForCatastrophy()) break;
     }
+    double outputStartTime = GSUtil::GetTime();
     *score = simulation->CalculateInstantaneousFitness();
-    std::cerr << "Simulation Time: " << simulation->GetTime() <<
-                 " Steps: " << simulation->GetStepCount() <<
-                 " Score: " << *score <<
-                 " Mechanical Energy: " << simulation->GetMechanicalEnergy() <<
-                 " Metabolic Energy: " << simulation->GetMetabolicEnergy() <<
-                 "\n";
-    *computeTime += (GSUtil::GetTime() - startTime);
+    // formatted first so that lines from different workers do not get mixed up
+    std::stringstream ss;
+    ss << "Simulation Time: " << simulation->GetTime() <<
+          " Steps: " << simulation->GetStepCount() <<
+          " Score: " << *score <<
+          " Mechanical Energy: " << simulation->GetMechanicalEnergy() <<
+          " Metabolic Energy: " << simulation->GetMetabolicEnergy() <<
+          "\n";
+    std::cerr << ss.str();
+    double endTime = GSUtil::GetTime();
+    *computeTime += (endTime - startTime);
+    if (m_runSummaryFilename.size())
+    {
+        runSummary->loadTime = simulateStartTime - startTime;
+        runSummary->simulateTime = outputStartTime - simulateStartTime;
+        runSummary->outputTime = endTime - outputStartTime;
+        runSummary->CaptureSimulation(simulation.get());
+    }
+    return 0;
 }
 
 // this routine attemps to read the model specification and initialise the simulation
@@ -13,6 +13,7 @@
 
 #include "XMLConverter.h"
 #include "ArgParse.h"
+#include "RunSummary.h"
 
 #include "asio.hpp"
 
@@ -25,6 +26,8 @@
 #include <iostream>
 #include <system_error>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 
 class Simulation;
 
@@ -238,7 +241,28 @@ private:
     int ReadGenome(std::string host, uint16_t port, std::string *rawMessage);
     int ReadXML(std::string host, uint16_t port, std::string *rawMessage);
     int WriteOutput(std::string host, uint16_t port, uint64_t evolveIdentifier, uint32_t runID, double score);
-    void DoSimulation(const char *xmlPtr, size_t xmlLen, double *score, double *computeTime);
+    int DoSimulation(const char *xmlPtr, size_t xmlLen, double *score, double *computeTime, RunSummary *runSummary);
+    bool FetchGenome();
+
+    // multiple simulation worker pool
+    struct SimulationTask
+    {
+        uint32_t runID = 0;
+        uint64_t evolveIdentifier = 0;
+        std::string xml;
+    };
+    struct SimulationResult
+    {
+        uint32_t runID = 0;
+        uint64_t evolveIdentifier = 0;
+        double score = 0;
+        double computeTime = 0;
+        int status = 0;
+        RunSummary runSummary;
+    };
+    int RunWorkerPool();
+    void WorkerThread();
+    void SendResult(SimulationResult *result);
 
     std::vector<std::string> m_outputList;
 
@@ -254,6 +278,9 @@ private:
     std::string m_outputModelStateFilename;
     std::string m_inputWarehouseFilename;
     std::string m_scoreFilename;
+    std::string m_runSummaryFilename;
+    bool m_lean = false;
+    int m_threads = 1;
 
     XMLConverter m_XMLConverter;
     ArgParse m_argparse;
@@ -269,8 +296,15 @@ private:
     std::string m_lastGenomeDataMessageRaw;
     bool m_lastGenomeValid = false;
     int m_statusDoSimulation = 0;
+    RunSummary m_runSummary;
     std::vector<uint32_t> m_hash = {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF};
 
+    std::deque<std::unique_ptr<SimulationTask>> m_taskList;
+    std::deque<std::unique_ptr<SimulationResult>> m_resultList;
+    std::mutex m_poolMutex;
+    std::condition_variable m_poolCondition;
+    bool m_poolStop = false;
+
     AsioClient m_asioClient;
     std::chrono::steady_clock::duration m_timeout;
 
@@ -34,10 +34,10 @@ void PIDErrorInController::Initialise(double Kp, double Ki, double Kd)
 
 void PIDErrorInController::Update()
 {
-    assert(simulation()->GetStepCount() == lastStepCount() + 1);
+    assert(simulation()->GetStepCount() == nextUpdateStepCount());
     setLastStepCount(simulation()->GetStepCount());
 
-    m_dt = simulation()->GetTimeIncrement();
+    m_dt = controlTimeIncrement();
 
     // in this driver, the error is driven by the upstream driver
     m_error = dataSum();
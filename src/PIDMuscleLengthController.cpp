@@ -38,10 +38,10 @@ void PIDMuscleLengthController::Initialise(double Kp, double Ki, double Kd)
 
 void PIDMuscleLengthController::Update()
 {
-    assert(simulation()->GetStepCount() == lastStepCount() + 1);
+    assert(simulation()->GetStepCount() == nextUpdateStepCount());
     setLastStepCount(simulation()->GetStepCount());
 
-    m_dt = simulation()->GetTimeIncrement();
+    m_dt = controlTimeIncrement();
 
     // in this driver, the length is driven by the upstream driver
     m_setpoint = dataSum();
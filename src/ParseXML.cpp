@@ -268,3 +268,11 @@ void rapidxml::parse_error_handler(const char *what, void *where)
 #endif
 
 
+
+void ParseXML::Clear()
+{
+    m_inputConfigDoc.clear();
+    m_ouputConfigDoc.clear();
+    std::vector<char>().swap(m_inputConfigData);
+    std::vector<std::unique_ptr<XMLElement>>().swap(m_elementList);
+}
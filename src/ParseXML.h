@@ -35,6 +35,9 @@ public:
 
     std::vector<std::unique_ptr<XMLElement>> *elementList();
 
+    // frees the parsed document, the input buffer and the element list
+    void Clear();
+
 private:
     rapidxml::xml_attribute<char> *CreateXMLAttribute(rapidxml::xml_node<char> *cur, const std::string &name, const std::string &newValue, bool sorted);
     rapidxml::xml_node<char> *CreateXMLNode(rapidxml::xml_node<char> *parent, const std::string &name);
@@ -20,6 +20,7 @@ public:
     Reporter();
 
     virtual bool ShouldAbort() { return false; }
+    virtual bool HasAbortCondition() { return false; } // reporters that override ShouldAbort need to override this to return true
 
 };
 
@@ -0,0 +1,108 @@
+/*
+ *  RunSummary.cpp
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+#include "RunSummary.h"
+#include "Simulation.h"
+#include "GSUtil.h"
+
+#include <sstream>
+#include <fstream>
+#include <cmath>
+#include <cstdio>
+
+using namespace std::string_literals;
+
+static void JSONString(std::ostream &out, const std::string &value)
+{
+    out << '"';
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+                out << buf;
+            }
+            else out << c;
+        }
+    }
+    out << '"';
+}
+
+// JSON has no representation for inf and nan so these become null
+static void JSONNumber(std::ostream &out, double value)
+{
+    if (!std::isfinite(value)) { out << "null"; return; }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", value);
+    out << buf;
+}
+
+RunSummary::RunSummary()
+{
+}
+
+RunSummary::~RunSummary()
+{
+}
+
+void RunSummary::CaptureSimulation(Simulation *simulation)
+{
+    simulationTime = simulation->GetTime();
+    steps = simulation->GetStepCount();
+    score = simulation->CalculateInstantaneousFitness();
+    mechanicalEnergy = simulation->GetMechanicalEnergy();
+    metabolicEnergy = simulation->GetMetabolicEnergy();
+    contactCountTotal = simulation->GetContactCountTotal();
+    contactCountMax = simulation->GetContactCountMax();
+    numericalErrors = simulation->GetNumericalErrorCount();
+    if (simulation->GetAbortReason().size()) abortReason = simulation->GetAbortReason();
+    stepsPerSecond = simulateTime > 0 ? double(steps) / simulateTime : 0;
+    peakMemory = GSUtil::GetPeakMemoryUsage();
+}
+
+std::string RunSummary::ToJSON() const
+{
+    std::ostringstream out;
+    out << '{';
+    if (configFilename.size()) { out << "\"config\":"; JSONString(out, configFilename); out << ','; }
+    if (runID >= 0) out << "\"runID\":" << runID << ",\"evolveIdentifier\":" << evolveIdentifier << ',';
+    out << "\"simulationTime\":"; JSONNumber(out, simulationTime);
+    out << ",\"steps\":" << steps;
+    out << ",\"score\":"; JSONNumber(out, score);
+    out << ",\"mechanicalEnergy\":"; JSONNumber(out, mechanicalEnergy);
+    out << ",\"metabolicEnergy\":"; JSONNumber(out, metabolicEnergy);
+    out << ",\"loadTime\":"; JSONNumber(out, loadTime);
+    out << ",\"simulateTime\":"; JSONNumber(out, simulateTime);
+    out << ",\"outputTime\":"; JSONNumber(out, outputTime);
+    out << ",\"stepsPerSecond\":"; JSONNumber(out, stepsPerSecond);
+    out << ",\"contactCountTotal\":" << contactCountTotal;
+    out << ",\"contactCountMax\":" << contactCountMax;
+    out << ",\"numericalErrors\":" << numericalErrors;
+    out << ",\"abortReason\":"; JSONString(out, abortReason);
+    out << ",\"peakMemory\":" << peakMemory;
+    out << '}';
+    return out.str();
+}
+
+bool RunSummary::WriteFile(const std::string &filename, bool append) const
+{
+    std::ofstream file(filename, append ? std::ios::app : std::ios::trunc);
+    if (!file) return true;
+    file << ToJSON() << "\n";
+    return !file;
+}
@@ -0,0 +1,58 @@
+/*
+ *  RunSummary.h
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+// RunSummary collects the performance values for a single simulation run and formats
+// them as a single line JSON object so that the results of many runs can be aggregated
+// without having to parse the log output.
+
+#ifndef RUNSUMMARY_H
+#define RUNSUMMARY_H
+
+#include <string>
+#include <cstdint>
+
+class Simulation;
+
+class RunSummary
+{
+public:
+    RunSummary();
+    virtual ~RunSummary();
+
+    // copies the end of run values from the simulation and fills in the derived values
+    void CaptureSimulation(Simulation *simulation);
+
+    std::string ToJSON() const;
+    // returns true on error
+    bool WriteFile(const std::string &filename, bool append) const;
+
+    std::string configFilename;
+    int64_t runID = -1; // only output if set
+    uint64_t evolveIdentifier = 0;
+
+    double simulationTime = 0;
+    int64_t steps = 0;
+    double score = 0;
+    double mechanicalEnergy = 0;
+    double metabolicEnergy = 0;
+
+    // wall clock times in seconds
+    double loadTime = 0;
+    double simulateTime = 0;
+    double outputTime = 0;
+    double stepsPerSecond = 0;
+
+    uint64_t contactCountTotal = 0;
+    uint64_t contactCountMax = 0;
+    int numericalErrors = 0;
+    std::string abortReason;
+    uint64_t peakMemory = 0; // for the whole process so it is the high water mark for all the runs so far
+};
+
+#endif // RUNSUMMARY_H
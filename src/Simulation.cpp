@@ -53,6 +53,11 @@
 #include "BoxGeom.h"
 #include "StackedBoxCarDriver.h"
 #include "Warehouse.h"
+#include "DumpFile.h"
+#include "AsyncDumpWriter.h"
+#include "ModelStateWriter.h"
+#include "DumpHistory.h"
+#include "TrajectoryRecorder.h"
 #include "FixedDriver.h"
 #include "PIDErrorInController.h"
 #include "TegotaeDriver.h"
@@ -76,14 +81,22 @@
 #include <codecvt>
 #include <functional>
 #include <numeric>
+#include <mutex>
 
 using namespace std::string_literals;
 
 // #define _I(i,j) I[(i)*4+(j)]
 // regex _I\(([0-9]+),([0-9]+)\) to I[(\1)*4+(\2)]
 
+// ODE initialisation and the ODE message handlers are process wide so creating and
+// destroying simulations in different threads needs to be serialised
+static std::mutex s_odeSetupMutex;
+static int s_simulationCount = 0;
+
 Simulation::Simulation()
 {
+    std::lock_guard<std::mutex> lock(s_odeSetupMutex);
+
     // initialise the ODE world
     dInitODE();
     m_WorldID = dWorldCreate();
@@ -92,6 +105,7 @@ Simulation::Simulation()
 
     // glue for calling a C++ callback
     // Store member function and the instance using std::bind.
+    // the callback is thread local so ODE messages go to the simulation created in the thread that produced them
     Callback<void(int, const char *, va_list)>::func = std::bind(&ErrorHandler::ODEMessageTrap, &m_errorHandler, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
     // Convert callback-function to c-pointer.
     void (*c_func)(int, const char *, va_list) = static_cast<decltype(c_func)>(Callback<void(int, const char *, va_list)>::callback);
@@ -104,11 +118,16 @@ Simulation::Simulation()
 //    dSetErrorHandler(ErrorHandler::ODEMessageTrap);
 //    dSetDebugHandler(ErrorHandler::ODEMessageTrap);
     //    std::cerr << "dGetMessageHandler() = " << size_t(dGetMessageHandler()) << "\n";
+    s_simulationCount++;
 }
 
 //----------------------------------------------------------------------------
 Simulation::~Simulation()
 {
+    // the writer thread needs to finish before the files it writes to are closed
+    if (m_asyncDumpWriter) m_asyncDumpWriter->Stop();
+    if (m_modelStateWriter) m_modelStateWriter->Stop();
+
     // these need to be cleared before we destroy the ODE world
     m_ContactList.clear();
     m_BodyList.clear();
@@ -125,9 +144,16 @@ Simulation::~Simulation()
     m_WarehouseList.clear();
 
     // destroy the ODE world
-    dSetMessageHandler(nullptr);
-    dSetErrorHandler(nullptr);
-    dSetDebugHandler(nullptr);
+    // the handlers are only removed when no other simulation still needs them
+    std::lock_guard<std::mutex> lock(s_odeSetupMutex);
+    Callback<void(int, const char *, va_list)>::func = nullptr;
+    s_simulationCount--;
+    if (s_simulationCount == 0)
+    {
+        dSetMessageHandler(nullptr);
+        dSetErrorHandler(nullptr);
+        dSetDebugHandler(nullptr);
+    }
     dJointGroupDestroy(m_ContactGroup);
     dSpaceDestroy(m_SpaceID);
     dWorldDestroy(m_WorldID);
@@ -216,12 +242,19 @@ std::string *Simulation::LoadModel(const char *buffer, size_t length) // note th
 #ifdef OUTPUTS_AFTER_SIMULATION_STEP
     if (m_OutputModelStateAtTime == 0.0 || m_OutputModelStateAtCycle == 0)
     {
-        OutputProgramState();
+        QueueProgramState(m_OutputModelStateFile);
         m_OutputModelStateAtTime = -1.0;
         m_OutputModelStateAtCycle = -1;
     }
 #endif
 
+    // nothing in the simulation itself needs the XML or the attributes after this point
+    if (m_leanMode)
+    {
+        ReleaseConstructionData();
+        m_parseXML.Clear();
+    }
+
     return nullptr;
 }
 
@@ -257,12 +290,13 @@ void Simulation::UpdateSimulation()
 #endif
         if (m_global->fitnessType() == Global::KinematicMatch || m_global->fitnessType() == Global::KinematicMatchMiniMax)
         {
+            if (!m_dataTargetListValid || m_StepCount == 0) CreateDataTargetList();
             double minScore = DBL_MAX;
-            for (auto &&it : m_DataTargetList)
+            for (auto &&dataTarget : m_dataTargetEvaluationList)
             {
                 double matchScore;
                 bool matchScoreValid;
-                std::tie(matchScore, matchScoreValid) = it.second->calculateMatchValue(m_SimulationTime);
+                std::tie(matchScore, matchScoreValid) = dataTarget->calculateMatchValue(m_SimulationTime);
                 if (matchScoreValid)
                 {
                     m_KinematicMatchFitness += matchScore;
@@ -281,9 +315,10 @@ void Simulation::UpdateSimulation()
     // now start the actual simulation
 
     // check collisions first
+    if (!m_contactAggregateListValid || m_StepCount == 0) CreateContactAggregateList();
     dJointGroupEmpty(m_ContactGroup);
-    m_ContactList.clear();
-    for (auto &&geomIter : m_GeomList) geomIter.second->ClearContacts();
+    m_NumContacts = 0; // the Contact objects themselves are reused
+    if (m_materialiseGeomContacts) { for (auto &&geomIter : m_GeomList) geomIter.second->ClearContacts(); }
     dSpaceCollide(m_SpaceID, this, &NearCallback);
 
 #ifdef EXPERIMENTAL
@@ -311,9 +346,12 @@ void Simulation::UpdateSimulation()
 #endif
 
     // update the drivers
+    if (!m_driverInputsValid || m_StepCount == 0) LinkDriverInputs();
+    // drivers with a control period are only updated every few steps and their output is held in between
+    // SendData is still called because drivers that override it need to resend the held value
     for (auto &&it : m_DriverList)
     {
-        it.second->Update();
+        if (it.second->UpdateDue(m_StepCount)) it.second->Update();
         it.second->SendData();
     }
     // and the controllers (which are drivers too probably)
@@ -322,13 +360,16 @@ void Simulation::UpdateSimulation()
         auto driver = dynamic_cast<Driver *>(it.second.get());
         if (driver)
         {
-            driver->Update();
+            if (driver->UpdateDue(m_StepCount)) driver->Update();
             driver->SendData();
         }
-        if (it.second->lastStepCount() != m_StepCount)
+        if (it.second->UpdateDue(m_StepCount))
             std::cerr << "Warning: " << it.first << " controller not updated\n"; // currently cannot stack controllers although this is fixable
     }
 
+    // muscle and fluid sac forces are summed per body and applied in a single call per body
+    for (auto &&it : m_BodyList) it.second->ClearExternalLoads();
+
     // update the muscles
     for (auto iter1 = m_MuscleList.begin(); iter1 != m_MuscleList.end(); /* no increment */)
     {
@@ -355,9 +396,8 @@ void Simulation::UpdateSimulation()
         {
             PointForce *pointForce = (*pointForceList)[i].get();
             if (pointForce->body)
-                dBodyAddForceAtPos(pointForce->body->GetBodyID(),
-                                   pointForce->vector[0] * tension, pointForce->vector[1] * tension, pointForce->vector[2] * tension,
-                                   pointForce->point[0], pointForce->point[1], pointForce->point[2]);
+                pointForce->body->AddExternalForceAtPosition(pointForce->vector[0] * tension, pointForce->vector[1] * tension, pointForce->vector[2] * tension,
+                                                             pointForce->point[0], pointForce->point[1], pointForce->point[2]);
 #ifdef DEBUG_CHECK_FORCES
             force += pgd::Vector3(pointForce->vector[0] * tension, pointForce->vector[1] * tension, pointForce->vector[2] * tension);
 #endif
@@ -382,13 +422,16 @@ void Simulation::UpdateSimulation()
         for (size_t i = 0; i < fsIter->second->pointForceList().size(); i++)
         {
             const PointForce *pf = &fsIter->second->pointForceList().at(i);
-            dBodyAddForceAtPos(pf->body->GetBodyID(), pf->vector[0], pf->vector[1], pf->vector[2], pf->point[0], pf->point[1], pf->point[2]);
+            if (pf->body) pf->body->AddExternalForceAtPosition(pf->vector[0], pf->vector[1], pf->vector[2], pf->point[0], pf->point[1], pf->point[2]);
         }
     }
 
+    for (auto &&it : m_BodyList) it.second->ApplyExternalLoads();
+
 #ifdef EXPERIMENTAL
     // update the bodies (needed for drag calculations)
-    for (auto &&bodyIter : m_BodyList) bodyIter.second->ComputeDrag();
+    if (!m_dragListsValid || m_StepCount == 0) CreateDragLists();
+    ComputeDrag();
 #endif
 
 #ifndef OUTPUTS_AFTER_SIMULATION_STEP
@@ -397,20 +440,25 @@ void Simulation::UpdateSimulation()
     {
         if (m_SimulationTime >= m_OutputModelStateAtTime)
         {
-            OutputProgramState();
+            QueueProgramState(m_OutputModelStateFile);
             m_OutputModelStateAtTime = -1;
         }
     }
     else if (m_OutputModelStateAtCycle >= 0 && m_CycleTime >= 0 && m_SimulationTime >= m_CycleTime * m_OutputModelStateAtCycle)
     {
-        OutputProgramState();
+        QueueProgramState(m_OutputModelStateFile);
         m_OutputModelStateAtCycle = -1;
     }
     else if (m_OutputModelStateAtWarehouseDistance > 0 && m_WarehouseDistance >= m_OutputModelStateAtWarehouseDistance)
     {
-        OutputProgramState();
+        QueueProgramState(m_OutputModelStateFile);
         m_OutputModelStateAtWarehouseDistance = 0;
     }
+    if (m_OutputModelStateEvery > 0 && m_SimulationTime >= m_OutputModelStateNextTime)
+    {
+        QueueProgramState(ModelStateCheckpointFilename());
+        m_OutputModelStateNextTime += m_OutputModelStateEvery;
+    }
 #endif
 
     // run the simulation
@@ -424,6 +472,8 @@ void Simulation::UpdateSimulation()
         dWorldQuickStep(m_WorldID, m_global->StepSize());
         break;
     }
+    // the step has moved all the bodies so any cached values (e.g. marker world positions) are now invalid
+    for (auto &&it : m_BodyList) it.second->IncrementStateVersion();
 
     // test for penalties
     if (m_errorHandler.IsMessage()) m_KinematicMatchFitness += m_global->NumericalErrorsScore();
@@ -436,9 +486,14 @@ void Simulation::UpdateSimulation()
     }
     m_MetabolicEnergy += m_global->BMR() * m_global->StepSize();
 
+    // the contact forces are only valid after the step
+    AggregateContacts();
+    m_contactCountTotal += m_NumContacts;
+    m_contactCountMax = std::max(m_contactCountMax, m_NumContacts);
+
     // update any contact force dependent drivers (because only after the simulation is the force valid
     // update the footprint indicator
-    if (m_ContactList.size() > 0)
+    if (m_NumContacts > 0)
     {
         for (auto &&it : m_DriverList)
         {
@@ -449,7 +504,17 @@ void Simulation::UpdateSimulation()
 
     // all reporting is done after a simulation step
 
+    // contact changes can trigger dumping and the trigger needs to happen before this step is dumped
+    if (!m_dumpListsValid) CreateDumpLists();
+    if (m_dumpTriggerGeomList.size()) CheckContactDumpTriggers();
     DumpObjects();
+    if (m_trajectoryRecorder)
+    {
+        // preallocate for the whole run when the time limit is known
+        if (m_trajectoryRecorder->GetTime().capacity() == 0 && m_global->TimeLimit() > 0)
+            m_trajectoryRecorder->Reserve(size_t(m_global->TimeLimit() / m_global->StepSize()) / size_t(m_trajectoryRecorder->interval()) + 2);
+        m_trajectoryRecorder->Record(m_StepCount, m_SimulationTime);
+    }
 
     // update the time counter
     m_SimulationTime += m_global->StepSize();
@@ -465,25 +530,391 @@ void Simulation::UpdateSimulation()
     {
         if (m_SimulationTime >= m_OutputModelStateAtTime)
         {
-            OutputProgramState();
+            QueueProgramState(m_OutputModelStateFile);
             m_OutputModelStateAtTime = 0.0;
         }
     }
     else if (m_OutputModelStateAtCycle >= 0 && m_CycleTime >= 0 && m_SimulationTime >= m_CycleTime * m_OutputModelStateAtCycle)
     {
-        OutputProgramState();
+        QueueProgramState(m_OutputModelStateFile);
         m_OutputModelStateAtCycle = -1;
     }
     else if (m_OutputModelStateAtWarehouseDistance > 0 && m_WarehouseDistance >= m_OutputModelStateAtWarehouseDistance)
     {
-        OutputProgramState();
+        QueueProgramState(m_OutputModelStateFile);
         m_OutputModelStateAtWarehouseDistance = 0;
     }
+    if (m_OutputModelStateEvery > 0 && m_SimulationTime >= m_OutputModelStateNextTime)
+    {
+        QueueProgramState(ModelStateCheckpointFilename());
+        m_OutputModelStateNextTime += m_OutputModelStateEvery;
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------
+// drivers only send their values when they change so every target needs an input slot for each driver
+// so that it can remember the last value it was sent
+void Simulation::LinkDriverInputs()
+{
+    for (auto &&it : m_MuscleList) it.second->ClearInputs();
+    for (auto &&it : m_ControllerList) it.second->ClearInputs();
+    for (auto &&it : m_DriverList) it.second->LinkTargetInputs();
+    for (auto &&it : m_ControllerList) it.second->LinkTargetInputs();
+    m_driverInputsValid = true;
+}
+
+#ifdef EXPERIMENTAL
+//----------------------------------------------------------------------------
+// this creates the drag lists and copies in the per body constants
+void Simulation::CreateDragLists()
+{
+    m_dragCoefficientBodyList.clear();
+    for (size_t j = 0; j < 6; j++) m_dragCoefficients[j].clear();
+    m_dragCylinderBodyList.clear();
+    m_dragCylinderAxisList.clear();
+    m_dragCylinderAxialCoefficients.clear();
+    m_dragCylinderNormalCoefficients.clear();
+    for (size_t k = 0; k < 4; k++) m_dragCylinderQuadraturePoints[k].clear();
+    for (auto &&it : m_BodyList)
+    {
+        Body *body = it.second.get();
+        switch (body->GetDragControl())
+        {
+        case Body::NoDrag:
+            break;
+        case Body::DragCoefficients:
+            m_dragCoefficientBodyList.push_back(body);
+            for (size_t j = 0; j < 6; j++) m_dragCoefficients[j].push_back(body->GetDragCoefficients()[j]);
+            break;
+        case Body::DragCylinderX:
+        case Body::DragCylinderY:
+        case Body::DragCylinderZ:
+            m_dragCylinderBodyList.push_back(body);
+            m_dragCylinderAxisList.push_back(size_t(body->GetDragControl() - Body::DragCylinderX));
+            m_dragCylinderAxialCoefficients.push_back(body->GetDragCylinderAxialCoefficient());
+            m_dragCylinderNormalCoefficients.push_back(body->GetDragCylinderNormalCoefficient());
+            for (size_t k = 0; k < 4; k++) m_dragCylinderQuadraturePoints[k].push_back(body->GetDragCylinderQuadraturePoints()[k]);
+            break;
+        }
+    }
+    for (size_t j = 0; j < 6; j++)
+    {
+        m_dragCoefficientVelocities[j].resize(m_dragCoefficientBodyList.size());
+        m_dragCylinderVelocities[j].resize(m_dragCylinderBodyList.size());
+        m_dragCylinderForces[j].resize(m_dragCylinderBodyList.size());
+    }
+    m_dragListsValid = true;
+}
+
+//----------------------------------------------------------------------------
+// drag calculation modified from Dynamechs 4.0 by Scott McMillan with all the bodies done together
+// the body frame velocities are gathered first so that the inner loops are simple arithmetic on contiguous arrays
+// the cylinder components are permuted so that the cylinder axis comes first which means X, Y and Z cylinders share the same loop
+void Simulation::ComputeDrag()
+{
+    // the velocities in body coordinates (the same as dBodyVectorFromWorld) with the angular velocity first
+    auto bodyFrameVelocities = [](Body *body, double v_rel[6])
+    {
+        const double *R = dBodyGetRotation(body->GetBodyID());
+        const double *aVel = dBodyGetAngularVel(body->GetBodyID());
+        const double *lVel = dBodyGetLinearVel(body->GetBodyID());
+        for (size_t j = 0; j < 3; j++)
+        {
+            v_rel[j] = R[j] * aVel[0] + R[j + 4] * aVel[1] + R[j + 8] * aVel[2];
+            v_rel[j + 3] = R[j] * lVel[0] + R[j + 4] * lVel[1] + R[j + 8] * lVel[2];
+        }
+    };
+    double v_rel[6];
+
+    size_t n = m_dragCoefficientBodyList.size();
+    if (n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            bodyFrameVelocities(m_dragCoefficientBodyList[i], v_rel);
+            for (size_t j = 0; j < 6; j++) m_dragCoefficientVelocities[j][i] = v_rel[j];
+        }
+        for (size_t j = 0; j < 6; j++)
+        {
+            const double *c = m_dragCoefficients[j].data();
+            double *v = m_dragCoefficientVelocities[j].data(); // overwritten with the drag
+            for (size_t i = 0; i < n; i++) v[i] = -c[i] * v[i] * std::fabs(v[i]);
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            dBodyID bodyID = m_dragCoefficientBodyList[i]->GetBodyID();
+            dBodyAddRelTorque(bodyID, m_dragCoefficientVelocities[0][i], m_dragCoefficientVelocities[1][i], m_dragCoefficientVelocities[2][i]);
+            dBodyAddRelForce(bodyID, m_dragCoefficientVelocities[3][i], m_dragCoefficientVelocities[4][i], m_dragCoefficientVelocities[5][i]);
+        }
+    }
+
+    n = m_dragCylinderBodyList.size();
+    if (n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            bodyFrameVelocities(m_dragCylinderBodyList[i], v_rel);
+            size_t a = m_dragCylinderAxisList[i];
+            for (size_t j = 0; j < 3; j++)
+            {
+                m_dragCylinderVelocities[j][i] = v_rel[(a + j) % 3];
+                m_dragCylinderVelocities[j + 3][i] = v_rel[(a + j) % 3 + 3];
+            }
+        }
+
+        const double *wb = m_dragCylinderVelocities[1].data();
+        const double *wc = m_dragCylinderVelocities[2].data();
+        const double *va = m_dragCylinderVelocities[3].data();
+        const double *vb = m_dragCylinderVelocities[4].data();
+        const double *vc = m_dragCylinderVelocities[5].data();
+        double *fwa = m_dragCylinderForces[0].data();
+        double *fwb = m_dragCylinderForces[1].data();
+        double *fwc = m_dragCylinderForces[2].data();
+        double *fva = m_dragCylinderForces[3].data();
+        double *fvb = m_dragCylinderForces[4].data();
+        double *fvc = m_dragCylinderForces[5].data();
+        const double *Ca = m_dragCylinderAxialCoefficients.data();
+        const double *C2rl = m_dragCylinderNormalCoefficients.data();
+
+        // axial moment and force
+        for (size_t i = 0; i < n; i++)
+        {
+            fwa[i] = 0;
+            fwb[i] = 0;
+            fwc[i] = 0;
+            fva[i] = -Ca[i] * va[i] * std::fabs(va[i]);
+            fvb[i] = 0;
+            fvc[i] = 0;
+        }
+        // normal components using Gauss-quadrature
+        for (size_t k = 0; k < 4; k++)
+        {
+            const double *x = m_dragCylinderQuadraturePoints[k].data();
+            const double gqk = Body::dragGaussQuadratureK[k];
+            for (size_t i = 0; i < n; i++)
+            {
+                double vnb = vb[i] + wc[i] * x[i];
+                double vnc = vc[i] - wb[i] * x[i];
+                double tmp = gqk * std::sqrt(vnb * vnb + vnc * vnc);
+                double temb = tmp * vnb;
+                double temc = tmp * vnc;
+                fwb[i] += (-x[i] * temc);
+                fwc[i] += x[i] * temb;
+                fvb[i] += temb;
+                fvc[i] += temc;
+            }
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            fwb[i] *= -C2rl[i];
+            fwc[i] *= -C2rl[i];
+            fvb[i] *= -C2rl[i];
+            fvc[i] *= -C2rl[i];
+        }
+
+        // drag forces need permuting back to body coordinates and adding to the body
+        double f_D[6];
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t a = m_dragCylinderAxisList[i];
+            for (size_t j = 0; j < 3; j++)
+            {
+                f_D[(a + j) % 3] = m_dragCylinderForces[j][i];
+                f_D[(a + j) % 3 + 3] = m_dragCylinderForces[j + 3][i];
+            }
+            dBodyID bodyID = m_dragCylinderBodyList[i]->GetBodyID();
+            dBodyAddRelTorque(bodyID, f_D[0], f_D[1], f_D[2]);
+            dBodyAddRelForce(bodyID, f_D[3], f_D[4], f_D[5]);
+        }
+    }
+}
 #endif
+
+//----------------------------------------------------------------------------
+// this gives each geom and body a slot in the contact aggregate lists
+// and decides whether the per geom Contact lists need to be filled in
+void Simulation::CreateContactAggregateList()
+{
+    m_contactAggregateGeomList.clear();
+    m_contactAggregateGeomBodyIndexList.clear();
+    size_t bodyIndex = 0;
+    for (auto &&it : m_BodyList) it.second->SetContactAggregateIndex(bodyIndex++);
+    m_materialiseGeomContacts = false;
+    for (auto &&it : m_GeomList)
+    {
+        Geom *geom = it.second.get();
+        geom->SetContactAggregateIndex(m_contactAggregateGeomList.size());
+        m_contactAggregateGeomList.push_back(geom);
+        dBodyID bodyID = geom->GetBody();
+        if (bodyID) m_contactAggregateGeomBodyIndexList.push_back(reinterpret_cast<Body *>(dBodyGetData(bodyID))->GetContactAggregateIndex());
+        else m_contactAggregateGeomBodyIndexList.push_back(SIZE_MAX);
+        if (geom->dump()) m_materialiseGeomContacts = true;
+        geom->ClearContacts();
+    }
+    m_geomContactAggregateList.assign(m_contactAggregateGeomList.size(), ContactAggregate());
+    m_bodyContactAggregateList.assign(m_BodyList.size(), ContactAggregate());
+    m_contactAggregateListValid = true;
+}
+
+//----------------------------------------------------------------------------
+// this sums the contact forces from the last step for each geom and each body
+// the force on a geom is the feedback force for its own body and for an environment geom it is the reaction
+// to the force on the other body
+void Simulation::AggregateContacts()
+{
+    std::fill(m_geomContactAggregateList.begin(), m_geomContactAggregateList.end(), ContactAggregate());
+    std::fill(m_bodyContactAggregateList.begin(), m_bodyContactAggregateList.end(), ContactAggregate());
+    if (m_NumContacts == 0) return;
+
+    for (size_t i = 0; i < m_NumContacts; i++)
+    {
+        Contact *contact = m_ContactList[i].get();
+        dJointFeedback *jointFeedback = contact->GetJointFeedback();
+        dBodyID body0 = dJointGetBody(contact->GetJointID(), 0);
+        dBodyID body1 = dJointGetBody(contact->GetJointID(), 1);
+        pgd::Vector3 position(contact->GetContactPosition());
+        Geom *geoms[2] = {contact->GetGeom1(), contact->GetGeom2()};
+        for (size_t j = 0; j < 2; j++)
+        {
+            size_t geomIndex = geoms[j]->GetContactAggregateIndex();
+            if (geomIndex >= m_geomContactAggregateList.size()) continue;
+            // when only one body is attached ODE always stores its force in f1 even if it was attached
+            // as the second body (dJointGetBody then returns 0 for index 0) so f2 is only valid with two bodies
+            dBodyID bodyID = geoms[j]->GetBody();
+            pgd::Vector3 force;
+            if (body0 && body1) force.Set(bodyID == body0 ? jointFeedback->f1 : jointFeedback->f2);
+            else if (bodyID) force.Set(jointFeedback->f1);
+            else force = -pgd::Vector3(jointFeedback->f1);
+            pgd::Vector3 torque = pgd::Cross(position, force);
+            double magnitude = force.Magnitude();
+
+            ContactAggregate *aggregate = &m_geomContactAggregateList[geomIndex];
+            aggregate->force += force;
+            aggregate->torque += torque;
+            aggregate->centreOfPressure += position * magnitude;
+            aggregate->forceMagnitudeSum += magnitude;
+            aggregate->numContacts++;
+
+            size_t bodyIndex = m_contactAggregateGeomBodyIndexList[geomIndex];
+            if (bodyIndex == SIZE_MAX) continue;
+            aggregate = &m_bodyContactAggregateList[bodyIndex];
+            aggregate->force += force;
+            aggregate->torque += torque;
+            aggregate->centreOfPressure += position * magnitude;
+            aggregate->forceMagnitudeSum += magnitude;
+            aggregate->numContacts++;
+        }
+    }
+
+    // convert the weighted position sums into the centres of pressure
+    for (auto &&aggregate : m_geomContactAggregateList)
+    {
+        if (aggregate.forceMagnitudeSum > 0) aggregate.centreOfPressure /= aggregate.forceMagnitudeSum;
+        else aggregate.centreOfPressure.Set(0, 0, 0);
+    }
+    for (auto &&aggregate : m_bodyContactAggregateList)
+    {
+        if (aggregate.forceMagnitudeSum > 0) aggregate.centreOfPressure /= aggregate.forceMagnitudeSum;
+        else aggregate.centreOfPressure.Set(0, 0, 0);
+    }
+}
+
+const ContactAggregate &Simulation::GetGeomContactAggregate(Geom *geom) const
+{
+    static const ContactAggregate emptyAggregate;
+    size_t index = geom->GetContactAggregateIndex();
+    if (index < m_geomContactAggregateList.size() && m_contactAggregateGeomList[index] == geom) return m_geomContactAggregateList[index];
+    return emptyAggregate;
+}
+
+const ContactAggregate &Simulation::GetBodyContactAggregate(const Body *body) const
+{
+    static const ContactAggregate emptyAggregate;
+    size_t index = body->GetContactAggregateIndex();
+    if (index < m_bodyContactAggregateList.size()) return m_bodyContactAggregateList[index];
+    return emptyAggregate;
+}
+
+//----------------------------------------------------------------------------
+// this creates the list of DataTargets for the fitness calculation
+// DataTargets with identical target times are linked so that they all share a single time cursor
+void Simulation::CreateDataTargetList()
+{
+    m_dataTargetEvaluationList.clear();
+    std::vector<DataTarget *> timeBaseList;
+    for (auto &&it : m_DataTargetList)
+    {
+        DataTarget *dataTarget = it.second.get();
+        dataTarget->setTimeBase(nullptr);
+        for (auto &&timeBase : timeBaseList)
+        {
+            if (timeBase->hasSameTargetTimes(*dataTarget))
+            {
+                dataTarget->setTimeBase(timeBase);
+                break;
+            }
+        }
+        if (dataTarget->timeBase() == nullptr) timeBaseList.push_back(dataTarget);
+        m_dataTargetEvaluationList.push_back(dataTarget);
+    }
+    m_dataTargetListValid = true;
+}
+
+//----------------------------------------------------------------------------
+// this creates the lists of objects that TestForCatastrophy needs to check
+// so that objects that cannot cause an abort are skipped completely
+void Simulation::CreateAbortLists()
+{
+    m_abortBodyList.clear();
+    m_abortLimitBodyList.clear();
+    m_abortLimitBodyLowBounds.clear();
+    m_abortLimitBodyHighBounds.clear();
+    for (auto &&it : m_BodyList)
+    {
+        Body *body = it.second.get();
+        m_abortBodyList.push_back(body);
+        if (!body->HasFiniteLimits()) continue;
+        m_abortLimitBodyList.push_back(body);
+        const double *lowBounds[3] = { body->GetPositionLowBound(), body->GetLinearVelocityLowBound(), body->GetAngularVelocityLowBound() };
+        const double *highBounds[3] = { body->GetPositionHighBound(), body->GetLinearVelocityHighBound(), body->GetAngularVelocityHighBound() };
+        for (size_t i = 0; i < 3; i++)
+        {
+            m_abortLimitBodyLowBounds.insert(m_abortLimitBodyLowBounds.end(), lowBounds[i], lowBounds[i] + 3);
+            m_abortLimitBodyHighBounds.insert(m_abortLimitBodyHighBounds.end(), highBounds[i], highBounds[i] + 3);
+        }
+    }
+    m_abortLimitBodyState.resize(m_abortLimitBodyLowBounds.size());
+
+    m_abortHingeJointList.clear();
+    m_abortFixedJointList.clear();
+    for (auto &&it : m_JointList)
+    {
+        HingeJoint *hingeJoint = dynamic_cast<HingeJoint *>(it.second.get());
+        if (hingeJoint && hingeJoint->HasTorqueLimits()) m_abortHingeJointList.push_back(hingeJoint);
+        FixedJoint *fixedJoint = dynamic_cast<FixedJoint *>(it.second.get());
+        if (fixedJoint && fixedJoint->GetStressCalculationType() != FixedJoint::none && fixedJoint->GetStressLimit() > 0) m_abortFixedJointList.push_back(fixedJoint);
+    }
+
+    m_abortReporterList.clear();
+    for (auto &&it : m_ReporterList)
+    {
+        if (it.second->HasAbortCondition()) m_abortReporterList.push_back(it.second.get());
+    }
+
+    m_abortListsValid = true;
 }
 
 //----------------------------------------------------------------------------
 bool Simulation::TestForCatastrophy()
+{
+    if (!TestAbortConditions()) return false;
+    // the abort can be a dump trigger so that the history leading up to the failure is kept
+    if (m_dumpTriggersEnabled) DumpTriggerEvent(m_abortReason, true);
+    return true;
+}
+
+bool Simulation::TestAbortConditions()
 {
     // first of all check to see that ODE is happy
     if (m_errorHandler.IsMessage())
@@ -493,12 +924,14 @@ bool Simulation::TestForCatastrophy()
         m_numericalErrorCount++;
         if (m_global->PermittedNumericalErrors() >= 0 && m_numericalErrorCount > m_global->PermittedNumericalErrors())
         {
+            m_abortReason = "ODEWarning"s;
             std::cerr << "t=" << m_SimulationTime << " error count=" << m_numericalErrorCount << " Failed due to ODE warning " << num << " " << messageText << "\n";
             return true;
         }
         else
         {
             std::cerr << "t=" << m_SimulationTime << " ODE warning " << num << " " << messageText << "\n";
+            if (m_dumpTriggersEnabled) DumpTriggerEvent("ODEWarning"s, false);
         }
         m_errorHandler.ClearMessage();
     }
@@ -506,6 +939,7 @@ bool Simulation::TestForCatastrophy()
     // check for simulation error
     if (m_SimulationError)
     {
+        m_abortReason = "SimulationError"s;
         std::cerr << "Failed due to simulation error " << m_SimulationError << "\n";
         return true;
     }
@@ -513,6 +947,7 @@ bool Simulation::TestForCatastrophy()
     // check for contact abort
     if (m_ContactAbort)
     {
+        m_abortReason = "ContactAbort"s;
         std::cerr << "Failed due to contact abort\n";
         for (auto &&it: m_ContactAbortList) { std::cerr << it << "\n"; }
         return true;
@@ -521,84 +956,106 @@ bool Simulation::TestForCatastrophy()
     // check for data target abort
     if (m_DataTargetAbort)
     {
+        m_abortReason = "DataTargetAbort"s;
         std::cerr << "Failed due to DataTarget abort\n";
         for (auto &&it: m_DataTargetAbortList) { std::cerr << it << "\n"; }
         return true;
     }
 
-    // check that all bodies meet velocity and stop conditions
+    // the abort lists only need to be recreated if the model might have changed which can only happen before the simulation starts
+    if (!m_abortListsValid || m_StepCount <= 1) CreateAbortLists();
 
-    Body::LimitTestResult p;
-    for (auto &&iter1 : m_BodyList)
+    // numerical errors are always fatal so all the bodies are checked every step
+    for (auto &&body : m_abortBodyList)
     {
-        p = iter1.second->TestLimits();
-        switch (p)
+        const double *state[3] = { dBodyGetPosition(body->GetBodyID()), dBodyGetLinearVel(body->GetBodyID()), dBodyGetAngularVel(body->GetBodyID()) };
+        for (size_t i = 0; i < 9; i++)
         {
-        case Body::WithinLimits:
-            break;
-
-        case Body::XPosError:
-        case Body::YPosError:
-        case Body::ZPosError:
-            std::cerr << "Failed due to position error " << Body::limitTestResultStrings(p) << " in: " << iter1.second->name() << "\n";
-            return true;
-
-        case Body::XVelError:
-        case Body::YVelError:
-        case Body::ZVelError:
-            std::cerr << "Failed due to linear velocity error " << Body::limitTestResultStrings(p) << " in: " << iter1.second->name() << "\n";
-            return true;
-
-        case Body::XAVelError:
-        case Body::YAVelError:
-        case Body::ZAVelError:
-            std::cerr << "Failed due to angular velocity error " << Body::limitTestResultStrings(p) << " in: " << iter1.second->name() << "\n";
-            return true;
-
-        case Body::NumericalError:
-            std::cerr << "Failed due to numerical error " << Body::limitTestResultStrings(p) << " in: " << iter1.second->name() << "\n";
-            return true;
+            int c = std::fpclassify(state[i / 3][i % 3]);
+            if (c != FP_NORMAL && c != FP_ZERO)
+            {
+                m_abortReason = "NumericalError"s;
+                std::cerr << "Failed due to numerical error " << Body::limitTestResultStrings(Body::NumericalError) << " in: " << body->name() << "\n";
+                return true;
+            }
         }
     }
 
-    HingeJoint *j;
-    FixedJoint *f;
-    int t;
-    for (auto &&iter3 : m_JointList)
+    // the remaining conditions can optionally be tested less frequently
+    if (m_abortCheckInterval > 1 && m_StepCount % m_abortCheckInterval) return false;
+
+    // gather the state of the bodies with limits and test them all in one pass
+    size_t nLimitBodies = m_abortLimitBodyList.size();
+    if (nLimitBodies)
     {
-        j = dynamic_cast<HingeJoint *>(iter3.second.get());
-        if (j)
+        double *statePtr = m_abortLimitBodyState.data();
+        for (auto &&body : m_abortLimitBodyList)
         {
-            t = j->TestLimits();
-            if (t < 0)
-            {
-                std::cerr << "Failed due to LoStopTorqueLimit error in: " << iter3.second->name() << "\n";
-                return true;
-            }
-            else if (t > 0)
+            const double *p = dBodyGetPosition(body->GetBodyID());
+            const double *v = dBodyGetLinearVel(body->GetBodyID());
+            const double *a = dBodyGetAngularVel(body->GetBodyID());
+            statePtr[0] = p[0]; statePtr[1] = p[1]; statePtr[2] = p[2];
+            statePtr[3] = v[0]; statePtr[4] = v[1]; statePtr[5] = v[2];
+            statePtr[6] = a[0]; statePtr[7] = a[1]; statePtr[8] = a[2];
+            statePtr += 9;
+        }
+        const double *state = m_abortLimitBodyState.data();
+        const double *low = m_abortLimitBodyLowBounds.data();
+        const double *high = m_abortLimitBodyHighBounds.data();
+        size_t n = nLimitBodies * 9;
+        int outOfRange = 0;
+        for (size_t i = 0; i < n; i++) outOfRange |= int(state[i] < low[i]) | int(state[i] > high[i]);
+        if (outOfRange)
+        {
+            // only need to find out which one if something has failed
+            for (size_t i = 0; i < n; i++)
             {
-                std::cerr << "Failed due to HiStopTorqueLimit error in: " << iter3.second->name() << "\n";
+                if (state[i] >= low[i] && state[i] <= high[i]) continue;
+                Body *body = m_abortLimitBodyList[i / 9];
+                Body::LimitTestResult p = static_cast<Body::LimitTestResult>(Body::XPosError + int(i % 9));
+                m_abortReason = "BodyLimit"s;
+                if (p <= Body::ZPosError) std::cerr << "Failed due to position error " << Body::limitTestResultStrings(p) << " in: " << body->name() << "\n";
+                else if (p <= Body::ZVelError) std::cerr << "Failed due to linear velocity error " << Body::limitTestResultStrings(p) << " in: " << body->name() << "\n";
+                else std::cerr << "Failed due to angular velocity error " << Body::limitTestResultStrings(p) << " in: " << body->name() << "\n";
                 return true;
             }
         }
+    }
 
-        f = dynamic_cast<FixedJoint *>(iter3.second.get());
-        if (f)
+    for (auto &&hingeJoint : m_abortHingeJointList)
+    {
+        int t = hingeJoint->TestLimits();
+        if (t < 0)
         {
-            if (f->CheckStressAbort())
-            {
-                std::cerr << "Failed due to stress limit error in: " << iter3.second->name() << " " << f->GetLowPassMinStress() << " " << f->GetLowPassMaxStress() << "\n";
-                return true;
-            }
+            m_abortReason = "HingeJointTorqueLimit"s;
+            std::cerr << "Failed due to LoStopTorqueLimit error in: " << hingeJoint->name() << "\n";
+            return true;
+        }
+        else if (t > 0)
+        {
+            m_abortReason = "HingeJointTorqueLimit"s;
+            std::cerr << "Failed due to HiStopTorqueLimit error in: " << hingeJoint->name() << "\n";
+            return true;
+        }
+    }
+
+    for (auto &&fixedJoint : m_abortFixedJointList)
+    {
+        if (fixedJoint->CheckStressAbort())
+        {
+            m_abortReason = "FixedJointStressLimit"s;
+            std::cerr << "Failed due to stress limit error in: " << fixedJoint->name() << " " << fixedJoint->GetLowPassMinStress() << " " << fixedJoint->GetLowPassMaxStress() << "\n";
+            return true;
         }
     }
 
     // and test the reporters for stop conditions
-    for (auto &&reporterIter : m_ReporterList)
+    for (auto &&reporter : m_abortReporterList)
     {
-        if (reporterIter.second->ShouldAbort())
+        if (reporter->ShouldAbort())
         {
-            std::cerr << "Failed due to Reporter Abort in: " << reporterIter.second->name() << "\n";
+            m_abortReason = "ReporterAbort"s;
+            std::cerr << "Failed due to Reporter Abort in: " << reporter->name() << "\n";
             return true;
         }
     }
@@ -609,6 +1066,7 @@ bool Simulation::TestForCatastrophy()
     {
         if (m_WarehouseDistance > m_global->WarehouseFailDistanceAbort())
         {
+            m_abortReason = "WarehouseFailDistanceAbort"s;
             std::cerr << "Failed due to >WarehouseFailDistanceAbort. m_global->WarehouseFailDistanceAbort()=" << m_global->WarehouseFailDistanceAbort() << " WarehouseDistance = " << m_WarehouseDistance << "\n";
             return true;
         }
@@ -617,6 +1075,7 @@ bool Simulation::TestForCatastrophy()
     {
         if (m_WarehouseDistance < std::fabs(m_global->WarehouseFailDistanceAbort()))
         {
+            m_abortReason = "WarehouseFailDistanceAbort"s;
             std::cerr << "Failed due to <WarehouseFailDistanceAbort. m_global->WarehouseFailDistanceAbort()=" << m_global->WarehouseFailDistanceAbort() << " WarehouseDistance = " << m_WarehouseDistance << "\n";
             return true;
         }
@@ -625,6 +1084,7 @@ bool Simulation::TestForCatastrophy()
 
     if (m_OutputModelStateOccured && m_AbortAfterModelStateOutput)
     {
+        m_abortReason = "ModelStateWritten"s;
         std::cerr << "Abort because ModelState successfully written\n";
         return true;
     }
@@ -1213,169 +1673,208 @@ std::string * Simulation::ParseWarehouse(const ParseXML::XMLElement * /*node*/)
 
 void Simulation::OutputWarehouse()
 {
-    if (m_OutputWarehouseAsText)
-    {
-        /* file format is \t separated and \n end of line
-         *
-         * numDrivers name0 name1 name2 ... numBodies name0 name1 name2...
-         * time act0 act1 act2 ... x0 y0 z0 angle0 xaxis0 yaxis0 zaxis0 xv0 yv0 zv0 xav0 yav0 zav0 ...
-         *
-         */
-
-        /* the first defined body is defined as its world coordinates and the rest are relative to the master body */
+    /* text file format is \t separated and \n end of line
+     *
+     * numDrivers name0 name1 name2 ... numBodies name0 name1 name2...
+     * time act0 act1 act2 ... x0 y0 z0 angle0 xaxis0 yaxis0 zaxis0 xv0 yv0 zv0 xav0 yav0 zav0 ...
+     *
+     */
+
+    /* binary file format is (native byte order)
+     * unlike DumpFile this is not converted to little-endian because the records are copied
+     * straight to and from memory so files are not portable between machines of different byte order
+     *
+     * uint32 0
+     * uint32 numDrivers uint32 lenName0 name0 uint32 lenName1 name1 ...
+     * uint32 numBodies uint32 lenName0 name0 uint32 lenName1 name1 ...
+     * uint32 numValuesPerBody (13)
+     * then fixed length records of 1 + numDrivers + numBodies * numValuesPerBody doubles
+     * double time double act0 double act1 double act2 ...
+     * double x0 double y0 double z0 double angle0 double xaxis0 double yaxis0 double zaxis0 double xv0 double yv0 double zv0 double xav0 double yav0 double zav0 ...
+     *
+     */
+
+    /* the first defined body is defined as its world coordinates and the rest are relative to the master body */
+
+    if (m_asyncDumpBufferSize && !m_dumpListsValid) CreateDumpLists();
+
+    // first time through work out the output order and output the column headings
+    if (m_OutputWarehouseLastTime < 0)
+    {
+        auto rootIter = m_BodyList.find(m_global->DistanceTravelledBodyIDName());
+        if (rootIter == m_BodyList.end())
+        {
+            std::cerr << "Error: warehouse output needs a valid DistanceTravelledBodyID\n";
+            SetOutputWarehouseFile(""s);
+            return;
+        }
+        m_warehouseDriverList.clear();
+        for (auto &&iter : m_DriverList) m_warehouseDriverList.push_back(iter.second.get());
+        m_warehouseBodyList.clear();
+        m_warehouseBodyList.push_back(rootIter->second.get());
+        for (auto &&iter : m_BodyList)
+            if (iter.second.get() != m_warehouseBodyList[0]) m_warehouseBodyList.push_back(iter.second.get());
 
-        // first time through output the column headings
-        if (m_OutputWarehouseLastTime < 0)
+        // a large stream buffer means the file is written in big chunks
+        m_OutputWarehouseStreamBuffer.resize(1 << 20);
+        m_OutputWarehouseFile.rdbuf()->pubsetbuf(m_OutputWarehouseStreamBuffer.data(), std::streamsize(m_OutputWarehouseStreamBuffer.size()));
+        std::stringstream header;
+        if (m_OutputWarehouseAsText)
         {
 #if (defined(_WIN32) || defined(WIN32)) && !defined(__MINGW32__)
             m_OutputWarehouseFile.open(DataFile::ConvertUTF8ToWide(m_OutputWarehouseFilename));
 #else
             m_OutputWarehouseFile.open(m_OutputWarehouseFilename);
 #endif
-
-            m_OutputWarehouseFile << m_DriverList.size();
-            for (auto &&iter : m_DriverList) m_OutputWarehouseFile << "\t\"" << iter.second->name() << "\"";
-            m_OutputWarehouseFile << "\t" << m_BodyList.size();
-            m_OutputWarehouseFile << "\t" << m_BodyList[m_global->DistanceTravelledBodyIDName()]->name();
-            for (auto &&iter : m_BodyList)
-                if (iter.second->name() != m_global->DistanceTravelledBodyIDName()) m_OutputWarehouseFile << "\t\"" << iter.second->name() << "\"";
-            m_OutputWarehouseFile << "\n";
-        }
-
-        m_OutputWarehouseLastTime = m_SimulationTime;
-        // simulation time
-        m_OutputWarehouseFile << m_SimulationTime;
-        // driver activations
-        for (auto &&iter : m_DriverList) m_OutputWarehouseFile << "\t" << iter.second->value();
-        // output the root body (m_global->DistanceTravelledBodyIDName())
-        Body *rootBody = m_BodyList[m_global->DistanceTravelledBodyIDName()].get();
-        pgd::Vector3 pos, vel, avel;
-        pgd::Quaternion quat;
-        rootBody->GetRelativePosition(nullptr, &pos);
-        rootBody->GetRelativeQuaternion(nullptr, &quat);
-        rootBody->GetRelativeLinearVelocity(nullptr, &vel);
-        rootBody->GetRelativeAngularVelocity(nullptr, &avel);
-        double angle = QGetAngle(quat);
-        pgd::Vector3 axis = QGetAxis(quat);
-        m_OutputWarehouseFile << "\t" << pos.x << "\t" << pos.y << "\t" << pos.z;
-        m_OutputWarehouseFile << "\t" << angle << "\t" << axis.x << "\t" << axis.y << "\t" << axis.z ;
-        m_OutputWarehouseFile << "\t" << vel.x << "\t" << vel.y << "\t" << vel.z;
-        m_OutputWarehouseFile << "\t" << avel.x << "\t" << avel.y << "\t" << avel.z;
-        // and now the rest of the bodies
-        for (auto &&iter : m_BodyList)
-        {
-            if (iter.second->name() != m_global->DistanceTravelledBodyIDName())
-            {
-                iter.second->GetRelativePosition(rootBody, &pos);
-                iter.second->GetRelativeQuaternion(rootBody, &quat);
-                iter.second->GetRelativeLinearVelocity(rootBody, &vel);
-                iter.second->GetRelativeAngularVelocity(rootBody, &avel);
-                angle = QGetAngle(quat);
-                axis = QGetAxis(quat);
-                m_OutputWarehouseFile << "\t" << pos.x << "\t" << pos.y << "\t" << pos.z;
-                m_OutputWarehouseFile << "\t" << angle << "\t" << axis.x << "\t" << axis.y << "\t" << axis.z ;
-                m_OutputWarehouseFile << "\t" << vel.x << "\t" << vel.y << "\t" << vel.z;
-                m_OutputWarehouseFile << "\t" << avel.x << "\t" << avel.y << "\t" << avel.z;
-            }
+            header << m_warehouseDriverList.size();
+            for (auto &&iter : m_warehouseDriverList) header << "\t\"" << iter->name() << "\"";
+            header << "\t" << m_warehouseBodyList.size();
+            header << "\t" << m_warehouseBodyList[0]->name();
+            for (size_t i = 1; i < m_warehouseBodyList.size(); i++) header << "\t\"" << m_warehouseBodyList[i]->name() << "\"";
+            header << "\n";
         }
-        m_OutputWarehouseFile << "\n";
-    }
-    else
-    {
-        /* file format is binary
-         *
-         * int 0
-         * int numDrivers int lenName0 name0 int lenName1 name1 ...
-         * int numBodies int lenName0 name0 int lenName1 name1 ...
-         * double time double act0 double act1 double act2 ...
-         * double x0 double y0 double z0 double angle0 double xaxis0 double yaxis0 double zaxis0 double xv0 double yv0 double zv0 double xav0 double yav0 double zav0 ...
-         *
-         */
-
-        /* the first defined body is defined as its world coordinates and the rest are relative to the master body */
-
-        // first time through output the column headings
-        if (m_OutputWarehouseLastTime < 0)
+        else
         {
 #if (defined(_WIN32) || defined(WIN32)) && !defined(__MINGW32__)
             m_OutputWarehouseFile.open(DataFile::ConvertUTF8ToWide(m_OutputWarehouseFilename), std::ios::binary);
 #else
             m_OutputWarehouseFile.open(m_OutputWarehouseFilename, std::ios::binary);
 #endif
-            GSUtil::BinaryOutput(m_OutputWarehouseFile, uint32_t(0));
-            GSUtil::BinaryOutput(m_OutputWarehouseFile, uint32_t(m_DriverList.size()));
-            for (auto &&iter : m_DriverList) GSUtil::BinaryOutput(m_OutputWarehouseFile, iter.second->name());
-            GSUtil::BinaryOutput(m_OutputWarehouseFile, uint32_t(m_BodyList.size()));
-            GSUtil::BinaryOutput(m_OutputWarehouseFile, m_BodyList[m_global->DistanceTravelledBodyIDName()]->name());
-            for (auto &&iter : m_BodyList)
-                if (iter.second->name() != m_global->DistanceTravelledBodyIDName()) GSUtil::BinaryOutput(m_OutputWarehouseFile, iter.second->name());
+            auto writeName = [&header](const std::string &name)
+            {
+                GSUtil::BinaryOutput(header, uint32_t(name.size()));
+                header.write(name.data(), std::streamsize(name.size()));
+            };
+            GSUtil::BinaryOutput(header, uint32_t(0));
+            GSUtil::BinaryOutput(header, uint32_t(m_warehouseDriverList.size()));
+            for (auto &&iter : m_warehouseDriverList) writeName(iter->name());
+            GSUtil::BinaryOutput(header, uint32_t(m_warehouseBodyList.size()));
+            for (auto &&iter : m_warehouseBodyList) writeName(iter->name());
+            GSUtil::BinaryOutput(header, uint32_t(13));
         }
+        if (m_asyncDumpWriter) m_asyncDumpWriter->PushText(m_warehouseHeaderSink, header.str());
+        else m_OutputWarehouseFile << header.str();
+        m_warehouseValues.reserve(1 + m_warehouseDriverList.size() + 13 * m_warehouseBodyList.size());
+    }
+
+    m_OutputWarehouseLastTime = m_SimulationTime;
+    // collect the values and leave the formatting to WriteWarehouseRecord
+    m_warehouseValues.clear();
+    // simulation time
+    m_warehouseValues.push_back(m_SimulationTime);
+    // driver activations
+    for (auto &&iter : m_warehouseDriverList) m_warehouseValues.push_back(iter->value());
+    // output the root body (m_global->DistanceTravelledBodyIDName())
+    Body *rootBody = m_warehouseBodyList[0];
+    pgd::Vector3 pos, vel, avel;
+    pgd::Quaternion quat;
+    rootBody->GetRelativePosition(nullptr, &pos);
+    rootBody->GetRelativeQuaternion(nullptr, &quat);
+    rootBody->GetRelativeLinearVelocity(nullptr, &vel);
+    rootBody->GetRelativeAngularVelocity(nullptr, &avel);
+    double angle = QGetAngle(quat);
+    pgd::Vector3 axis = QGetAxis(quat);
+    m_warehouseValues.insert(m_warehouseValues.end(), {pos.x, pos.y, pos.z, angle, axis.x, axis.y, axis.z, vel.x, vel.y, vel.z, avel.x, avel.y, avel.z});
+    // and now the rest of the bodies
+    for (size_t i = 1; i < m_warehouseBodyList.size(); i++)
+    {
+        Body *body = m_warehouseBodyList[i];
+        body->GetRelativePosition(rootBody, &pos);
+        body->GetRelativeQuaternion(rootBody, &quat);
+        body->GetRelativeLinearVelocity(rootBody, &vel);
+        body->GetRelativeAngularVelocity(rootBody, &avel);
+        angle = QGetAngle(quat);
+        axis = QGetAxis(quat);
+        m_warehouseValues.insert(m_warehouseValues.end(), {pos.x, pos.y, pos.z, angle, axis.x, axis.y, axis.z, vel.x, vel.y, vel.z, avel.x, avel.y, avel.z});
+    }
+    if (m_asyncDumpWriter) m_asyncDumpWriter->PushValues(m_warehouseValueSink, m_warehouseValues.data(), m_warehouseValues.size());
+    else WriteWarehouseRecord(m_warehouseValues.data(), m_warehouseValues.size());
+}
 
-        m_OutputWarehouseLastTime = m_SimulationTime;
-        // simulation time
-        GSUtil::BinaryOutput(m_OutputWarehouseFile, m_SimulationTime);
-        // driver activations
-        for (auto &&iter : m_DriverList) GSUtil::BinaryOutput(m_OutputWarehouseFile, iter.second->value());
-        // output the root body (m_global->DistanceTravelledBodyIDName())
-        Body *rootBody = m_BodyList[m_global->DistanceTravelledBodyIDName()].get();
-        pgd::Vector3 pos, vel, avel;
-        pgd::Quaternion quat;
-        rootBody->GetRelativePosition(nullptr, &pos);
-        rootBody->GetRelativeQuaternion(nullptr, &quat);
-        rootBody->GetRelativeLinearVelocity(nullptr, &vel);
-        rootBody->GetRelativeAngularVelocity(nullptr, &avel);
-        double angle = QGetAngle(quat);
-        pgd::Vector3 axis = QGetAxis(quat);
-        GSUtil::BinaryOutput(m_OutputWarehouseFile, pos.x); GSUtil::BinaryOutput(m_OutputWarehouseFile, pos.y); GSUtil::BinaryOutput(m_OutputWarehouseFile, pos.z);
-        GSUtil::BinaryOutput(m_OutputWarehouseFile, angle); GSUtil::BinaryOutput(m_OutputWarehouseFile, axis.x); GSUtil::BinaryOutput(m_OutputWarehouseFile, axis.y); GSUtil::BinaryOutput(m_OutputWarehouseFile, axis.z);
-        GSUtil::BinaryOutput(m_OutputWarehouseFile, vel.x); GSUtil::BinaryOutput(m_OutputWarehouseFile, vel.y); GSUtil::BinaryOutput(m_OutputWarehouseFile, vel.z);
-        GSUtil::BinaryOutput(m_OutputWarehouseFile, avel.x); GSUtil::BinaryOutput(m_OutputWarehouseFile, avel.y); GSUtil::BinaryOutput(m_OutputWarehouseFile, avel.z);
-        // and now the rest of the bodies
-        for (auto &&iter : m_BodyList)
+// this can be called from the async writer thread so it must only use the warehouse file
+void Simulation::WriteWarehouseRecord(const double *values, size_t numValues)
+{
+    if (m_OutputWarehouseAsText)
+    {
+        for (size_t i = 0; i < numValues; i++)
         {
-            if (iter.second->name() != m_global->DistanceTravelledBodyIDName())
-            {
-                iter.second->GetRelativePosition(rootBody, &pos);
-                iter.second->GetRelativeQuaternion(rootBody, &quat);
-                iter.second->GetRelativeLinearVelocity(rootBody, &vel);
-                iter.second->GetRelativeAngularVelocity(rootBody, &avel);
-                angle = QGetAngle(quat);
-                axis = QGetAxis(quat);
-                GSUtil::BinaryOutput(m_OutputWarehouseFile, pos.x); GSUtil::BinaryOutput(m_OutputWarehouseFile, pos.y); GSUtil::BinaryOutput(m_OutputWarehouseFile, pos.z);
-                GSUtil::BinaryOutput(m_OutputWarehouseFile, angle); GSUtil::BinaryOutput(m_OutputWarehouseFile, axis.x); GSUtil::BinaryOutput(m_OutputWarehouseFile, axis.y); GSUtil::BinaryOutput(m_OutputWarehouseFile, axis.z);
-                GSUtil::BinaryOutput(m_OutputWarehouseFile, vel.x); GSUtil::BinaryOutput(m_OutputWarehouseFile, vel.y); GSUtil::BinaryOutput(m_OutputWarehouseFile, vel.z);
-                GSUtil::BinaryOutput(m_OutputWarehouseFile, avel.x); GSUtil::BinaryOutput(m_OutputWarehouseFile, avel.y); GSUtil::BinaryOutput(m_OutputWarehouseFile, avel.z);
-            }
+            if (i) m_OutputWarehouseFile << "\t";
+            m_OutputWarehouseFile << values[i];
         }
+        m_OutputWarehouseFile << "\n";
+    }
+    else
+    {
+        // the record layout is fixed so it can go out in a single write
+        m_OutputWarehouseFile.write(reinterpret_cast<const char *>(values), std::streamsize(numValues * sizeof(double)));
     }
 }
 
-// save the current model state to XML
-std::string Simulation::SaveToXML()
+// capture the current model state as a list of XML elements in m_parseXML
+// and optionally the object that each element came from
+void Simulation::CaptureModelState(std::vector<NamedObject *> *objectList)
 {
     m_parseXML.elementList()->clear();
+    if (objectList) objectList->clear();
+    auto capture = [this, objectList](NamedObject *object, const std::string &tag)
+    {
+        object->saveToAttributes();
+        m_parseXML.AddElement(tag, object->attributeMap());
+        if (objectList) objectList->push_back(object);
+    };
+
+    capture(m_global.get(), "GLOBAL"s);
+    for (auto &&it : m_BodyList) capture(it.second.get(), "BODY"s);
+    for (auto &&it : m_MarkerList) capture(it.second.get(), "MARKER"s);
+    for (auto &&it : m_JointList) capture(it.second.get(), "JOINT"s);
+    for (auto &&it : m_GeomList) capture(it.second.get(), "GEOM"s);
+    for (auto &&it : m_StrapList) capture(it.second.get(), "STRAP"s);
+    for (auto &&it : m_MuscleList) capture(it.second.get(), "MUSCLE"s);
+    for (auto &&it : m_FluidSacList) capture(it.second.get(), "FLUIDSAC"s);
+    for (auto &&it : m_ReporterList) capture(it.second.get(), "REPORTER"s);
+    for (auto &&it : m_ControllerList) capture(it.second.get(), "CONTROLLER"s);
+    for (auto &&it : m_WarehouseList) capture(it.second.get(), "WAREHOUSE"s);
+    for (auto &&it : m_DriverList) capture(it.second.get(), "DRIVER"s);
+    for (auto &&it : m_DataTargetList) capture(it.second.get(), "DATATARGET"s);
+    // the elements are copies so the regenerated attributes are not needed
+    if (m_leanMode) ReleaseConstructionData();
+}
 
-    m_global->saveToAttributes(); m_parseXML.AddElement("GLOBAL"s, m_global->attributeMap());
-    for (auto &&it : m_BodyList) { it.second->saveToAttributes(); m_parseXML.AddElement("BODY"s, it.second->attributeMap()); }
-    for (auto &&it : m_MarkerList) { it.second->saveToAttributes(); m_parseXML.AddElement("MARKER"s, it.second->attributeMap()); }
-    for (auto &&it : m_JointList) { it.second->saveToAttributes(); m_parseXML.AddElement("JOINT"s, it.second->attributeMap()); }
-    for (auto &&it : m_GeomList) { it.second->saveToAttributes(); m_parseXML.AddElement("GEOM"s, it.second->attributeMap()); }
-    for (auto &&it : m_StrapList) { it.second->saveToAttributes(); m_parseXML.AddElement("STRAP"s, it.second->attributeMap()); }
-    for (auto &&it : m_MuscleList) { it.second->saveToAttributes(); m_parseXML.AddElement("MUSCLE"s, it.second->attributeMap()); }
-    for (auto &&it : m_FluidSacList) { it.second->saveToAttributes(); m_parseXML.AddElement("FLUIDSAC"s, it.second->attributeMap()); }
-    for (auto &&it : m_ReporterList) { it.second->saveToAttributes(); m_parseXML.AddElement("REPORTER"s, it.second->attributeMap()); }
-    for (auto &&it : m_ControllerList) { it.second->saveToAttributes(); m_parseXML.AddElement("CONTROLLER"s, it.second->attributeMap()); }
-    for (auto &&it : m_WarehouseList) { it.second->saveToAttributes(); m_parseXML.AddElement("WAREHOUSE"s, it.second->attributeMap()); }
-    for (auto &&it : m_DriverList) { it.second->saveToAttributes(); m_parseXML.AddElement("DRIVER"s, it.second->attributeMap()); }
-    for (auto &&it : m_DataTargetList) { it.second->saveToAttributes(); m_parseXML.AddElement("DATATARGET"s, it.second->attributeMap()); }
+void Simulation::ReleaseConstructionData()
+{
+    m_global->releaseConstructionData();
+    for (auto &&it : m_BodyList) it.second->releaseConstructionData();
+    for (auto &&it : m_MarkerList) it.second->releaseConstructionData();
+    for (auto &&it : m_JointList) it.second->releaseConstructionData();
+    for (auto &&it : m_GeomList) it.second->releaseConstructionData();
+    for (auto &&it : m_StrapList) it.second->releaseConstructionData();
+    for (auto &&it : m_MuscleList) it.second->releaseConstructionData();
+    for (auto &&it : m_FluidSacList) it.second->releaseConstructionData();
+    for (auto &&it : m_ReporterList) it.second->releaseConstructionData();
+    for (auto &&it : m_ControllerList) it.second->releaseConstructionData();
+    for (auto &&it : m_WarehouseList) it.second->releaseConstructionData();
+    for (auto &&it : m_DriverList) it.second->releaseConstructionData();
+    for (auto &&it : m_DataTargetList) it.second->releaseConstructionData();
+}
 
+std::string Simulation::ModelStateComment()
+{
     std::stringstream comment;
     comment << "Simulation Time: " << m_SimulationTime <<
                " Steps: " << m_StepCount <<
                " Score: " << CalculateInstantaneousFitness() <<
                " Mechanical Energy: " << m_MechanicalEnergy <<
                " Metabolic Energy: " << m_MetabolicEnergy;
-    return m_parseXML.SaveModel("GAITSYM2019"s, comment.str());
+    return comment.str();
+}
+
+// save the current model state to XML
+std::string Simulation::SaveToXML()
+{
+    CaptureModelState();
+    std::string xmlString = m_parseXML.SaveModel("GAITSYM2019"s, ModelStateComment());
+    if (m_leanMode) m_parseXML.Clear();
+    return xmlString;
 }
 
 // output the simulation state in an XML format that can be re-read
@@ -1387,6 +1886,39 @@ void Simulation::OutputProgramState()
     outputFile.WriteFile(m_OutputModelStateFile);
 }
 
+// output the simulation state during a run
+// only the values that change are copied here and the attributes, XML and file are done by a background thread
+// the first state in a run also captures all the attributes for the background thread to use as a template
+void Simulation::QueueProgramState(const std::string &filename)
+{
+    if (!m_modelStateWriter)
+    {
+        m_modelStateWriter = std::make_unique<ModelStateWriter>();
+        std::vector<NamedObject *> objectList;
+        CaptureModelState(&objectList);
+        m_modelStateWriter->SetTemplate(m_parseXML.elementList(), objectList);
+    }
+    std::unique_ptr<ModelStateWriter::ModelState> modelState = std::make_unique<ModelStateWriter::ModelState>();
+    modelState->filename = filename;
+    modelState->comment = ModelStateComment();
+    for (auto &&object : m_modelStateWriter->objectList()) object->appendStateValues(&modelState->stateValues);
+    m_modelStateWriter->Push(std::move(modelState));
+}
+
+// the periodic model states are numbered by step e.g. ModelState_1000.xml
+std::string Simulation::ModelStateCheckpointFilename()
+{
+    std::string root, ext;
+    pystring::os::path::splitext(root, ext, m_OutputModelStateFile);
+    return root + "_"s + std::to_string(m_StepCount) + ext;
+}
+
+void Simulation::SetOutputModelStateEvery(double outputModelStateEvery)
+{
+    m_OutputModelStateEvery = outputModelStateEvery;
+    m_OutputModelStateNextTime = outputModelStateEvery > 0 ? m_SimulationTime : 0;
+}
+
 void Simulation::SetOutputModelStateFile(const std::string &filename)
 {
     m_OutputModelStateFile = filename;
@@ -1408,6 +1940,11 @@ void Simulation::SetOutputWarehouseFile(const std::string &filename)
     }
 }
 
+void Simulation::SetOutputWarehouseAsText(bool outputWarehouseAsText)
+{
+    m_OutputWarehouseAsText = outputWarehouseAsText;
+}
+
 void Simulation::SetWarehouseFailDistanceAbort(double warehouseFailDistanceAbort)
 {
     m_global->setWarehouseFailDistanceAbort(warehouseFailDistanceAbort);
@@ -1441,9 +1978,9 @@ void Simulation::AddWarehouse(const std::string &filename)
 
 bool Simulation::ShouldQuit()
 {
-    if (m_global->TimeLimit() > 0 && m_SimulationTime > m_global->TimeLimit()) return true;
-    if (m_global->MechanicalEnergyLimit() > 0 && m_MechanicalEnergy > m_global->MechanicalEnergyLimit()) return true;
-    if (m_global->MetabolicEnergyLimit() > 0 && m_MetabolicEnergy > m_global->MetabolicEnergyLimit()) return true;
+    if (m_global->TimeLimit() > 0 && m_SimulationTime > m_global->TimeLimit()) { m_abortReason = "TimeLimit"s; return true; }
+    if (m_global->MechanicalEnergyLimit() > 0 && m_MechanicalEnergy > m_global->MechanicalEnergyLimit()) { m_abortReason = "MechanicalEnergyLimit"s; return true; }
+    if (m_global->MetabolicEnergyLimit() > 0 && m_MetabolicEnergy > m_global->MetabolicEnergyLimit()) { m_abortReason = "MetabolicEnergyLimit"s; return true; }
     return false;
 }
 
@@ -1541,21 +2078,31 @@ void Simulation::NearCallback(void *data, dGeomID o1, dGeomID o2)
             {
                 c = dJointCreateContact(s->m_WorldID, s->m_ContactGroup, &contact[i]);
                 dJointAttach(c, b1, b2);
-                std::unique_ptr<Contact> myContact = std::make_unique<Contact>();
-                myContact->setSimulation(s);
+                if (s->m_NumContacts >= s->m_ContactList.size())
+                {
+                    std::unique_ptr<Contact> newContact = std::make_unique<Contact>();
+                    newContact->setSimulation(s);
+                    s->m_ContactList.push_back(std::move(newContact));
+                }
+                Contact *myContact = s->m_ContactList[s->m_NumContacts].get();
+                s->m_NumContacts++;
+                *myContact->GetJointFeedback() = {};
                 dJointSetFeedback(c, myContact->GetJointFeedback());
                 myContact->SetJointID(c);
+                myContact->SetGeoms(g1, g2);
                 std::copy_n(contact[i].geom.pos, dV3E__MAX, myContact->GetContactPosition());
 //                // only add the contact information once
 //                // and add it to the non-environment geom
 //                if (g1->GetGeomLocation() == Geom::environment)
-//                    g2->AddContact(myContact.get());
+//                    g2->AddContact(myContact);
 //                else
-//                    g1->AddContact(myContact.get());
-                // add the contact information to both geoms
-                g1->AddContact(myContact.get());
-                g2->AddContact(myContact.get());
-                s->m_ContactList.push_back(std::move(myContact));
+//                    g1->AddContact(myContact);
+                // add the contact information to both geoms but only if anything is going to use it
+                if (s->m_materialiseGeomContacts)
+                {
+                    g1->AddContact(myContact);
+                    g2->AddContact(myContact);
+                }
             }
             else
             {
@@ -1671,6 +2218,36 @@ Global *Simulation::GetGlobal()
 
 void Simulation::DumpObjects()
 {
+    if (m_dumpFilename.size() || m_asyncDumpBufferSize || m_dumpTriggersEnabled)
+    {
+        if (!m_dumpListsValid) CreateDumpLists();
+        if (m_dumpFileWriter || m_asyncDumpWriter || m_dumpTriggersEnabled)
+        {
+            // outside a trigger window the numeric records go into the history in case there is a trigger soon
+            bool dumpActive = DumpTriggerActive();
+            size_t numFileObjects = m_dumpFileObjectList.size();
+            for (size_t i = 0; i < numFileObjects + m_dumpValueObjectList.size(); i++)
+            {
+                NamedObject *object = i < numFileObjects ? m_dumpFileObjectList[i].object : m_dumpValueObjectList[i - numFileObjects].object;
+                if (!DumpDue(object)) continue;
+                object->dumpSelectedValues(&m_dumpValues);
+                if (dumpActive) WriteDumpRecord(i, m_dumpValues.data(), m_dumpValues.size());
+                else m_dumpHistory->AddRecord(i, m_SimulationTime, m_dumpValues.data(), m_dumpValues.size());
+            }
+            size_t numValueObjects = numFileObjects + m_dumpValueObjectList.size();
+            for (size_t i = 0; i < m_dumpTextObjectList.size(); i++)
+            {
+                NamedObject *object = m_dumpTextObjectList[i].object;
+                if (!object->dump() || !DumpDue(object)) continue;
+                // the first text record carries the column headings so it is always written
+                bool firstDump = object->firstDump();
+                if (dumpActive || firstDump) WriteDumpText(i, object->dumpToString(), firstDump);
+                else m_dumpHistory->AddText(numValueObjects + i, m_SimulationTime, object->dumpToString());
+            }
+            return;
+        }
+    }
+
     for (auto &&it : m_BodyList) DumpObject(it.second.get());
     for (auto &&it : m_MarkerList) DumpObject(it.second.get());
     for (auto &&it : m_JointList) DumpObject(it.second.get());
@@ -1688,37 +2265,318 @@ void Simulation::DumpObjects()
     }
 }
 
-void Simulation::DumpObject(NamedObject *namedObject)
+// this decides where each dumped object is written and sets up the binary dump file and the async writer
+// objects that support numeric dumping go into the binary dump file if there is one
+// and the async writer formats their .tab files itself so only the values cross the ring buffer
+void Simulation::CreateDumpLists()
 {
-    if (namedObject->dump())
+    m_dumpListsValid = true;
+    CreateDumpTriggerLists();
+    m_dumpFileObjectList.clear();
+    m_dumpValueObjectList.clear();
+    m_dumpTextObjectList.clear();
+    std::vector<NamedObject *> dumpList;
+    for (auto &&it : m_BodyList) dumpList.push_back(it.second.get());
+    for (auto &&it : m_MarkerList) dumpList.push_back(it.second.get());
+    for (auto &&it : m_JointList) dumpList.push_back(it.second.get());
+    for (auto &&it : m_GeomList) dumpList.push_back(it.second.get());
+    for (auto &&it : m_FluidSacList) dumpList.push_back(it.second.get());
+    for (auto &&it : m_DriverList) dumpList.push_back(it.second.get());
+    for (auto &&it : m_DataTargetList) dumpList.push_back(it.second.get());
+    for (auto &&it : m_ReporterList) dumpList.push_back(it.second.get());
+    for (auto &&it : m_ControllerList) dumpList.push_back(it.second.get());
+    for (auto &&it : m_WarehouseList) dumpList.push_back(it.second.get());
+    for (auto &&it : m_MuscleList)
+    {
+        dumpList.push_back(it.second.get());
+        dumpList.push_back(it.second->GetStrap());
+    }
+
+    if (m_dumpFilename.size())
     {
-        if (namedObject->firstDump())
+        std::unique_ptr<DumpFileWriter> dumpFileWriter = std::make_unique<DumpFileWriter>();
+        for (auto &&it : dumpList)
         {
-            std::ofstream output;
-            output.exceptions(std::ios::failbit|std::ios::badbit);
-            try
+            if (!it->dump()) continue;
+            std::vector<std::string> names = it->dumpSelectedNames();
+            if (names.size() == 0) continue;
+            // the quantisation is only used for compressed files and Time is always kept lossless
+            std::vector<double> quantisation(names.size());
+            for (size_t i = 0; i < names.size(); i++)
             {
+                double quantum = it->dumpQuantisation(names[i]);
+                if (quantum < 0) quantum = (names[i] == "Time"s) ? 0 : m_global->DumpQuantisation();
+                quantisation[i] = quantum;
+            }
+            m_dumpFileObjectList.push_back({it, dumpFileWriter->AddObject(it->name(), names, quantisation)});
+        }
+        if (dumpFileWriter->Open(m_dumpFilename, m_dumpFileValueFormat))
+        {
+            std::cerr << dumpFileWriter->lastError() << "\n";
+            m_dumpFilename.clear();
+            m_dumpFileObjectList.clear();
+        }
+        else
+        {
+            m_dumpFileWriter = std::move(dumpFileWriter);
+        }
+    }
+
+    if (m_asyncDumpBufferSize == 0)
+    {
+        // with dump triggers and no dump file everything uses the text lists so that it can go into the history
+        bool allText = m_dumpTriggersEnabled && !m_dumpFileWriter;
+        for (auto &&it : dumpList)
+            if (it->dump() && (allText || it->dumpNames().size() == 0)) m_dumpTextObjectList.push_back({it, 0});
+        return;
+    }
+
+    // with the async writer the sinks do all the formatting and writing on the writer thread
+    std::unique_ptr<AsyncDumpWriter> asyncDumpWriter = std::make_unique<AsyncDumpWriter>();
+    for (auto &&it : m_dumpFileObjectList)
+    {
+        DumpFileWriter *dumpFileWriter = m_dumpFileWriter.get();
+        size_t objectIndex = it.sink;
+        it.sink = asyncDumpWriter->AddValueSink([dumpFileWriter, objectIndex](const double *values, size_t numValues)
+        {
+            dumpFileWriter->AddRecord(objectIndex, values, numValues);
+        });
+    }
+    for (auto &&it : dumpList)
+    {
+        if (!it->dump() || (m_dumpFileWriter && it->dumpNames().size())) continue;
+        std::ofstream output;
+        output.exceptions(std::ios::failbit|std::ios::badbit);
+        try
+        {
 #if defined _WIN32 && defined _MSC_VER // required because windows and visual studio require wstring for full filename support
-                output.open(DataFile::ConvertUTF8ToWide(namedObject->name() + m_dumpExtension));
+            output.open(DataFile::ConvertUTF8ToWide(it->name() + m_dumpExtension));
 #else
-                output.open(namedObject->name() + m_dumpExtension);
+            output.open(it->name() + m_dumpExtension);
 #endif
-            }
-            catch (...)
+        }
+        catch (...)
+        {
+            std::cerr << "Error opening dump file\n";
+            continue;
+        }
+        std::ofstream *file = &(m_dumpFileStreams[it->name()] = std::move(output));
+        std::vector<std::string> names = it->dumpSelectedNames();
+        if (names.size())
+        {
+            // this matches NamedObject::dumpValuesToString
+            std::string header;
+            for (size_t i = 0; i < names.size(); i++) header += (i ? "\t"s : ""s) + names[i];
+            header += "\n"s;
+            std::shared_ptr<std::stringstream> ss = std::make_shared<std::stringstream>();
+            ss->precision(17);
+            ss->setf(std::ios::scientific);
+            m_dumpValueObjectList.push_back({it, asyncDumpWriter->AddValueSink([file, header, ss, firstDump = true](const double *values, size_t numValues) mutable
             {
-                std::cerr << "Error opening dump file\n";
-            }
-            m_dumpFileStreams[namedObject->name()] = std::move(output);
+                ss->str(""s);
+                if (firstDump) { *ss << header; firstDump = false; }
+                for (size_t i = 0; i < numValues; i++) *ss << (i ? "\t" : "") << values[i];
+                *ss << "\n";
+                try { *file << ss->str(); }
+                catch (...) { std::cerr << "Error writing dump file\n"; }
+            })});
+        }
+        else
+        {
+            m_dumpTextObjectList.push_back({it, asyncDumpWriter->AddTextSink([file](const char *text, size_t length)
+            {
+                try { file->write(text, std::streamsize(length)); }
+                catch (...) { std::cerr << "Error writing dump file\n"; }
+            })});
+        }
+    }
+    if (m_OutputWarehouseFlag)
+    {
+        m_warehouseHeaderSink = asyncDumpWriter->AddTextSink([this](const char *text, size_t length) { m_OutputWarehouseFile.write(text, std::streamsize(length)); });
+        m_warehouseValueSink = asyncDumpWriter->AddValueSink([this](const double *values, size_t numValues) { WriteWarehouseRecord(values, numValues); });
+    }
+    if (m_dumpFileObjectList.size() + m_dumpValueObjectList.size() + m_dumpTextObjectList.size() == 0 && !m_OutputWarehouseFlag) return;
+    asyncDumpWriter->Start(m_asyncDumpBufferSize * 1024 * 1024 / sizeof(double));
+    m_asyncDumpWriter = std::move(asyncDumpWriter);
+}
+
+// the dump triggers are a space separated list of events that turn on dumping
+// "Touchdown" and "LiftOff" are contact changes and can be restricted to a single geom with "Touchdown:GeomID"
+// "ODEWarning" is any ODE warning, "Abort" is any abort and an abort reason (e.g. "FixedJointStressLimit") is just that abort
+void Simulation::CreateDumpTriggerLists()
+{
+    m_dumpTriggerEventList.clear();
+    m_dumpTriggerGeomList.clear();
+    m_dumpHistory.reset();
+    m_dumpTriggerEndTime = -DBL_MAX;
+    std::vector<std::string> tokens;
+    pystring::split(m_global->DumpTriggers(), tokens);
+    m_dumpTriggersEnabled = tokens.size() > 0;
+    if (!m_dumpTriggersEnabled) return;
+
+    for (auto &&token : tokens)
+    {
+        std::vector<std::string> parts;
+        pystring::partition(token, ":"s, parts);
+        if (parts[0] != "Touchdown"s && parts[0] != "LiftOff"s)
+        {
+            m_dumpTriggerEventList.push_back(token);
+            continue;
+        }
+        for (auto &&it : m_GeomList)
+        {
+            if (parts[2].size() && parts[2] != it.first) continue;
+            auto geomIt = std::find_if(m_dumpTriggerGeomList.begin(), m_dumpTriggerGeomList.end(), [&it](const DumpTriggerGeom &g) { return g.geom == it.second.get(); });
+            if (geomIt == m_dumpTriggerGeomList.end()) geomIt = m_dumpTriggerGeomList.insert(m_dumpTriggerGeomList.end(), DumpTriggerGeom{it.second.get(), false, false, 0});
+            if (parts[0] == "Touchdown"s) geomIt->touchdown = true;
+            else geomIt->liftOff = true;
+        }
+        if (parts[2].size() && m_GeomList.find(parts[2]) == m_GeomList.end()) std::cerr << "Warning: DumpTriggers \"" << token << "\" does not match a GEOM\n";
+    }
+
+    // the history only needs to cover the pre trigger time but an extra record avoids rounding problems
+    m_dumpHistory = std::make_unique<DumpHistory>();
+    m_dumpHistory->Initialise(size_t(std::max(0.0, m_global->DumpPreTriggerTime()) / m_global->StepSize()) + 2);
+}
+
+void Simulation::CheckContactDumpTriggers()
+{
+    for (auto &&it : m_dumpTriggerGeomList)
+    {
+        size_t numContacts = GetGeomContactAggregate(it.geom).numContacts;
+        if ((it.touchdown && it.lastNumContacts == 0 && numContacts > 0) || (it.liftOff && it.lastNumContacts > 0 && numContacts == 0)) TriggerDump();
+        it.lastNumContacts = numContacts;
+    }
+}
+
+void Simulation::DumpTriggerEvent(const std::string &event, bool abort)
+{
+    for (auto &&it : m_dumpTriggerEventList)
+    {
+        if (it == event || (abort && it == "Abort"s))
+        {
+            TriggerDump();
+            return;
         }
-        auto fileIt = m_dumpFileStreams.find(namedObject->name());
+    }
+}
+
+// starts or extends the dump window and writes out the history from before the trigger
+void Simulation::TriggerDump()
+{
+    bool dumpActive = DumpTriggerActive();
+    m_dumpTriggerEndTime = std::max(m_dumpTriggerEndTime, m_SimulationTime + m_global->DumpPostTriggerTime());
+    if (dumpActive || !m_dumpHistory) return;
+    double fromTime = m_SimulationTime - m_global->DumpPreTriggerTime() - m_global->StepSize() * 0.5;
+    size_t numValueObjects = m_dumpFileObjectList.size() + m_dumpValueObjectList.size();
+    m_dumpHistory->Flush(fromTime, [this](size_t target, const double *values, size_t numValues) { WriteDumpRecord(target, values, numValues); },
+                         [this, numValueObjects](size_t target, const std::string &text) { WriteDumpText(target - numValueObjects, text, false); });
+}
+
+bool Simulation::DumpTriggerActive() const
+{
+    return !m_dumpTriggersEnabled || m_SimulationTime <= m_dumpTriggerEndTime;
+}
+
+// the target index covers m_dumpFileObjectList followed by m_dumpValueObjectList
+void Simulation::WriteDumpRecord(size_t target, const double *values, size_t numValues)
+{
+    if (target < m_dumpFileObjectList.size())
+    {
+        if (m_asyncDumpWriter) m_asyncDumpWriter->PushValues(m_dumpFileObjectList[target].sink, values, numValues);
+        else m_dumpFileWriter->AddRecord(m_dumpFileObjectList[target].sink, values, numValues);
+        return;
+    }
+    m_asyncDumpWriter->PushValues(m_dumpValueObjectList[target - m_dumpFileObjectList.size()].sink, values, numValues);
+}
+
+void Simulation::WriteDumpText(size_t target, const std::string &text, bool firstDump)
+{
+    if (m_asyncDumpWriter) m_asyncDumpWriter->PushText(m_dumpTextObjectList[target].sink, text);
+    else WriteDumpStream(m_dumpTextObjectList[target].object, text, firstDump);
+}
+
+void Simulation::SetDumpFile(const std::string &filename, DumpValueFormat valueFormat)
+{
+    m_dumpFilename = filename;
+    m_dumpFileValueFormat = valueFormat;
+}
+
+void Simulation::SetAsyncDumpBufferSize(size_t bufferSizeMB)
+{
+    m_asyncDumpBufferSize = bufferSizeMB;
+}
+
+TrajectoryRecorder *Simulation::GetTrajectoryRecorder()
+{
+    if (!m_trajectoryRecorder) m_trajectoryRecorder = std::make_unique<TrajectoryRecorder>();
+    return m_trajectoryRecorder.get();
+}
+
+void Simulation::SetLeanMode(bool leanMode)
+{
+    m_leanMode = leanMode;
+}
+
+// this applies the dump interval and time window options for an object falling back to the Global values
+bool Simulation::DumpDue(const NamedObject *namedObject) const
+{
+    int interval = namedObject->dumpInterval() > 0 ? namedObject->dumpInterval() : m_global->DumpInterval();
+    double timeInterval = namedObject->dumpTimeInterval() > 0 ? namedObject->dumpTimeInterval() : m_global->DumpTimeInterval();
+    double startTime = namedObject->dumpStartTime() >= 0 ? namedObject->dumpStartTime() : m_global->DumpStartTime();
+    double endTime = namedObject->dumpEndTime() >= 0 ? namedObject->dumpEndTime() : m_global->DumpEndTime();
+    if (m_SimulationTime < startTime) return false;
+    if (endTime >= 0 && m_SimulationTime > endTime) return false;
+    if (timeInterval > 0)
+    {
+        // dump on the first step at or after each multiple of the time interval from the start time
+        // the small offset stops rounding errors in the time producing an extra or missing record
+        double previousTime = m_SimulationTime - m_global->StepSize();
+        if (previousTime < startTime) return true;
+        return std::floor((m_SimulationTime - startTime) / timeInterval + 1e-9) != std::floor((previousTime - startTime) / timeInterval + 1e-9);
+    }
+    if (interval > 1) return m_StepCount % interval == 0;
+    return true;
+}
+
+void Simulation::DumpObject(NamedObject *namedObject)
+{
+    if (namedObject->dump() && DumpDue(namedObject))
+    {
+        bool firstDump = namedObject->firstDump();
+        WriteDumpStream(namedObject, namedObject->dumpToString(), firstDump);
+    }
+}
+
+// the dump stream is opened by the first record which is the one that has the column headings
+void Simulation::WriteDumpStream(NamedObject *namedObject, const std::string &text, bool firstDump)
+{
+    if (firstDump)
+    {
+        std::ofstream output;
+        output.exceptions(std::ios::failbit|std::ios::badbit);
         try
         {
-            if (fileIt != m_dumpFileStreams.end()) fileIt->second << namedObject->dumpToString();
+#if defined _WIN32 && defined _MSC_VER // required because windows and visual studio require wstring for full filename support
+            output.open(DataFile::ConvertUTF8ToWide(namedObject->name() + m_dumpExtension));
+#else
+            output.open(namedObject->name() + m_dumpExtension);
+#endif
         }
         catch (...)
         {
-            std::cerr << "Error writing dump file\n";
+            std::cerr << "Error opening dump file\n";
         }
+        m_dumpFileStreams[namedObject->name()] = std::move(output);
+    }
+    auto fileIt = m_dumpFileStreams.find(namedObject->name());
+    try
+    {
+        if (fileIt != m_dumpFileStreams.end()) fileIt->second << text;
+    }
+    catch (...)
+    {
+        std::cerr << "Error writing dump file\n";
     }
 }
 
@@ -1834,14 +2692,31 @@ NamedObject *Simulation::GetNamedObject(const std::string &name) const
 
 bool Simulation::DeleteNamedObject(const std::string &name)
 {
-    auto BodyListIt = m_BodyList.find(name); if (BodyListIt != m_BodyList.end()) { m_BodyList.erase(BodyListIt); return true; }
+    auto BodyListIt = m_BodyList.find(name);
+    if (BodyListIt != m_BodyList.end())
+    {
+        m_contactAggregateListValid = false;
+#ifdef EXPERIMENTAL
+        m_dragListsValid = false;
+#endif
+        m_BodyList.erase(BodyListIt);
+        return true;
+    }
     auto JointListIt = m_JointList.find(name); if (JointListIt != m_JointList.end()) { m_JointList.erase(JointListIt); return true; }
-    auto GeomListIt = m_GeomList.find(name); if (GeomListIt != m_GeomList.end()) { m_GeomList.erase(GeomListIt); return true; }
+    auto GeomListIt = m_GeomList.find(name); if (GeomListIt != m_GeomList.end()) { m_contactAggregateListValid = false; m_GeomList.erase(GeomListIt); return true; }
     auto MuscleListIt = m_MuscleList.find(name); if (MuscleListIt != m_MuscleList.end()) { m_MuscleList.erase(MuscleListIt); return true; }
     auto StrapListIt = m_StrapList.find(name); if (StrapListIt != m_StrapList.end()) { m_StrapList.erase(StrapListIt); return true; }
     auto FluidSacListIt = m_FluidSacList.find(name); if (FluidSacListIt != m_FluidSacList.end()) { m_FluidSacList.erase(FluidSacListIt); return true; }
     auto DriverListIt = m_DriverList.find(name); if (DriverListIt != m_DriverList.end()) { m_DriverList.erase(DriverListIt); return true; }
-    auto DataTargetListIt = m_DataTargetList.find(name); if (DataTargetListIt != m_DataTargetList.end()) { m_DataTargetList.erase(DataTargetListIt); return true; }
+    auto DataTargetListIt = m_DataTargetList.find(name);
+    if (DataTargetListIt != m_DataTargetList.end())
+    {
+        // other DataTargets might be using this one for their time cursor
+        for (auto &&it : m_DataTargetList) it.second->setTimeBase(nullptr);
+        m_dataTargetListValid = false;
+        m_DataTargetList.erase(DataTargetListIt);
+        return true;
+    }
     auto MarkerListIt = m_MarkerList.find(name); if (MarkerListIt != m_MarkerList.end()) { m_MarkerList.erase(MarkerListIt); return true; }
     auto ReporterListIt = m_ReporterList.find(name); if (ReporterListIt != m_ReporterList.end()) { m_ReporterList.erase(ReporterListIt); return true; }
     auto ControllerListIt = m_ControllerList.find(name); if (ControllerListIt != m_ControllerList.end()) { m_ControllerList.erase(ControllerListIt); return true; }
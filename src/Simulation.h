@@ -18,6 +18,7 @@
 #include "ParseXML.h"
 #include "SmartEnum.h"
 #include "ErrorHandler.h"
+#include "DumpFile.h"
 
 #include <map>
 #include <string>
@@ -25,6 +26,7 @@
 #include <vector>
 #include <set>
 #include <unordered_map>
+#include <algorithm>
 
 class Body;
 class Joint;
@@ -35,10 +37,15 @@ class FluidSac;
 class Driver;
 class DataTarget;
 class Contact;
+class AsyncDumpWriter;
+class ModelStateWriter;
+class DumpHistory;
+class TrajectoryRecorder;
 class Marker;
 class Reporter;
 class Controller;
 class FixedJoint;
+class HingeJoint;
 class Warehouse;
 class SimulationWindow;
 class MainWindow;
@@ -69,6 +76,10 @@ public:
     double GetTimeLimit(void) { return m_global->TimeLimit(); }
     double GetMetabolicEnergyLimit(void) { return m_global->MetabolicEnergyLimit(); }
     double GetMechanicalEnergyLimit(void) { return m_global->MechanicalEnergyLimit(); }
+    int GetNumericalErrorCount(void) { return m_numericalErrorCount; }
+    uint64_t GetContactCountTotal(void) { return m_contactCountTotal; } // summed over all the steps
+    size_t GetContactCountMax(void) { return m_contactCountMax; } // most contacts in a single step
+    const std::string &GetAbortReason(void) { return m_abortReason; } // why ShouldQuit or TestForCatastrophy stopped the run
     Body *GetBody(const std::string &name);
     Joint *GetJoint(const std::string &name);
     Geom *GetGeom(const std::string &name);
@@ -91,12 +102,25 @@ public:
     void SetOutputModelStateAtTime(double outputModelStateAtTime) { m_OutputModelStateAtTime = outputModelStateAtTime; }
     void SetOutputModelStateAtCycle(double outputModelStateAtCycle) { m_OutputModelStateAtCycle = outputModelStateAtCycle; }
     void SetOutputModelStateAtWarehouseDistance(double outputModelStateAtWarehouseDistance) { m_OutputModelStateAtWarehouseDistance = outputModelStateAtWarehouseDistance; }
+    // writes a numbered model state every outputModelStateEvery seconds of simulation time
+    void SetOutputModelStateEvery(double outputModelStateEvery);
     void SetOutputModelStateFile(const std::string &filename);
     void SetOutputWarehouseFile(const std::string &filename);
+    // the warehouse output is binary by default which WarehouseUnit can load directly
+    void SetOutputWarehouseAsText(bool outputWarehouseAsText);
     void SetWarehouseFailDistanceAbort(double warehouseFailDistanceAbort);
 
     void AddWarehouse(const std::string &filename);
 
+    // objects that support numeric dumping are written to a single binary file rather than individual .tab files
+    void SetDumpFile(const std::string &filename, DumpValueFormat valueFormat = DumpValueFormat::Double);
+    // the dump and warehouse output is formatted and written by a background thread using a buffer of this many MB (0 means write synchronously)
+    void SetAsyncDumpBufferSize(size_t bufferSizeMB);
+    // in memory recording of selected channels (created on first use)
+    TrajectoryRecorder *GetTrajectoryRecorder();
+    // lean mode frees the construction only data once LoadModel has finished (set before calling LoadModel)
+    void SetLeanMode(bool leanMode);
+
     // get hold of the internal lists (HANDLE WITH CARE)
     std::map<std::string, std::unique_ptr<Body>> *GetBodyList() { return &m_BodyList; }
     std::map<std::string, std::unique_ptr<Joint>> *GetJointList() { return &m_JointList; }
@@ -110,7 +134,14 @@ public:
     std::map<std::string, std::unique_ptr<Reporter>> *GetReporterList() { return &m_ReporterList; }
     std::map<std::string, std::unique_ptr<Controller>> *GetControllerList() { return &m_ControllerList; }
     std::map<std::string, std::unique_ptr<Warehouse>> *GetWarehouseList() { return &m_WarehouseList; }
-    std::vector<std::unique_ptr<Contact>> *GetContactList() { return &m_ContactList; }
+    std::vector<std::unique_ptr<Contact>> *GetContactList() { return &m_ContactList; } // this is a pool so only the first GetNumContacts() are current
+    size_t GetNumContacts() { return m_NumContacts; }
+
+    // the summed contact values from the last step
+    const ContactAggregate &GetGeomContactAggregate(Geom *geom) const;
+    const ContactAggregate &GetBodyContactAggregate(const Body *body) const;
+    // the per geom Contact lists are only filled in when a geom is dumped so this needs calling when the dump flags change
+    void InvalidateContactAggregateList() { m_contactAggregateListValid = false; }
 
     std::vector<std::string> GetNameList() const;
     std::set<std::string> GetNameSet() const;
@@ -122,6 +153,7 @@ public:
 
     // fitness related values
     bool TestForCatastrophy();
+    void SetAbortCheckInterval(int64_t abortCheckInterval) { m_abortCheckInterval = std::max(int64_t(1), abortCheckInterval); }
     double CalculateInstantaneousFitness();
     bool ShouldQuit();
     void SetContactAbort(const std::string &contactID) { m_ContactAbort = true;  m_ContactAbortList.push_back(contactID); }
@@ -130,7 +162,9 @@ public:
 
     std::string SaveToXML();
     void OutputProgramState();
+    void QueueProgramState(const std::string &filename);
     void OutputWarehouse();
+    void WriteWarehouseRecord(const double *values, size_t numValues);
 
     Global *GetGlobal();
     void SetGlobal(std::unique_ptr<Global> global);
@@ -153,6 +187,7 @@ private:
 
     void DumpObjects();
     void DumpObject(NamedObject *namedObject);
+    bool DumpDue(const NamedObject *namedObject) const;
 
     ParseXML m_parseXML;
 
@@ -172,6 +207,10 @@ private:
 
     // this is a list of contacts that are active at the current time step
     std::vector<std::unique_ptr<Contact>> m_ContactList;
+    size_t m_NumContacts = 0;
+    uint64_t m_contactCountTotal = 0;
+    size_t m_contactCountMax = 0;
+    std::string m_abortReason;
 
     // Simulation variables
     dWorldID m_WorldID;
@@ -197,11 +236,14 @@ private:
     // some control values
     bool m_OutputWarehouseFlag = false;
     std::string m_OutputWarehouseFilename;
+    std::vector<char> m_OutputWarehouseStreamBuffer; // declared first so it outlives the stream
     std::ofstream m_OutputWarehouseFile;
     std::string m_OutputModelStateFile;
     bool m_OutputModelStateOccured = false;
     bool m_AbortAfterModelStateOutput = false;
     bool m_OutputWarehouseAsText = false;
+    std::vector<Body *> m_warehouseBodyList; // root body first
+    std::vector<Driver *> m_warehouseDriverList;
     double m_OutputModelStateAtTime = -1;
     double m_OutputModelStateAtCycle = -1;
     int m_SimulationError = false;
@@ -210,12 +252,63 @@ private:
     bool m_OutputKinematicsFirstTimeFlag = false;
     double m_OutputWarehouseLastTime = -DBL_MAX;
     double m_OutputModelStateAtWarehouseDistance = 0;
+    double m_OutputModelStateEvery = 0;
+    double m_OutputModelStateNextTime = 0;
     bool m_WarehouseUsePCA = true;
     bool m_DataTargetAbort = false;
     bool m_ContactAbort = false;
     std::vector<std::string> m_DataTargetAbortList;
     std::vector<std::string> m_ContactAbortList;
 
+    // every driver target has an input slot for each driver
+    void LinkDriverInputs();
+    bool m_driverInputsValid = false;
+
+    // the DataTargets in the order they are evaluated for the fitness
+    void CreateDataTargetList();
+    bool m_dataTargetListValid = false;
+    std::vector<DataTarget *> m_dataTargetEvaluationList;
+
+    // the contact forces are summed once per step into flat lists indexed by geom and by body
+    void CreateContactAggregateList();
+    void AggregateContacts();
+    bool m_contactAggregateListValid = false;
+    bool m_materialiseGeomContacts = false;
+    std::vector<Geom *> m_contactAggregateGeomList;
+    std::vector<size_t> m_contactAggregateGeomBodyIndexList; // SIZE_MAX for environment geoms
+    std::vector<ContactAggregate> m_geomContactAggregateList;
+    std::vector<ContactAggregate> m_bodyContactAggregateList;
+
+#ifdef EXPERIMENTAL
+    // the drag is calculated for all the bodies together and the values are stored as structures of arrays
+    void CreateDragLists();
+    void ComputeDrag();
+    bool m_dragListsValid = false;
+    std::vector<Body *> m_dragCoefficientBodyList;
+    std::vector<double> m_dragCoefficients[6]; // 3 rotational then 3 linear
+    std::vector<double> m_dragCoefficientVelocities[6];
+    std::vector<Body *> m_dragCylinderBodyList;
+    std::vector<size_t> m_dragCylinderAxisList;
+    std::vector<double> m_dragCylinderAxialCoefficients;
+    std::vector<double> m_dragCylinderNormalCoefficients;
+    std::vector<double> m_dragCylinderQuadraturePoints[4];
+    std::vector<double> m_dragCylinderVelocities[6]; // body frame rotated so the cylinder axis is first (angular a b c then linear a b c)
+    std::vector<double> m_dragCylinderForces[6];
+#endif
+
+    // precomputed lists of the things that can actually cause an abort in TestForCatastrophy
+    void CreateAbortLists();
+    bool m_abortListsValid = false;
+    int64_t m_abortCheckInterval = 1; // the non-critical conditions are only checked every m_abortCheckInterval steps
+    std::vector<Body *> m_abortBodyList; // all bodies need the numerical error check
+    std::vector<Body *> m_abortLimitBodyList; // but only some have position and velocity limits
+    std::vector<double> m_abortLimitBodyLowBounds; // 9 values per body (position, linear velocity, angular velocity)
+    std::vector<double> m_abortLimitBodyHighBounds;
+    std::vector<double> m_abortLimitBodyState;
+    std::vector<HingeJoint *> m_abortHingeJointList;
+    std::vector<FixedJoint *> m_abortFixedJointList;
+    std::vector<Reporter *> m_abortReporterList;
+
     // for fitness calculations
     double m_KinematicMatchFitness = 0;
 
@@ -232,6 +325,55 @@ private:
     // values for dump output
     std::string m_dumpExtension = {".tab"};
     std::map<std::string, std::ofstream> m_dumpFileStreams;
+    struct DumpTarget
+    {
+        NamedObject *object;
+        size_t sink; // the DumpFileWriter object index or the AsyncDumpWriter sink index
+    };
+    void CreateDumpLists();
+    void WriteDumpRecord(size_t target, const double *values, size_t numValues);
+    void WriteDumpText(size_t target, const std::string &text, bool firstDump);
+    void WriteDumpStream(NamedObject *namedObject, const std::string &text, bool firstDump);
+    bool m_dumpListsValid = false;
+    std::string m_dumpFilename;
+    DumpValueFormat m_dumpFileValueFormat = DumpValueFormat::Double;
+    std::unique_ptr<DumpFileWriter> m_dumpFileWriter;
+    std::vector<DumpTarget> m_dumpFileObjectList; // objects written to the binary dump file
+    std::vector<DumpTarget> m_dumpValueObjectList; // objects with numeric values written to .tab files by the async writer
+    std::vector<DumpTarget> m_dumpTextObjectList; // objects that can only produce text
+    std::vector<double> m_dumpValues;
+    size_t m_asyncDumpBufferSize = 0;
+    std::unique_ptr<AsyncDumpWriter> m_asyncDumpWriter;
+    std::unique_ptr<TrajectoryRecorder> m_trajectoryRecorder;
+    void CaptureModelState(std::vector<NamedObject *> *objectList = nullptr);
+    std::string ModelStateComment();
+    std::string ModelStateCheckpointFilename();
+    std::unique_ptr<ModelStateWriter> m_modelStateWriter;
+    void ReleaseConstructionData();
+    bool m_leanMode = false;
+
+    // values for event triggered dumping
+    struct DumpTriggerGeom
+    {
+        Geom *geom;
+        bool touchdown;
+        bool liftOff;
+        size_t lastNumContacts;
+    };
+    void CreateDumpTriggerLists();
+    void CheckContactDumpTriggers();
+    void DumpTriggerEvent(const std::string &event, bool abort);
+    void TriggerDump();
+    bool DumpTriggerActive() const;
+    bool TestAbortConditions();
+    bool m_dumpTriggersEnabled = false;
+    std::vector<std::string> m_dumpTriggerEventList;
+    std::vector<DumpTriggerGeom> m_dumpTriggerGeomList;
+    double m_dumpTriggerEndTime = -DBL_MAX;
+    std::unique_ptr<DumpHistory> m_dumpHistory;
+    size_t m_warehouseHeaderSink = 0;
+    size_t m_warehouseValueSink = 0;
+    std::vector<double> m_warehouseValues;
     ErrorHandler m_errorHandler;
 
 };
@@ -63,7 +63,7 @@ void StackedBoxcarDriver::SetHeights(double *Heights)
 
 void StackedBoxcarDriver::Update()
 {
-    assert(simulation()->GetStepCount() == lastStepCount() + 1);
+    assert(simulation()->GetStepCount() == nextUpdateStepCount());
     setLastStepCount(simulation()->GetStepCount());
 
     double output = 0;
@@ -34,7 +34,7 @@ StepDriver::~StepDriver()
 // up the search since it only ever has to check 2 values
 void StepDriver::Update()
 {
-    assert(simulation()->GetStepCount() == lastStepCount() + 1);
+    assert(simulation()->GetStepCount() == nextUpdateStepCount());
     setLastStepCount(simulation()->GetStepCount());
     double time = simulation()->GetTime();
 
@@ -79,6 +79,20 @@ void Strap::appendToAttributes()
     return;
 }
 
+void Strap::appendStateValues(std::vector<double> *values)
+{
+    NamedObject::appendStateValues(values);
+    values->push_back(m_length);
+}
+
+const double *Strap::stateValuesToAttributes(const double *values, std::map<std::string, std::string> *attributeMap) const
+{
+    values = NamedObject::stateValuesToAttributes(values, attributeMap);
+    std::string buf;
+    (*attributeMap)["Length"s] = *GSUtil::ToString(values[0], &buf);
+    return values + 1;
+}
+
 double Strap::Length() const
 {
     return m_length;
@@ -51,6 +51,8 @@ public:
     virtual std::string *createFromAttributes();
     virtual void saveToAttributes();
     virtual void appendToAttributes();
+    virtual void appendStateValues(std::vector<double> *values);
+    virtual const double *stateValuesToAttributes(const double *values, std::map<std::string, std::string> *attributeMap) const;
 
     double Length() const;
     void setLength(double Length);
@@ -81,7 +81,7 @@ void TegotaeDriver::SendData()
 
 void TegotaeDriver::Update()
 {
-    assert(simulation()->GetStepCount() == lastStepCount() + 1);
+    assert(simulation()->GetStepCount() == nextUpdateStepCount());
     setLastStepCount(simulation()->GetStepCount());
 
     if (m_omegaDriver) m_omega = m_omegaDriver->value();
@@ -116,7 +116,7 @@ void TegotaeDriver::Update()
     m_localErrorVector = m_tegotaeCentre->GetVector(m_worldErrorVector); // this should mean that the position depends on m_errorOutput but direction depends on m_tegotaeCentre
 
     // update m_phi depending on m_phi_dot values
-    double deltaT = simulation()->GetTimeIncrement();
+    double deltaT = controlTimeIncrement();
     m_phi = std::fmod(m_phi + m_phi_dot * deltaT, 2 * M_PI);
 }
 
@@ -124,20 +124,12 @@ void TegotaeDriver::UpdateReactionForce()
 {
     // N is the ground reaction force (GRF) acting on the leg
     m_N = 0;
-    pgd::Vector3 worldXAxis;
-    pgd::Vector3 worldReactionForce;
+    pgd::Vector3 worldXAxis = m_forceDirection->GetWorldAxis(Marker::Axis::X);
     for (auto geomIt : m_contactGeomList)
     {
-        std::vector<Contact *> *contactList = geomIt->GetContactList();
-        dJointFeedback *jointFeedback;
-        for (unsigned int i = 0; i < contactList->size(); i++)
-        {
-            jointFeedback = contactList->at(i)->GetJointFeedback();
-            // add the force that matches the X direction of the marker
-            worldXAxis = m_forceDirection->GetWorldAxis(Marker::Axis::X);
-            worldReactionForce.Set(jointFeedback->f1);
-            m_N += pgd::Dot(worldXAxis, worldReactionForce);
-        }
+        // add the force that matches the X direction of the marker
+        const ContactAggregate &contactAggregate = simulation()->GetGeomContactAggregate(geomIt);
+        if (contactAggregate.numContacts) m_N += pgd::Dot(worldXAxis, contactAggregate.force);
     }
     if (m_N < 0) m_N = 0;
 }
@@ -427,6 +419,25 @@ void TegotaeDriver::appendToAttributes()
     if (m_BDriver) setAttribute("BDriverID"s, m_BDriver->name());
 }
 
+void TegotaeDriver::appendStateValues(std::vector<double> *values)
+{
+    Driver::appendStateValues(values);
+    values->insert(values->end(), {m_omega, m_sigma, m_A, m_Aprime, m_B, m_phi});
+}
+
+const double *TegotaeDriver::stateValuesToAttributes(const double *values, std::map<std::string, std::string> *attributeMap) const
+{
+    values = Driver::stateValuesToAttributes(values, attributeMap);
+    std::string buf;
+    (*attributeMap)["Omega"s] = *GSUtil::ToString(values[0], &buf);
+    (*attributeMap)["Sigma"s] = *GSUtil::ToString(values[1], &buf);
+    (*attributeMap)["A"s] = *GSUtil::ToString(values[2], &buf);
+    (*attributeMap)["Aprime"s] = *GSUtil::ToString(values[3], &buf);
+    (*attributeMap)["B"s] = *GSUtil::ToString(values[4], &buf);
+    (*attributeMap)["Phi"s] = *GSUtil::ToString(values[5], &buf);
+    return values + 6;
+}
+
 pgd::Vector3 TegotaeDriver::worldErrorVector() const
 {
     return m_worldErrorVector;
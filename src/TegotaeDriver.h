@@ -45,6 +45,8 @@ public:
 
     virtual std::string *createFromAttributes();
     virtual void appendToAttributes();
+    virtual void appendStateValues(std::vector<double> *values);
+    virtual const double *stateValuesToAttributes(const double *values, std::map<std::string, std::string> *attributeMap) const;
 
     pgd::Vector3 worldErrorVector() const;
     pgd::Vector3 localErrorVector() const;
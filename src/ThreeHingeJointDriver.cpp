@@ -38,7 +38,7 @@ ThreeHingeJointDriver::ThreeHingeJointDriver()
 
 void ThreeHingeJointDriver::Update()
 {
-    assert(simulation()->GetStepCount() == lastStepCount() + 1);
+    assert(simulation()->GetStepCount() == nextUpdateStepCount());
     setLastStepCount(simulation()->GetStepCount());
 
     // set the desired distance
@@ -47,7 +47,10 @@ void ThreeHingeJointDriver::Update()
     m_desiredLength = (targetPositionWorld - proximalJointPositionWorld).Magnitude();
 
     // now find the zero of the CalculateLengthDifference to get the angle fraction that achieves this length
-    m_angleFraction = GSUtil::zeroin(0, 1, &CalculateLengthDifference, this, m_tolerance);
+    if (m_lengthTable.size())
+        m_angleFraction = GSUtil::InvertUnitIntervalTable(m_lengthTable, m_desiredLength, &CalculateLengthDifference, this, m_tolerance);
+    else
+        m_angleFraction = GSUtil::zeroin(0, 1, &CalculateLengthDifference, this, m_tolerance);
 
     // that sorts out the angles on the intermediate and distal joints - lets see where that takes us
 #ifndef NDEBUG
@@ -442,7 +445,6 @@ double ThreeHingeJointDriver::CalculateLengthDifference(double angleFraction, vo
     return lengthError;
 }
 
-
 Marker *ThreeHingeJointDriver::createLocalMarkerCopy(const Marker *marker)
 {
     auto it = m_localBodyList.find(marker->GetBody()->name());
@@ -597,6 +599,7 @@ std::string *ThreeHingeJointDriver::createFromAttributes()
     m_distalJointAngleGamma = GSUtil::Double(buf);
 
     if (findAttribute("Tolerance"s, &buf)) m_tolerance = GSUtil::Double(buf);
+    if (findAttribute("LengthTableSize"s, &buf)) m_lengthTableSize = size_t(std::max(0, GSUtil::Int(buf)));
 
     // check for consistency
     if (m_proximalJoint->body2Marker()->GetBody() != m_intermediateJoint->body1Marker()->GetBody())
@@ -667,6 +670,10 @@ std::string *ThreeHingeJointDriver::createFromAttributes()
 
     if (findAttribute("DumpExtensionCurve"s, &buf)) m_dumpExtensionCurve = GSUtil::Bool(buf);
 
+    // optionally tabulate the length against the angle fraction so that Update can use a binary search
+    // rather than a zeroin over the whole range (the monotonic test above means this table is monotonic)
+    GSUtil::TabulateUnitInterval(m_lengthTableSize, [this](double angleFraction) { CalculateLength(angleFraction); return m_actualLength; }, &m_lengthTable);
+
     // assemble the local copies of bodies, markers and joints
     std::unique_ptr<Body> baseBody = std::make_unique<Body>(nullptr);
     baseBody->setName(m_proximalJoint->body1Marker()->GetBody()->name());
@@ -801,6 +808,7 @@ void ThreeHingeJointDriver::appendToAttributes()
     setAttribute("IntermediateJointGamma"s, *GSUtil::ToString(m_intermediateJointAngleGamma, &buf));
     setAttribute("DistalJointGamma"s, *GSUtil::ToString(m_distalJointAngleGamma, &buf));
     setAttribute("Tolerance"s, *GSUtil::ToString(m_tolerance, &buf));
+    if (m_lengthTableSize) setAttribute("LengthTableSize"s, *GSUtil::ToString(m_lengthTableSize, &buf));
     setAttribute("DumpExtensionCurve"s, *GSUtil::ToString(m_dumpExtensionCurve, &buf));
 }
 
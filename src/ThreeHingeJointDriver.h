@@ -15,6 +15,7 @@
 
 #include <memory>
 #include <map>
+#include <vector>
 
 class Marker;
 class HingeJoint;
@@ -71,6 +72,8 @@ private:
     double m_intermediateJointAngleGamma = 1.0;
     double m_distalJointAngleGamma = 1.0;
     double m_tolerance  =1.0e-6;
+    size_t m_lengthTableSize = 0;
+    std::vector<double> m_lengthTable;
     bool m_dumpExtensionCurve = true;
 
     double m_proximalJointAngle1 = 0;
@@ -0,0 +1,171 @@
+/*
+ *  TrajectoryRecorder.cpp
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+#include "TrajectoryRecorder.h"
+#include "NamedObject.h"
+#include "Simulation.h"
+#include "Driver.h"
+#include "Geom.h"
+#include "Contact.h"
+
+#include <algorithm>
+
+using namespace std::string_literals;
+
+TrajectoryRecorder::TrajectoryRecorder()
+{
+}
+
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+}
+
+std::string *TrajectoryRecorder::AddObject(NamedObject *object, const std::vector<std::string> &channelNames)
+{
+    Source source;
+    std::vector<std::string> names;
+    if (Driver *driver = dynamic_cast<Driver *>(object))
+    {
+        names = {"Value"s};
+        source.getValues = [driver](std::vector<double> *values) { values->assign(1, driver->value()); };
+    }
+    else if (Geom *geom = dynamic_cast<Geom *>(object))
+    {
+        // the per step contact sums are maintained by the simulation so this is cheap
+        names = {"FX"s, "FY"s, "FZ"s, "TX"s, "TY"s, "TZ"s, "CPX"s, "CPY"s, "CPZ"s, "NContacts"s};
+        source.getValues = [geom](std::vector<double> *values)
+        {
+            const ContactAggregate &aggregate = geom->simulation()->GetGeomContactAggregate(geom);
+            *values = {aggregate.force.x, aggregate.force.y, aggregate.force.z,
+                       aggregate.torque.x, aggregate.torque.y, aggregate.torque.z,
+                       aggregate.centreOfPressure.x, aggregate.centreOfPressure.y, aggregate.centreOfPressure.z,
+                       double(aggregate.numContacts)};
+        };
+    }
+    else
+    {
+        names = object->dumpNames();
+        source.getValues = [object](std::vector<double> *values) { object->dumpValues(values); };
+    }
+    if (names.empty())
+    {
+        m_lastError = "TrajectoryRecorder: ID=\""s + object->name() + "\" does not support numeric output"s;
+        return &m_lastError;
+    }
+
+    for (auto &&channelName : channelNames)
+    {
+        auto it = std::find(names.begin(), names.end(), channelName);
+        if (it == names.end())
+        {
+            m_lastError = "TrajectoryRecorder: channel \""s + channelName + "\" not found in ID=\""s + object->name() + "\""s;
+            return &m_lastError;
+        }
+        source.valueIndexList.push_back(size_t(std::distance(names.begin(), it)));
+    }
+    if (channelNames.empty())
+    {
+        // the time is already recorded once for all the channels
+        for (size_t i = 0; i < names.size(); i++)
+            if (names[i] != "Time"s) source.valueIndexList.push_back(i);
+    }
+
+    source.firstColumn = m_columns.size();
+    for (auto &&index : source.valueIndexList)
+    {
+        m_channelNames.push_back(object->name() + "."s + names[index]);
+        m_columns.emplace_back();
+        m_columns.back().reserve(std::max(m_reserve, m_time.capacity()));
+        // channels added part way through a run are padded so the columns stay aligned
+        m_columns.back().resize(m_time.size(), 0);
+    }
+    m_sourceList.push_back(std::move(source));
+    return nullptr;
+}
+
+void TrajectoryRecorder::Clear()
+{
+    m_sourceList.clear();
+    m_channelNames.clear();
+    m_columns.clear();
+    m_time.clear();
+}
+
+int TrajectoryRecorder::interval() const
+{
+    return m_interval;
+}
+
+void TrajectoryRecorder::SetInterval(int interval)
+{
+    m_interval = std::max(1, interval);
+}
+
+void TrajectoryRecorder::Reserve(size_t numRecords)
+{
+    m_reserve = numRecords;
+    m_time.reserve(numRecords);
+    for (auto &&column : m_columns) column.reserve(numRecords);
+}
+
+void TrajectoryRecorder::Record(uint64_t stepCount, double time)
+{
+    // nothing is recorded until there is something to record
+    if (m_sourceList.empty() || stepCount % uint64_t(m_interval)) return;
+    m_time.push_back(time);
+    for (auto &&source : m_sourceList)
+    {
+        source.getValues(&m_values);
+        size_t column = source.firstColumn;
+        for (auto &&index : source.valueIndexList) m_columns[column++].push_back(index < m_values.size() ? m_values[index] : 0);
+    }
+}
+
+void TrajectoryRecorder::ClearRecords()
+{
+    m_time.clear();
+    for (auto &&column : m_columns) column.clear();
+}
+
+size_t TrajectoryRecorder::GetNumRecords() const
+{
+    return m_time.size();
+}
+
+size_t TrajectoryRecorder::GetNumChannels() const
+{
+    return m_channelNames.size();
+}
+
+const std::vector<std::string> &TrajectoryRecorder::GetChannelNames() const
+{
+    return m_channelNames;
+}
+
+size_t TrajectoryRecorder::FindChannel(const std::string &channelName) const
+{
+    auto it = std::find(m_channelNames.begin(), m_channelNames.end(), channelName);
+    if (it == m_channelNames.end()) return SIZE_MAX;
+    return size_t(std::distance(m_channelNames.begin(), it));
+}
+
+const std::vector<double> &TrajectoryRecorder::GetTime() const
+{
+    return m_time;
+}
+
+const std::vector<double> &TrajectoryRecorder::GetChannel(size_t channelIndex) const
+{
+    return m_columns.at(channelIndex);
+}
+
+std::string TrajectoryRecorder::lastError() const
+{
+    return m_lastError;
+}
@@ -0,0 +1,78 @@
+/*
+ *  TrajectoryRecorder.h
+ *  GaitSym2019
+ *
+ *  Created by Bill Sellers on 19/10/2026.
+ *  Copyright 2026 Bill Sellers. All rights reserved.
+ *
+ */
+
+// TrajectoryRecorder keeps selected channels in memory while the simulation runs so that
+// they can be read directly (e.g. by the GUI or the python library) without dump files.
+// Each channel is a contiguous column of values with one entry per recorded step and
+// there is a shared time column. Channels are named "ObjectID.Channel".
+//
+// Any object with numeric dump output (bodies, muscles, joints, markers) can be added using
+// its dumpNames channels. Drivers provide "Value" and geoms provide the summed contact
+// values "FX", "FY", "FZ", "TX", "TY", "TZ", "CPX", "CPY", "CPZ" and "NContacts".
+
+#ifndef TRAJECTORYRECORDER_H
+#define TRAJECTORYRECORDER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+class NamedObject;
+
+class TrajectoryRecorder
+{
+public:
+    TrajectoryRecorder();
+    virtual ~TrajectoryRecorder();
+
+    // an empty channel list means all the channels apart from Time
+    std::string *AddObject(NamedObject *object, const std::vector<std::string> &channelNames = {});
+    // removes all the channels and records
+    void Clear();
+
+    // only record every interval steps
+    int interval() const;
+    void SetInterval(int interval);
+    // preallocate the columns so that recording does not need to allocate memory
+    void Reserve(size_t numRecords);
+
+    // called by Simulation after each step
+    void Record(uint64_t stepCount, double time);
+    void ClearRecords();
+
+    size_t GetNumRecords() const;
+    size_t GetNumChannels() const;
+    const std::vector<std::string> &GetChannelNames() const;
+    // returns SIZE_MAX if the channel is not found
+    size_t FindChannel(const std::string &channelName) const;
+    const std::vector<double> &GetTime() const;
+    const std::vector<double> &GetChannel(size_t channelIndex) const;
+
+    std::string lastError() const;
+
+private:
+    struct Source
+    {
+        std::function<void(std::vector<double> *values)> getValues;
+        std::vector<size_t> valueIndexList; // which of the values are recorded
+        size_t firstColumn;
+    };
+
+    std::vector<Source> m_sourceList;
+    std::vector<std::string> m_channelNames;
+    std::vector<std::vector<double>> m_columns;
+    std::vector<double> m_time;
+    std::vector<double> m_values;
+    int m_interval = 1;
+    size_t m_reserve = 0;
+    std::string m_lastError;
+};
+
+#endif // TRAJECTORYRECORDER_H
@@ -38,7 +38,7 @@ TwoHingeJointDriver::TwoHingeJointDriver()
 
 void TwoHingeJointDriver::Update()
 {
-    assert(simulation()->GetStepCount() == lastStepCount() + 1);
+    assert(simulation()->GetStepCount() == nextUpdateStepCount());
     setLastStepCount(simulation()->GetStepCount());
 
     // set the desired distance
@@ -47,7 +47,10 @@ void TwoHingeJointDriver::Update()
     m_desiredLength = (targetPositionWorld - proximalJointPositionWorld).Magnitude();
 
     // now find the zero of the CalculateLengthDifference to get the angle fraction that achieves this length
-    m_angleFraction = GSUtil::zeroin(0, 1, &CalculateLengthDifference, this, m_tolerance);
+    if (m_lengthTable.size())
+        m_angleFraction = GSUtil::InvertUnitIntervalTable(m_lengthTable, m_desiredLength, &CalculateLengthDifference, this, m_tolerance);
+    else
+        m_angleFraction = GSUtil::zeroin(0, 1, &CalculateLengthDifference, this, m_tolerance);
 
     // that sorts out the angles on the distal joints- lets see where that takes us
 #ifndef NDEBUG
@@ -435,7 +438,6 @@ double TwoHingeJointDriver::CalculateLengthDifference(double angleFraction, void
     return lengthError;
 }
 
-
 Marker *TwoHingeJointDriver::createLocalMarkerCopy(const Marker *marker)
 {
     auto it = m_localBodyList.find(marker->GetBody()->name());
@@ -574,6 +576,7 @@ std::string *TwoHingeJointDriver::createFromAttributes()
     GSUtil::Double(buf, 2, m_distalJointRange.data());
 
     if (findAttribute("Tolerance"s, &buf)) m_tolerance = GSUtil::Double(buf);
+    if (findAttribute("LengthTableSize"s, &buf)) m_lengthTableSize = size_t(std::max(0, GSUtil::Int(buf)));
 
     // check for consistency
     if (m_proximalJoint->body2Marker()->GetBody() != m_distalJoint->body1Marker()->GetBody())
@@ -615,6 +618,10 @@ std::string *TwoHingeJointDriver::createFromAttributes()
         return lastErrorPtr();
     }
 
+    // optionally tabulate the length against the angle fraction so that Update can use a binary search
+    // rather than a zeroin over the whole range (the monotonic test above means this table is monotonic)
+    GSUtil::TabulateUnitInterval(m_lengthTableSize, [this](double angleFraction) { CalculateLength(angleFraction); return m_actualLength; }, &m_lengthTable);
+
     // assemble the local copies of bodies, markers and joints
     std::unique_ptr<Body> baseBody = std::make_unique<Body>(nullptr);
     baseBody->setName(m_proximalJoint->body1Marker()->GetBody()->name());
@@ -739,6 +746,7 @@ void TwoHingeJointDriver::appendToAttributes()
     setAttribute("ProximalJointRange"s, *GSUtil::ToString(m_proximalJointRange, &buf));
     setAttribute("DistalJointRange"s, *GSUtil::ToString(m_distalJointRange, &buf));
     setAttribute("Tolerance"s, *GSUtil::ToString(m_tolerance, &buf));
+    if (m_lengthTableSize) setAttribute("LengthTableSize"s, *GSUtil::ToString(m_lengthTableSize, &buf));
 }
 
 
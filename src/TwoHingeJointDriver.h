@@ -15,6 +15,7 @@
 
 #include <memory>
 #include <map>
+#include <vector>
 
 class Marker;
 class HingeJoint;
@@ -64,6 +65,8 @@ private:
     pgd::Vector2 m_proximalJointRange;
     pgd::Vector2 m_distalJointRange;
     double m_tolerance  =1.0e-6;
+    size_t m_lengthTableSize = 0;
+    std::vector<double> m_lengthTable;
     bool m_dumpExtensionCurve = false;
 
     double m_proximalJointAngle1 = 0;
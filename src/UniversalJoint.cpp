@@ -273,28 +273,28 @@ void UniversalJoint::appendToAttributes()
 
 std::string UniversalJoint::dumpToString()
 {
-    std::stringstream ss;
-    ss.precision(17);
-    ss.setf(std::ios::scientific);
-    if (firstDump())
-    {
-        setFirstDump(false);
-        ss << "Time\tXP\tYP\tZP\tXA1\tYA1\tZA1\tAngle1\tAngleRate1\tXA2\tYA2\tZA2\tAngle2\tAngleRate2\tFX1\tFY1\tFZ1\tTX1\tTY1\tTZ1\tFX2\tFY2\tFZ2\tTX2\tTY2\tTZ2\n";
-    }
+    return dumpValuesToString();
+}
+
+std::vector<std::string> UniversalJoint::dumpNames() const
+{
+    return {"Time"s, "XP"s, "YP"s, "ZP"s, "XA1"s, "YA1"s, "ZA1"s, "Angle1"s, "AngleRate1"s, "XA2"s, "YA2"s, "ZA2"s, "Angle2"s, "AngleRate2"s, "FX1"s, "FY1"s, "FZ1"s, "TX1"s, "TY1"s, "TZ1"s, "FX2"s, "FY2"s, "FZ2"s, "TX2"s, "TY2"s, "TZ2"s};
+}
+
+void UniversalJoint::dumpValues(std::vector<double> *values)
+{
     dVector3 p, a1, a2;
     GetUniversalAnchor(p);
     GetUniversalAxis1(a1);
     GetUniversalAxis2(a2);
 
-    ss << simulation()->GetTime() << "\t" << p[0] << "\t" << p[1] << "\t" << p[2] << "\t" <<
-          a1[0] << "\t" << a1[1] << "\t" << a1[2] << "\t" << GetUniversalAngle1() << "\t" << GetUniversalAngle1Rate() << "\t" <<
-          a2[0] << "\t" << a2[1] << "\t" << a2[2] << "\t" << GetUniversalAngle2() << "\t" << GetUniversalAngle2Rate() << "\t" <<
-          JointFeedback()->f1[0] << "\t" << JointFeedback()->f1[1] << "\t" << JointFeedback()->f1[2] << "\t" <<
-          JointFeedback()->t1[0] << "\t" << JointFeedback()->t1[1] << "\t" << JointFeedback()->t1[2] << "\t" <<
-          JointFeedback()->f2[0] << "\t" << JointFeedback()->f2[1] << "\t" << JointFeedback()->f2[2] << "\t" <<
-          JointFeedback()->t2[0] << "\t" << JointFeedback()->t2[1] << "\t" << JointFeedback()->t2[2] <<
-          "\n";
-    return ss.str();
+    *values = {simulation()->GetTime(), p[0], p[1], p[2],
+               a1[0], a1[1], a1[2], GetUniversalAngle1(), GetUniversalAngle1Rate(),
+               a2[0], a2[1], a2[2], GetUniversalAngle2(), GetUniversalAngle2Rate(),
+               JointFeedback()->f1[0], JointFeedback()->f1[1], JointFeedback()->f1[2],
+               JointFeedback()->t1[0], JointFeedback()->t1[1], JointFeedback()->t1[2],
+               JointFeedback()->f2[0], JointFeedback()->f2[1], JointFeedback()->f2[2],
+               JointFeedback()->t2[0], JointFeedback()->t2[1], JointFeedback()->t2[2]};
 }
 
 
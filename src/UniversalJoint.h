@@ -50,6 +50,8 @@ public:
     double GetUniversalAngle2Rate();
 
     virtual std::string dumpToString();
+    virtual std::vector<std::string> dumpNames() const;
+    virtual void dumpValues(std::vector<double> *values);
 
     virtual std::string *createFromAttributes();
     virtual void appendToAttributes();
@@ -24,6 +24,8 @@
 #include <string>
 #include <algorithm>
 #include <sstream>
+#include <cstring>
+#include <limits>
 
 using namespace std::string_literals;
 
@@ -69,12 +71,15 @@ int WarehouseUnit::ImportWarehouseUnit(const char *filename, bool appendFlag)
     DataFile file;
     if (file.ReadFile(filename)) return __LINE__;
     char *fileData = file.GetRawData();
-    int fileDataLen = file.GetSize();
+    if (IsBinaryWarehouse(fileData, file.GetSize())) return ImportBinaryWarehouseUnit(fileData, file.GetSize(), appendFlag);
+    int fileDataLen = int(file.GetSize());
     return ImportWarehouseUnit(fileData, fileDataLen, appendFlag);
 }
 
 int WarehouseUnit::ImportWarehouseUnit(char *fileData, int fileDataLen, bool appendFlag)
 {
+    if (IsBinaryWarehouse(fileData, size_t(fileDataLen))) return ImportBinaryWarehouseUnit(fileData, size_t(fileDataLen), appendFlag);
+
     char **ptrs = new char *[fileDataLen / 2]; // this must be big enough and these files aren't so large that I need to worry about space
     int numTokens = DataFile::ReturnTokens(fileData, ptrs, fileDataLen / 2); // this should make the whole thing reasonably tolerant
 
@@ -149,6 +154,104 @@ int WarehouseUnit::ImportWarehouseUnit(char *fileData, int fileDataLen, bool app
     return 0;
 }
 
+// binary warehouse files start with a uint32 zero whereas text files start with the number of drivers
+bool WarehouseUnit::IsBinaryWarehouse(const char *fileData, size_t fileDataLen)
+{
+    uint32_t marker;
+    if (fileDataLen < sizeof(marker)) return false;
+    std::memcpy(&marker, fileData, sizeof(marker));
+    return marker == 0;
+}
+
+// this reads the binary format written by Simulation::OutputWarehouse
+// which is in native byte order (unlike DumpFile which is always little-endian)
+// the records are fixed length so they can be copied straight into the arrays without any parsing
+int WarehouseUnit::ImportBinaryWarehouseUnit(const char *fileData, size_t fileDataLen, bool appendFlag)
+{
+    size_t position = sizeof(uint32_t);
+    auto readUInt32 = [&](uint32_t *value)
+    {
+        if (position + sizeof(uint32_t) > fileDataLen) return false;
+        std::memcpy(value, fileData + position, sizeof(uint32_t));
+        position += sizeof(uint32_t);
+        return true;
+    };
+    auto readString = [&](std::string *value)
+    {
+        uint32_t length;
+        if (!readUInt32(&length) || position + length > fileDataLen) return false;
+        value->assign(fileData + position, length);
+        position += length;
+        return true;
+    };
+
+    // the counts come from the file so check them against the remaining bytes before allocating anything
+    // (each name needs at least its uint32 length)
+    uint32_t numDrivers, numBodies, numValuesPerBody;
+    if (!readUInt32(&numDrivers)) return __LINE__;
+    if (numDrivers > (fileDataLen - position) / sizeof(uint32_t)) return __LINE__;
+    std::vector<std::string> driverNames(numDrivers);
+    for (auto &&it : driverNames) if (!readString(&it)) return __LINE__;
+    if (!readUInt32(&numBodies)) return __LINE__;
+    if (numBodies > (fileDataLen - position) / sizeof(uint32_t)) return __LINE__;
+    std::vector<std::string> bodyNames(numBodies);
+    for (auto &&it : bodyNames) if (!readString(&it)) return __LINE__;
+    if (!readUInt32(&numValuesPerBody)) return __LINE__;
+    if (numValuesPerBody != 13) return __LINE__; // SetBodyQueryData only knows about this layout
+    size_t nDimSize = size_t(numBodies) * size_t(numValuesPerBody);
+    if (nDimSize > size_t(std::numeric_limits<int>::max())) return __LINE__;
+    int nDim = int(nDimSize);
+    size_t lineLength = 1 + numDrivers + size_t(nDim);
+    size_t dataLen = fileDataLen - position;
+    if (dataLen % (lineLength * sizeof(double))) return __LINE__;
+    if (dataLen / (lineLength * sizeof(double)) > size_t(std::numeric_limits<int>::max())) return __LINE__;
+    int nPts = int(dataLen / (lineLength * sizeof(double)));
+
+    int old_nPts = 0;
+    if (appendFlag == false)
+    {
+        m_numDrivers = int(numDrivers);
+        m_numBodies = int(numBodies);
+        m_numValuesPerBody = int(numValuesPerBody);
+        m_nDim = nDim;
+        m_driverNames = std::move(driverNames);
+        m_bodyNames = std::move(bodyNames);
+        if (m_activations) delete [] m_activations;
+        m_activations = new double[size_t(nPts) * numDrivers];
+        if (m_bodyData) delete [] m_bodyData;
+        m_bodyData = new double[size_t(nPts) * size_t(nDim)];
+        if (m_weights) delete [] m_weights;
+        m_weights = new double[m_nDim];
+        std::fill_n(m_weights, m_nDim, 1.0);
+        m_nPts = nPts;
+    }
+    else
+    {
+        if (int(numDrivers) != m_numDrivers || nDim != m_nDim) return __LINE__;
+        old_nPts = m_nPts;
+        m_nPts += nPts;
+        double *old_activations = m_activations;
+        double *old_bodyData = m_bodyData;
+        m_activations = new double[size_t(m_nPts) * numDrivers];
+        m_bodyData = new double[size_t(m_nPts) * size_t(nDim)];
+        if (old_activations) std::copy_n(old_activations, size_t(old_nPts) * numDrivers, m_activations);
+        if (old_bodyData) std::copy_n(old_bodyData, size_t(old_nPts) * size_t(nDim), m_bodyData);
+        if (old_activations) delete [] old_activations;
+        if (old_bodyData) delete [] old_bodyData;
+    }
+
+    // each record is time, activations, body data
+    const char *record = fileData + position;
+    for (int i = old_nPts; i < m_nPts; i++, record += lineLength * sizeof(double))
+    {
+        std::memcpy(m_activations + size_t(i) * numDrivers, record + sizeof(double), numDrivers * sizeof(double));
+        std::memcpy(m_bodyData + size_t(i) * size_t(nDim), record + (1 + numDrivers) * sizeof(double), size_t(nDim) * sizeof(double));
+    }
+
+    InitaliseWarehouse();
+    return 0;
+}
+
 void WarehouseUnit::SetDriverIDs(const char *nameList)
 {
     int len = strlen(nameList);
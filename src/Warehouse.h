@@ -63,6 +63,9 @@ public:
     void SetBodyQueryData(double *bodyQueryData);
 
 private:
+    static bool IsBinaryWarehouse(const char *fileData, size_t fileDataLen);
+    int ImportBinaryWarehouseUnit(const char *fileData, size_t fileDataLen, bool appendFlag);
+
     int                 m_nPts;                         // actual number of data points
     int                 m_nDim;                         // dimensionality of search space
     int                 m_nNN;                          // number of nearest neighbours to return